@@ -23,8 +23,55 @@ std::unique_ptr<Message> SyncMessageHandler::ProcessMessage(const Message &messa
            static_cast<unsigned long>(syncMsg->startTime));
 
     // 1. 进行时间校准，计算与主机时间的偏移量
-    uint64_t localTimestamp = HptimerGetUs();
-    int64_t timeOffset = static_cast<int64_t>(syncMsg->currentTime) - static_cast<int64_t>(localTimestamp);
+    SyncTime(syncMsg->currentTime, device);
+
+    // 完整配置不携带版本，之后的紧凑同步需要重新获得本从机条目
+    device->m_hasSyncEpoch = false;
+
+    // 2. 查找本从机的配置，并按列表顺序累加testCount得到起始时隙和总时隙数
+    SyncSchedule schedule = {};
+    schedule.collectionMode = syncMsg->collectionMode();
+    schedule.parityCount = syncMsg->parityCount();
+    schedule.interval = syncMsg->interval;
+    schedule.startTime = syncMsg->startTime;
+
+    bool configFound = false;
+    uint16_t slotOffset = 0;
+    for (const auto &config : syncMsg->slaveConfigs)
+    {
+        if (!configFound && config.slaveId == device->m_deviceId)
+        {
+            schedule.timeSlot = config.timeSlot;
+            schedule.testCount = config.testCount;
+            schedule.reset = (config.reset == 1);
+            schedule.startSlot = slotOffset;
+            configFound = true;
+
+            elog_v("SyncMessageHandler", "Found config for device 0x%08X - TimeSlot: %d, TestCount: %d, Reset: %d",
+                   device->m_deviceId, config.timeSlot, config.testCount, config.reset);
+        }
+        slotOffset += config.testCount;
+    }
+    schedule.totalSlots = slotOffset;
+
+    if (!configFound)
+    {
+        elog_w("SyncMessageHandler", "No configuration found for device 0x%08X", device->m_deviceId);
+        device->m_isConfigured = false;
+        return nullptr;
+    }
+
+    ApplySchedule(schedule, device);
+    return nullptr; // SyncMessage 不需要响应
+}
+
+void SyncMessageHandler::SyncTime(uint64_t masterTime, SlaveDevice *device)
+{
+    // 使用驱动接收时间，不计入接收任务和解析的排队延迟；
+    // 收到时主机时间已经过了单向时延（由Ping测得，未测量时为0）
+    uint64_t localTimestamp = device->m_rxTimestampUs;
+    int64_t timeOffset = static_cast<int64_t>(masterTime + device->GetOneWayDelayUs()) -
+                         static_cast<int64_t>(localTimestamp);
 
     // 使用线程安全的方法设置时间偏移量
     device->SetTimeOffset(timeOffset);
@@ -34,16 +81,19 @@ std::unique_ptr<Message> SyncMessageHandler::ProcessMessage(const Message &messa
     device->m_inTdmaMode = true;
 
     elog_v("SyncMessageHandler", "Time sync - Local: %lu us, Master: %lu us, Offset: %ld us",
-           static_cast<unsigned long>(localTimestamp), static_cast<unsigned long>(syncMsg->currentTime),
+           static_cast<unsigned long>(localTimestamp), static_cast<unsigned long>(masterTime),
            static_cast<long>(timeOffset));
+}
 
-    // 2. 保存旧配置用于比较，并记录是否是首次配置
+bool SyncMessageHandler::ApplySchedule(const SyncSchedule &schedule, SlaveDevice *device)
+{
+    // 3. 保存旧配置用于比较，并记录是否是首次配置
     SlaveDeviceConfig oldConfig = device->currentConfig;
     bool wasConfigured = device->m_isConfigured;
 
-    // 3. 根据模式设置采集配置（临时设置，用于后续比较）
+    // 4. 根据模式设置采集配置（临时设置，用于后续比较）
     CollectionMode newMode;
-    switch (syncMsg->mode)
+    switch (schedule.collectionMode)
     {
     case 0: // 导通检测
         newMode = CollectionMode::CONDUCTION;
@@ -55,60 +105,24 @@ std::unique_ptr<Message> SyncMessageHandler::ProcessMessage(const Message &messa
         newMode = CollectionMode::CLIP;
         break;
     default:
-        elog_w("SyncMessageHandler", "Unknown collection mode: %d", syncMsg->mode);
-        return nullptr;
+        elog_w("SyncMessageHandler", "Unknown collection mode: %d", schedule.collectionMode);
+        return false;
     }
 
-    // 4. 查找本从机的配置
-    bool configFound = false;
-    bool resetRequested = false;
-    uint8_t newTimeSlot = 0;
-    uint8_t newTestCount = 0;
+    uint8_t newTimeSlot = schedule.timeSlot;
+    uint8_t newTestCount = schedule.testCount;
+    bool resetRequested = schedule.reset;
 
-    for (const auto &config : syncMsg->slaveConfigs)
-    {
-        if (config.slaveId == device->m_deviceId)
-        {
-            newTimeSlot = config.timeSlot;
-            newTestCount = config.testCount;
-            configFound = true;
-            resetRequested = (config.reset == 1);
-
-            elog_v("SyncMessageHandler", "Found config for device 0x%08X - TimeSlot: %d, TestCount: %d, Reset: %d",
-                   device->m_deviceId, config.timeSlot, config.testCount, config.reset);
+    // 添加详细的引脚数配置信息
+    elog_d("SyncMessageHandler", "=== Pin Configuration Debug Info ===");
+    elog_d("SyncMessageHandler", "Device ID: 0x%08X", device->m_deviceId);
+    elog_d("SyncMessageHandler", "TestCount (This Device): %d", newTestCount);
+    elog_d("SyncMessageHandler", "Total Pin Count (All Devices): %d", schedule.totalSlots);
+    elog_d("SyncMessageHandler", "This device will have %d active slots for data transmission", newTestCount);
+    elog_d("SyncMessageHandler", "====================================");
 
-            // 计算所有从机的总引脚数
-            uint16_t totalPinCount = 0;
-            for (const auto &cfg : syncMsg->slaveConfigs)
-            {
-                totalPinCount += cfg.testCount;
-            }
-
-            // 添加详细的引脚数配置信息
-            elog_d("SyncMessageHandler", "=== Pin Configuration Debug Info ===");
-            elog_d("SyncMessageHandler", "Device ID: 0x%08X", device->m_deviceId);
-            elog_d("SyncMessageHandler", "TestCount (This Device): %d", config.testCount);
-            elog_d("SyncMessageHandler", "Total Pin Count (All Devices): %d", totalPinCount);
-            elog_d("SyncMessageHandler", "This device will have %d active slots for data transmission",
-                   config.testCount);
-            elog_d("SyncMessageHandler", "====================================");
-            break;
-        }
-    }
-
-    if (!configFound)
-    {
-        elog_w("SyncMessageHandler", "No configuration found for device 0x%08X", device->m_deviceId);
-        device->m_isConfigured = false;
-        return nullptr;
-    }
-
-    // 5. 计算新的totalCycles（所有从机的testCount之和）
-    uint16_t newTotalCycles = 0;
-    for (const auto &cfg : syncMsg->slaveConfigs)
-    {
-        newTotalCycles += cfg.testCount;
-    }
+    // 5. 新的totalCycles（所有从机的testCount之和）
+    uint16_t newTotalCycles = schedule.totalSlots;
 
     // 计算旧的totalCycles（如果已配置）
     uint16_t oldTotalCycles = 0;
@@ -119,14 +133,15 @@ std::unique_ptr<Message> SyncMessageHandler::ProcessMessage(const Message &messa
 
     // 6. 比较配置是否改变（比较所有配置项，包括totalCycles）
     bool configChanged = false;
-    if (oldConfig.mode != newMode || oldConfig.interval != syncMsg->interval || oldConfig.timeSlot != newTimeSlot ||
-        oldConfig.testCount != newTestCount || oldTotalCycles != newTotalCycles)
+    if (oldConfig.mode != newMode || oldConfig.interval != schedule.interval || oldConfig.timeSlot != newTimeSlot ||
+        oldConfig.testCount != newTestCount || oldTotalCycles != newTotalCycles ||
+        device->m_startSlot != schedule.startSlot)
     {
         configChanged = true;
         elog_d("SyncMessageHandler",
                "Configuration changed - Mode: %d->%d, Interval: %d->%d, TimeSlot: %d->%d, TestCount: %d->%d, "
                "TotalCycles: %d->%d",
-               static_cast<int>(oldConfig.mode), static_cast<int>(newMode), oldConfig.interval, syncMsg->interval,
+               static_cast<int>(oldConfig.mode), static_cast<int>(newMode), oldConfig.interval, schedule.interval,
                oldConfig.timeSlot, newTimeSlot, oldConfig.testCount, newTestCount, oldTotalCycles, newTotalCycles);
     }
 
@@ -135,23 +150,41 @@ std::unique_ptr<Message> SyncMessageHandler::ProcessMessage(const Message &messa
     {
         elog_d("SyncMessageHandler", "Config changed, clearing cached data and fragment state");
 
+        // 先停止时隙管理器并等待正在执行的时隙回调返回，
+        // 避免回调在清除过程中继续按旧游标追加行或入队分片
+        device->StopSlotManager();
+
         // 清除分片发送状态（重新计算分包数量和发送分包所需要的时隙）
+        // 先移除发送队列中引用旧游标的分片
+        device->ClearQueuedFragments();
         device->m_isFragmentSendingInProgress = false;
-        device->m_pendingFragments.clear();
+        device->m_fragmentCursor = ConductionFragmentCursor();
+        device->m_sendingData.clear();
         device->m_currentFragmentIndex = 0;
+        device->m_queuedFragments = 0;
+        device->m_streamLive = false;
+        device->m_streamedBytes = 0;
 
         // 清除缓存的采集数据
         device->lastCollectionData.clear();
         device->m_hasDataToSend = false;
 
+        // 保留的分片按旧配置打包，不再响应重传请求
+        device->ClearRetainedFragments();
+
+        // 数据长度变化，下一周期的编码不再以旧数据为参考
+        device->m_previousRawData.clear();
+
         elog_d("SyncMessageHandler", "Cached data cleared, next transmission will use new data size");
     }
 
     // 8. 更新配置（无论是否改变都更新）
     device->currentConfig.mode = newMode;
-    device->currentConfig.interval = syncMsg->interval;
+    device->currentConfig.interval = schedule.interval;
     device->currentConfig.timeSlot = newTimeSlot;
     device->currentConfig.testCount = newTestCount;
+    device->currentConfig.parityCount = schedule.parityCount;
+    device->m_startSlot = schedule.startSlot;
     device->m_isConfigured = true;
 
     // 9. 处理复位请求
@@ -166,15 +199,14 @@ std::unique_ptr<Message> SyncMessageHandler::ProcessMessage(const Message &messa
         auto resetResponse = std::make_unique<Slave2Master::RstResponseMessage>();
         resetResponse->status = 0; // 0：复位成功
 
-        // 存储待回复的响应并设置标志位
-        device->m_pendingResetResponse = std::move(resetResponse);
-        device->m_hasPendingResetResponse = true;
+        // 复位响应在本设备的激活时隙优先发送
+        device->QueueMessage(TxPriority::CONTROL, std::move(resetResponse));
 
         elog_v("SyncMessageHandler", "Reset completed, response queued for next active slot");
     }
 
     // 9. 设置延迟启动时间
-    device->m_scheduledStartTime = syncMsg->startTime;
+    device->m_scheduledStartTime = schedule.startTime;
     device->m_isScheduledToStart = true;
 
     // 10. 配置采集器和时隙管理器（仅在配置改变或首次配置时重新配置）
@@ -190,7 +222,7 @@ std::unique_ptr<Message> SyncMessageHandler::ProcessMessage(const Message &messa
             {
                 elog_e("SyncMessageHandler", "Failed to configure continuity collector");
                 device->m_deviceState = SlaveDeviceState::DEV_ERR;
-                return nullptr;
+                return false;
             }
 
             // 计算预期的数据量
@@ -208,26 +240,19 @@ std::unique_ptr<Message> SyncMessageHandler::ProcessMessage(const Message &messa
                        device->currentConfig.testCount, newTotalCycles);
             }
 
+            const size_t mtu = device->m_encoder.getMTU();
             elog_d("SyncMessageHandler", "Expected data: %d bytes (%d bits), ~%d frags", expectedDataBytes,
-                   expectedDataBits, (expectedDataBytes + 799) / 800);
+                   expectedDataBits, (expectedDataBytes + mtu - 1) / mtu);
         }
 
         // 10.2 配置时隙管理器（先停止再配置）
         if (device->m_slotManager)
         {
-            // 先停止当前运行的时隙管理器
-            device->m_slotManager->Stop();
+            // 先停止当前运行的时隙管理器（配置改变时已在清除发送状态前停止）
+            device->StopSlotManager();
 
-            // calculate startSlot
-            uint16_t startSlot = 0;
-            for (const auto &config : syncMsg->slaveConfigs)
-            {
-                if (config.slaveId == device->m_deviceId)
-                {
-                    break;
-                }
-                startSlot += config.testCount;
-            }
+            // 起始时隙由同步消息给出（完整同步时按列表顺序累加）
+            uint16_t startSlot = schedule.startSlot;
 
             uint8_t deviceSlotCount = device->currentConfig.testCount; // 每个设备占用一个时隙
             uint16_t totalSlotCount = newTotalCycles;                  // 总时隙数等于从机数量
@@ -238,7 +263,7 @@ std::unique_ptr<Message> SyncMessageHandler::ProcessMessage(const Message &messa
             {
                 elog_e("SyncMessageHandler", "Failed to configure slot manager");
                 device->m_deviceState = SlaveDeviceState::DEV_ERR;
-                return nullptr;
+                return false;
             }
             if (configChanged)
             {
@@ -266,12 +291,12 @@ std::unique_ptr<Message> SyncMessageHandler::ProcessMessage(const Message &messa
 
     // 8. 检查是否立即启动或延迟启动
     uint64_t currentSyncTime = device->GetSyncTimestampUs();
-    if (currentSyncTime >= syncMsg->startTime)
+    if (currentSyncTime >= schedule.startTime)
     {
         // 立即启动数据采集
         elog_v("SyncMessageHandler", "Starting collection immediately (start time already reached)");
         if (device->m_continuityCollector && device->m_slotManager &&
-            device->m_continuityCollector->StartCollection() && device->m_slotManager->Start())
+            device->m_continuityCollector->StartCollection() && device->StartSlotManager())
         {
             device->m_isCollecting = true;
             uwb_ltlp_set_conducting_state(true); // 更新全局导通检测状态标志
@@ -289,12 +314,80 @@ std::unique_ptr<Message> SyncMessageHandler::ProcessMessage(const Message &messa
     {
         // 延迟启动
         device->m_deviceState = SlaveDeviceState::READY;
-        // uint64_t delayUs = syncMsg->startTime - currentSyncTime;
+        // uint64_t delayUs = schedule.startTime - currentSyncTime;
         elog_v("SyncMessageHandler", "Collection scheduled to start in %lu ms",
-               static_cast<unsigned long>(syncMsg->startTime) / 1000);
+               static_cast<unsigned long>(schedule.startTime) / 1000);
     }
 
-    return nullptr; // SyncMessage 不需要响应
+    return true;
+}
+
+// Compact Sync Message Handler
+std::unique_ptr<Message> CompactSyncMessageHandler::ProcessMessage(const Message &message, SlaveDevice *device)
+{
+    auto syncMsg = dynamic_cast<const Master2Slave::CompactSyncMessage *>(&message);
+    if (!syncMsg)
+        return nullptr;
+
+    elog_v("SyncMessageHandler", "Processing compact sync - Epoch: %d (base %d), Entries: %d from short ID %d",
+           syncMsg->epoch, syncMsg->baseEpoch, syncMsg->entryCount(), syncMsg->firstShortId);
+
+    // 紧凑同步按短ID定位条目，未分配短ID时等待完整同步
+    if (device->m_shortId == 0)
+    {
+        elog_w("SyncMessageHandler", "No short ID assigned, ignoring compact sync");
+        return nullptr;
+    }
+
+    SyncMessageHandler::SyncTime(syncMsg->currentTime, device);
+
+    SyncSchedule schedule = {};
+    schedule.collectionMode = syncMsg->collectionMode();
+    schedule.parityCount = syncMsg->parityCount();
+    schedule.interval = syncMsg->interval;
+    schedule.startTime = syncMsg->startTime;
+    schedule.totalSlots = syncMsg->totalSlots;
+
+    // 配置版本未变时不读取条目，沿用已应用的时隙分配；
+    // 本从机条目不在本次变化区间内且版本连续时同样沿用
+    const bool haveCurrentEntry = device->m_isConfigured && device->m_hasSyncEpoch;
+    Master2Slave::CompactSlaveEntry entry;
+    if (haveCurrentEntry && syncMsg->epoch == device->m_syncEpoch)
+    {
+        schedule.timeSlot = device->currentConfig.timeSlot;
+        schedule.testCount = device->currentConfig.testCount;
+        schedule.startSlot = device->m_startSlot;
+    }
+    else if (syncMsg->getEntry(device->m_shortId, entry))
+    {
+        schedule.timeSlot = entry.timeSlot;
+        schedule.testCount = entry.testCount;
+        schedule.reset = (entry.reset == 1);
+        schedule.startSlot = entry.startSlot;
+
+        elog_v("SyncMessageHandler", "Found compact entry for short ID %d - TimeSlot: %d, TestCount: %d, StartSlot: %d",
+               device->m_shortId, entry.timeSlot, entry.testCount, entry.startSlot);
+    }
+    else if (haveCurrentEntry && syncMsg->baseEpoch == device->m_syncEpoch)
+    {
+        schedule.timeSlot = device->currentConfig.timeSlot;
+        schedule.testCount = device->currentConfig.testCount;
+        schedule.startSlot = device->m_startSlot;
+    }
+    else
+    {
+        // 错过了中间版本，无法确定本从机的条目，等待包含本从机条目的同步
+        elog_w("SyncMessageHandler", "Compact sync epoch %d (base %d) does not cover short ID %d at epoch %d",
+               syncMsg->epoch, syncMsg->baseEpoch, device->m_shortId, device->m_syncEpoch);
+        return nullptr;
+    }
+
+    if (SyncMessageHandler::ApplySchedule(schedule, device))
+    {
+        device->m_syncEpoch = syncMsg->epoch;
+        device->m_hasSyncEpoch = true;
+    }
+    return nullptr; // CompactSyncMessage 不需要响应
 }
 
 // Ping Request Message Handler
@@ -307,9 +400,19 @@ std::unique_ptr<Message> PingRequestHandler::ProcessMessage(const Message &messa
     elog_v("PingRequestHandler", "Processing Ping request - Sequence number: %u, Timestamp: %u",
            pingMsg->sequenceNumber, pingMsg->timestamp);
 
+    // 请求带回上一次响应的T4，完成上一次测量（旧版6字节请求不带回，echoTimestamp为0）
+    if (pingMsg->echoTimestamp != 0)
+    {
+        device->CompletePingExchange(pingMsg->echoSequence, pingMsg->echoTimestamp);
+    }
+    device->BeginPingExchange(pingMsg->sequenceNumber, pingMsg->timestamp, device->m_rxTimestampUs);
+
     auto response = std::make_unique<Slave2Master::PingRspMessage>();
     response->sequenceNumber = pingMsg->sequenceNumber;
-    response->timestamp = SlaveApp::SlaveDevice::getCurrentTimestamp();
+    response->extended = pingMsg->extended; // 按请求的格式响应，旧版主机收到6字节响应
+    response->originTimestamp = pingMsg->timestamp;
+    response->receiveTimestamp = device->m_rxTimestampUs;
+    response->timestamp = SlaveApp::SlaveDevice::getCurrentTimestamp(); // 发送前更新为T3
     return std::move(response);
 }
 
@@ -332,4 +435,32 @@ std::unique_ptr<Message> ShortIdAssignHandler::ProcessMessage(const Message &mes
     return std::move(response);
 }
 
+// Fragment NACK Message Handler
+std::unique_ptr<Message> FragmentNackHandler::ProcessMessage(const Message &message, SlaveDevice *device)
+{
+    const auto *nackMsg = dynamic_cast<const Master2Slave::FragmentNackMessage *>(&message);
+    if (!nackMsg)
+        return nullptr;
+
+    elog_v("FragmentNackHandler", "Processing fragment NACK - Cycle: %d, Fragment count: %d, Missing bitmap: 0x%08lX",
+           nackMsg->cycle, nackMsg->fragmentCount, static_cast<unsigned long>(nackMsg->missingBitmap));
+
+    // 丢失的分片在后续激活时隙中重发，不需要响应
+    device->RequestFragmentRetransmit(nackMsg->cycle, nackMsg->fragmentCount, nackMsg->missingBitmap);
+    return nullptr;
+}
+
+// Settle Calibrate Message Handler
+std::unique_ptr<Message> SettleCalibrateHandler::ProcessMessage(const Message &message, SlaveDevice *device)
+{
+    if (!dynamic_cast<const Master2Slave::SettleCalibrateMessage *>(&message))
+        return nullptr;
+
+    elog_v("SettleCalibrateHandler", "Processing settle calibrate request");
+
+    // 标定阻塞约1秒，由数据采集任务在未采集时执行，接收任务继续处理同步消息
+    device->RequestSettleCalibration();
+    return nullptr;
+}
+
 } // namespace SlaveApp
\ No newline at end of file
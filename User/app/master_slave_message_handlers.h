@@ -21,6 +21,20 @@ class IMaster2SlaveMessageHandler
     virtual std::unique_ptr<Message> ProcessMessage(const Message &message, SlaveDevice *device) = 0;
 };
 
+// 从同步消息中得到的本从机调度参数（完整同步与紧凑同步共用）
+struct SyncSchedule
+{
+    uint8_t collectionMode; // 采集模式（SyncMessage::collectionMode）
+    uint8_t parityCount;    // 导通数据校验分片数
+    uint8_t interval;       // 采集间隔（ms）
+    uint64_t startTime;     // 启动时间戳（us）
+    uint8_t timeSlot;       // 分配的时隙
+    uint8_t testCount;      // 本从机检测数量
+    bool reset;             // 是否请求复位
+    uint16_t startSlot;     // 本从机的起始时隙
+    uint16_t totalSlots;    // 所有从机的检测数量之和
+};
+
 // Sync Message Handler
 class SyncMessageHandler final : public IMaster2SlaveMessageHandler
 {
@@ -34,10 +48,33 @@ class SyncMessageHandler final : public IMaster2SlaveMessageHandler
     SyncMessageHandler &operator=(const SyncMessageHandler &) = delete;
     SyncMessageHandler(const SyncMessageHandler &) = delete;
 
+    // 按主机时间校准本地时间偏移，并进入TDMA模式
+    static void SyncTime(uint64_t masterTime, SlaveDevice *device);
+
+    // 应用调度参数：比较配置变化、处理复位、配置采集器和时隙管理器并启动采集
+    static bool ApplySchedule(const SyncSchedule &schedule, SlaveDevice *device);
+
   private:
     SyncMessageHandler() = default;
 };
 
+// Compact Sync Message Handler
+class CompactSyncMessageHandler final : public IMaster2SlaveMessageHandler
+{
+  public:
+    static CompactSyncMessageHandler &GetInstance()
+    {
+        static CompactSyncMessageHandler instance;
+        return instance;
+    }
+    std::unique_ptr<Message> ProcessMessage(const Message &message, SlaveDevice *device) override;
+    CompactSyncMessageHandler &operator=(const CompactSyncMessageHandler &) = delete;
+    CompactSyncMessageHandler(const CompactSyncMessageHandler &) = delete;
+
+  private:
+    CompactSyncMessageHandler() = default;
+};
+
 // Ping Request Message Handler
 class PingRequestHandler final : public IMaster2SlaveMessageHandler
 {
@@ -72,6 +109,40 @@ class ShortIdAssignHandler final : public IMaster2SlaveMessageHandler
     ShortIdAssignHandler() = default;
 };
 
+// Fragment NACK Message Handler
+class FragmentNackHandler final : public IMaster2SlaveMessageHandler
+{
+  public:
+    static FragmentNackHandler &GetInstance()
+    {
+        static FragmentNackHandler instance;
+        return instance;
+    }
+    std::unique_ptr<Message> ProcessMessage(const Message &message, SlaveDevice *device) override;
+    FragmentNackHandler(const FragmentNackHandler &) = delete;
+    FragmentNackHandler &operator=(const FragmentNackHandler &) = delete;
+
+  private:
+    FragmentNackHandler() = default;
+};
+
+// Settle Calibrate Message Handler
+class SettleCalibrateHandler final : public IMaster2SlaveMessageHandler
+{
+  public:
+    static SettleCalibrateHandler &GetInstance()
+    {
+        static SettleCalibrateHandler instance;
+        return instance;
+    }
+    std::unique_ptr<Message> ProcessMessage(const Message &message, SlaveDevice *device) override;
+    SettleCalibrateHandler(const SettleCalibrateHandler &) = delete;
+    SettleCalibrateHandler &operator=(const SettleCalibrateHandler &) = delete;
+
+  private:
+    SettleCalibrateHandler() = default;
+};
+
 // Secondary Control Message Handler
 
 } // namespace SlaveApp
\ No newline at end of file
@@ -1,6 +1,7 @@
 
 #include "slave_device.h"
 
+#include <algorithm>
 #include <cstdio>
 
 #include "FreeRTOS.h"
@@ -10,6 +11,7 @@
 #include "config.h"
 #include "elog.h"
 #include "firmware_version.h"
+#include "freertos_new.h"
 #include "hal_uid.hpp"
 #include "hptimer.hpp"
 #include "main.h"
@@ -24,6 +26,9 @@ using namespace WhtsProtocol;
 // 发送超时
 #define MsgProc_TX_TIMEOUT 1000
 
+// 编码需要整周期数据，启用编码时在周期结束后整体发送
+#define CONDUCTION_ROW_STREAMING (ENABLE_ROW_STREAMING && !ENABLE_CONDUCTION_ENCODING)
+
 namespace SlaveApp
 {
 
@@ -31,8 +36,13 @@ SlaveDevice::SlaveDevice()
     : m_deviceId(DeviceUID::get()), // 自动读取设备UID
       m_shortId(0),                 // 初始短ID为0，表示未分配
       m_isJoined(false),            // 初始未入网
-      m_isConfigured(false), m_deviceState(SlaveDeviceState::IDLE), m_timeOffset(0), // 初始时间偏移量为0
+      m_isConfigured(false),        // 初始未配置
+      m_startSlot(0),               // 初始起始时隙为0
+      m_syncEpoch(0),               // 初始无紧凑同步配置版本
+      m_hasSyncEpoch(false), m_deviceState(SlaveDeviceState::IDLE), m_timeOffset(0), // 初始时间偏移量为0
       m_isCollecting(false),                                                         // 初始未在采集
+      m_rxTimestampUs(0), m_pingSequence(0), m_pingOriginUs(0), m_pingReceiveUs(0), m_pingPending(false),
+      m_pathDelaySamples{}, m_pathDelayCount(0), m_pathDelayNext(0), m_oneWayDelayUs(0),
       m_lastSyncMessageTime(0),                                                      // 初始化上次sync消息时间
       m_lastHeartbeatTime(HptimerGetUs()),     // 初始化上次心跳时间为当前时间
       m_inTdmaMode(false),                     // 初始不在TDMA模式
@@ -42,11 +52,17 @@ SlaveDevice::SlaveDevice()
       m_isFirstCollection(true),               // 初始为第一次采集
       m_currentFragmentIndex(0),               // 初始分片索引为0
       m_isFragmentSendingInProgress(false),    // 初始未进行分片发送
-      m_hasPendingSlaveControlResponse(false), // 初始无待回复的SlaveControl消息
-      m_hasPendingResetResponse(false),        // 初始无待回复的Reset消息
-      m_pendingSlaveControlResponse(nullptr),  // 初始化待回复的SlaveControl响应为空
-      m_pendingResetResponse(nullptr),         // 初始化待回复的Reset响应为空
-      m_deviceStatus({}), m_masterComm(), m_timeOffsetMutex("TimeOffsetMutex")
+      m_streamedBytes(0), m_queuedFragments(0), m_streamLive(false),
+      m_conductionSequence(0),                 // 初始导通数据周期序号为0
+      m_retainedFragmentTag(0),                // 初始无保留分片
+      m_fragmentCycle(0),                      // 初始分片周期号为0
+      m_fragmentNackBitmap(0),                 // 初始无待重传分片
+      m_hasUnretainedFragments(false),         // 初始无待保留分片
+      m_settleCalibrationRequested(false),     // 初始无标定请求
+      m_txExpiredCount(0),                     // 初始无过期丢弃的发送条目
+      m_linkPlan(), m_linkPlanSamples(0), m_linkPlanInterval(0), m_linkPlanOverhead(0),
+      m_deviceStatus({}), m_masterComm(), m_timeOffsetMutex("TimeOffsetMutex"), m_txQueueMutex("TxQueueMutex"),
+      m_slotMutex("SlotMutex")
 {
 
     // Initialize continuity collector
@@ -73,8 +89,14 @@ SlaveDevice::SlaveDevice()
         });
     }
 
-    // set MTU = 1016
-    m_processor.SetMTU(800);
+    // 链路规划前使用固定MTU
+    m_encoder.SetMTU(LINK_DEFAULT_MTU);
+
+    // 收到主机带CRC的帧后，发送也附加CRC
+    m_decoder.SetCrcPeer(&m_encoder);
+
+    // 分片超时清理使用硬件定时器的毫秒时间
+    m_decoder.SetFragmentClock([]() { return static_cast<uint32_t>(HptimerGetUs64() / 1000); });
 
     // Initialize message handlers
     InitializeMessageHandlers();
@@ -91,10 +113,16 @@ void SlaveDevice::InitializeMessageHandlers()
 {
     messageHandlers_[static_cast<uint8_t>(WhtsProtocol::Master2SlaveMessageId::SYNC_MSG)] =
         &SyncMessageHandler::GetInstance();
+    messageHandlers_[static_cast<uint8_t>(WhtsProtocol::Master2SlaveMessageId::COMPACT_SYNC_MSG)] =
+        &CompactSyncMessageHandler::GetInstance();
     messageHandlers_[static_cast<uint8_t>(WhtsProtocol::Master2SlaveMessageId::PING_REQ_MSG)] =
         &PingRequestHandler::GetInstance();
     messageHandlers_[static_cast<uint8_t>(WhtsProtocol::Master2SlaveMessageId::SHORT_ID_ASSIGN_MSG)] =
         &ShortIdAssignHandler::GetInstance();
+    messageHandlers_[static_cast<uint8_t>(WhtsProtocol::Master2SlaveMessageId::FRAGMENT_NACK_MSG)] =
+        &FragmentNackHandler::GetInstance();
+    messageHandlers_[static_cast<uint8_t>(WhtsProtocol::Master2SlaveMessageId::SETTLE_CALIBRATE_MSG)] =
+        &SettleCalibrateHandler::GetInstance();
 }
 
 std::unique_ptr<Message> SlaveDevice::processMaster2SlaveMessage(const Message &message)
@@ -232,67 +260,62 @@ void SlaveDevice::resetDevice() const
     elog_v("SlaveDevice", "Device reset to READY state, configuration preserved");
 }
 
-void SlaveDevice::sendPendingResponses()
+bool SlaveDevice::QueueMessage(const TxPriority priority, std::unique_ptr<Message> message)
 {
-    // 发送待回复的Reset响应
-    if (m_hasPendingResetResponse && m_pendingResetResponse)
-    {
-        elog_v(TAG, "Sending pending Reset response in active slot");
+    const uint32_t deadlineMs = priority == TxPriority::CONTROL ? TX_CONTROL_DEADLINE_MS : TX_TELEMETRY_DEADLINE_MS;
+    const uint64_t deadlineUs = HptimerGetUs64() + static_cast<uint64_t>(deadlineMs) * 1000;
 
-        std::vector<std::vector<uint8_t>> responseData =
-            m_processor.packSlave2MasterMessage(m_deviceId, *m_pendingResetResponse);
+    m_txQueueMutex.take();
+    const bool queued = m_txQueue.PushMessage(priority, std::move(message), deadlineUs);
+    m_txQueueMutex.give();
 
-        // 发送所有片段
-        bool success = true;
-        for (auto &fragment : responseData)
-        {
-            if (send(fragment) != 0)
-            {
-                elog_e(TAG, "Failed to send Reset response fragment");
-                success = false;
-                break;
-            }
-        }
-
-        if (success)
-        {
-            elog_v(TAG, "Reset response sent successfully");
-        }
-
-        // 清除待回复状态
-        m_hasPendingResetResponse = false;
-        m_pendingResetResponse.reset();
+    if (!queued)
+    {
+        elog_w(TAG, "tx queue full, priority %d message dropped", static_cast<int>(priority));
     }
+    return queued;
+}
 
-    // 发送待回复的SlaveControl响应
-    if (m_hasPendingSlaveControlResponse && m_pendingSlaveControlResponse)
-    {
-        elog_v(TAG, "Sending pending SlaveControl response in active slot");
+void SlaveDevice::ClearQueuedFragments()
+{
+    m_txQueueMutex.take();
+    m_txQueue.RemoveFragments(&m_fragmentCursor);
+    m_txQueueMutex.give();
+}
 
-        std::vector<std::vector<uint8_t>> responseData =
-            m_processor.packSlave2MasterMessage(m_deviceId, *m_pendingSlaveControlResponse);
+void SlaveDevice::StopSlotManager()
+{
+    if (!m_slotManager)
+    {
+        return;
+    }
 
-        // 发送所有片段
-        bool success = true;
-        for (auto &fragment : responseData)
-        {
-            if (send(fragment) != 0)
-            {
-                elog_e(TAG, "Failed to send SlaveControl response fragment");
-                success = false;
-                break;
-            }
-        }
+    // 拿到锁时时隙回调已经返回，停止后不会再进入回调
+    m_slotMutex.take();
+    m_slotManager->Stop();
+    m_slotMutex.give();
+}
 
-        if (success)
-        {
-            elog_v(TAG, "SlaveControl response sent successfully");
-        }
+bool SlaveDevice::StartSlotManager()
+{
+    if (!m_slotManager)
+    {
+        return false;
+    }
 
-        // 清除待回复状态
-        m_hasPendingSlaveControlResponse = false;
-        m_pendingSlaveControlResponse.reset();
+    // 复位后才允许进入第一个时隙回调
+    m_slotMutex.take();
+    // 采集器重新开始时数据矩阵已清空，仍引用它的本周期分片不再有效
+    if (m_streamLive)
+    {
+        ClearQueuedFragments();
+        abandonFragmentSending();
     }
+    m_streamLive = false;
+    m_streamedBytes = 0;
+    const bool started = m_slotManager->Start();
+    m_slotMutex.give();
+    return started;
 }
 
 // 心跳包功能已关闭
@@ -318,7 +341,7 @@ void SlaveDevice::sendPendingResponses()
 //     heartbeatMsg->batteryLevel = batteryPercentage;
 
 //     // 打包消息
-//     std::vector<std::vector<uint8_t>> messageData = m_processor.packSlave2MasterMessage(m_deviceId, *heartbeatMsg);
+//     std::vector<std::vector<uint8_t>> messageData = m_encoder.packSlave2MasterMessage(m_deviceId, *heartbeatMsg);
 
 //     // 发送所有片段
 //     bool success = true;
@@ -366,7 +389,7 @@ void SlaveDevice::sendPendingResponses()
 //     joinRequestMsg->versionPatch = FIRMWARE_VERSION_PATCH;
 
 //     // 打包消息
-//     std::vector<std::vector<uint8_t>> messageData = m_processor.packSlave2MasterMessage(m_deviceId, *joinRequestMsg);
+//     std::vector<std::vector<uint8_t>> messageData = m_encoder.packSlave2MasterMessage(m_deviceId, *joinRequestMsg);
 
 //     // 发送所有片段
 //     bool success = true;
@@ -392,143 +415,538 @@ void SlaveDevice::sendPendingResponses()
 
 void SlaveDevice::OnSlotChanged(const SlotInfo &slotInfo)
 {
-    // 如果有待回复的响应，即使不在采集状态也要处理
-    if (!m_isCollecting && (m_hasPendingResetResponse || m_hasPendingSlaveControlResponse))
+    // 未采集时只在激活时隙发送排队的响应
+    if (!m_isCollecting)
     {
-        if (slotInfo.m_slotType == SlotType::ACTIVE && slotInfo.m_activePin == 0)
+        if (slotInfo.m_slotType == SlotType::ACTIVE)
         {
-            elog_v(TAG, "Sending pending responses even when not collecting");
-            sendPendingResponses();
+            drainTxQueue(slotInfo);
         }
         return;
     }
 
     // 只在采集状态下处理采集相关的时隙事件
-    if (!m_isCollecting || !m_continuityCollector || !m_slotManager)
+    if (!m_continuityCollector || !m_slotManager)
     {
         return;
     }
 
-    // 优先发送待回复的响应消息（避免与数据传输冲撞）
-    // 只在第一个激活时隙发送待回复的响应
-    if (slotInfo.m_slotType == SlotType::ACTIVE && slotInfo.m_activePin == 0)
-    {
-        sendPendingResponses();
-    }
-
     // 先进行采集动作
     // 通知采集器处理当前时隙
     m_continuityCollector->ProcessSlot(slotInfo.m_currentSlot, slotInfo.m_activePin,
                                        slotInfo.m_slotType == SlotType::ACTIVE);
 
+#if CONDUCTION_ROW_STREAMING
+    // 新采集的行立即追加到发送数据，已就绪的分片可在本周期的激活时隙中发送
+    appendCollectedRows();
+#else
     // 检查采集是否完成
     if (m_continuityCollector->IsCollectionComplete())
     {
         elog_v(TAG, "Data collection cycle completed, saving data for next cycle");
 
         // 保存当前采集的数据，供下一个周期发送
-        const auto dataVector = m_continuityCollector->GetDataVector();
-        lastCollectionData = dataVector;
+        // 复制到复用的缓冲区，不重新分配
+        const auto &packedData = m_continuityCollector->GetPackedData();
+        lastCollectionData.assign(packedData.begin(), packedData.end());
         m_hasDataToSend = true;
-        elog_v(TAG, "Saved %d bytes of data for next cycle transmission", dataVector.size());
+        elog_v(TAG, "Saved %d bytes of data for next cycle transmission", lastCollectionData.size());
 
         // 清空数据矩阵为下一次采集做准备
         m_continuityCollector->ClearData();
     }
+#endif
 
-    // 采集完成后，再进行打包和发送动作
-    // 检查是否正在进行分片发送，如果是，在本设备的每个激活时隙发送对应的分片
-    // 第一个激活时隙（activePin == 0）发送第一包，第二个激活时隙（activePin == 1）发送第二包，以此类推
-    if (m_isFragmentSendingInProgress && slotInfo.m_slotType == SlotType::ACTIVE)
+    // 采集完成后，再进行打包和发送动作（只在本设备的激活时隙发送）
+    if (slotInfo.m_slotType != SlotType::ACTIVE)
     {
-        // 当前激活时隙对应的分片索引（activePin 从0开始，对应第一个分片索引0）
-        size_t targetFragmentIndex = static_cast<size_t>(slotInfo.m_activePin);
+        return;
+    }
 
-        // 检查目标分片索引是否有效
-        if (targetFragmentIndex < m_pendingFragments.size())
+#if CONDUCTION_ROW_STREAMING
+    // 上一组分片发完后立即开始发送本周期已采集的数据，发送中时追加新就绪的分片
+    if (m_isFragmentSendingInProgress)
+    {
+        queueReadyFragments();
+    }
+    else if (m_dataCollectionTask)
+    {
+        updateLinkPlan();
+        m_dataCollectionTask->sendDataToBackend();
+    }
+#else
+    // 第一个激活时隙开始发送上一周期采集的数据，分片进入发送队列
+    if (slotInfo.m_activePin == 0 && m_dataCollectionTask)
+    {
+        // 上一组分片发完后才能改变MTU
+        if (!m_isFragmentSendingInProgress)
         {
-            // 确保当前分片索引指向目标分片（每个时隙发送对应的分片）
-            if (m_currentFragmentIndex != targetFragmentIndex)
-            {
-                elog_v(TAG, "Adjusting fragment index from %d to %d for activePin %d", m_currentFragmentIndex,
-                       targetFragmentIndex, slotInfo.m_activePin);
-                m_currentFragmentIndex = targetFragmentIndex;
-            }
+            updateLinkPlan();
+        }
+        m_dataCollectionTask->sendDataToBackend();
+    }
+#endif
+
+    // 按优先级发送：控制响应 > 遥测 > 导通数据分片 > 重传分片
+    // 本时隙预算内放不下的条目留到下一个激活时隙
+    drainTxQueue(slotInfo);
+}
+
+bool SlaveDevice::RequestFragmentRetransmit(const uint8_t cycle, const uint8_t fragmentCount,
+                                            const uint32_t missingBitmap)
+{
+    // 周期号和分片数都一致才是针对保留分片的请求，迟到或重复的NACK可能对应已被替换的旧周期
+    const uint16_t tag = m_retainedFragmentTag.load(std::memory_order_acquire);
+    const uint8_t retainedCount = static_cast<uint8_t>(tag & 0xFF);
+    const uint8_t retainedCycle = static_cast<uint8_t>(tag >> 8);
+    if (retainedCount == 0 || fragmentCount != retainedCount || cycle != retainedCycle)
+    {
+        elog_w(TAG, "nack ignored: cycle %d/%d frags requested, cycle %d/%d retained", cycle, fragmentCount,
+               retainedCycle, retainedCount);
+        return false;
+    }
+
+    // 只保留有效分片范围内的位
+    const uint32_t validMask =
+        retainedCount >= Master2Slave::FragmentNackMessage::MAX_FRAGMENTS ? 0xFFFFFFFFUL : (1UL << retainedCount) - 1;
+    const uint32_t bitmap = missingBitmap & validMask;
+    if (bitmap == 0)
+    {
+        return false;
+    }
+
+    m_fragmentNackBitmap.fetch_or(bitmap, std::memory_order_relaxed);
+
+    // 校验后保留分片被替换时撤回本次请求的位，避免按旧位图重发新数据的分片
+    if (m_retainedFragmentTag.load(std::memory_order_acquire) != tag)
+    {
+        m_fragmentNackBitmap.fetch_and(~bitmap, std::memory_order_relaxed);
+        elog_w(TAG, "nack ignored: cycle %d superseded", cycle);
+        return false;
+    }
+    elog_i(TAG, "nack: bitmap 0x%08lX of %d frags", static_cast<unsigned long>(bitmap), retainedCount);
+    return true;
+}
+
+void SlaveDevice::RequestSettleCalibration()
+{
+    m_settleCalibrationRequested.store(true, std::memory_order_relaxed);
+}
+
+void SlaveDevice::ClearRetainedFragments()
+{
+    m_retainedFragmentTag.store(0, std::memory_order_release);
+    m_fragmentNackBitmap.store(0, std::memory_order_relaxed);
+    m_retainedData.clear();
+    m_retainedCursor = ConductionFragmentCursor();
+    m_hasUnretainedFragments = false;
+}
+
+void SlaveDevice::encodeSendingData()
+{
+    // 数据长度变化（配置改变）或到达参考周期间隔时不做异或，主机可从该周期重新开始解码
+    const bool keyframe = m_previousRawData.size() != m_sendingData.size() ||
+                          m_conductionSequence % CONDUCTION_KEYFRAME_INTERVAL == 0;
+
+    m_encodedMessage.sequence = m_conductionSequence++;
+    m_encodedMessage.rawLength = static_cast<uint16_t>(m_sendingData.size());
+    m_encodedMessage.encoding =
+        ConductionCodec::encode(m_sendingData.data(), m_sendingData.size(),
+                                keyframe ? nullptr : m_previousRawData.data(), m_codecScratch, m_encodedMessage.data);
+
+    // 原始数据留作下一周期的参考，发送缓冲区改写为编码消息体
+    m_previousRawData.swap(m_sendingData);
+    m_sendingData.resize(m_encodedMessage.encodedSize());
+    size_t length = 0;
+    m_encodedMessage.encodeInto(m_sendingData.data(), m_sendingData.size(), length);
+
+    elog_i(TAG, "encoded %d -> %d bytes (0x%02X)", m_encodedMessage.rawLength, length, m_encodedMessage.encoding);
+}
+
+void SlaveDevice::appendCollectedRows()
+{
+    // 发送中的本周期数据直接引用采集器的数据矩阵（已是发送格式），这里只更新可发送的长度
+    m_streamedBytes = m_continuityCollector->GetCompletedBytes();
+    if (!m_continuityCollector->IsCollectionComplete())
+    {
+        return;
+    }
+
+    // 采集器即将开始下一周期，完整数据只在这里复制一次，发送完成后交换为重传保留的数据
+    const auto &packedData = m_continuityCollector->GetPackedData();
+    if (m_streamLive)
+    {
+        // 发送队列中的分片条目引用游标本身，改写游标的数据指针后剩余分片从副本生成
+        m_sendingData.assign(packedData.begin(), packedData.end());
+        m_fragmentCursor.data = m_sendingData.data();
+        m_streamLive = false;
+    }
+    else
+    {
+        // 本周期未开始发送（上一组分片仍在发送），整周期数据等待发送，替换未发送的旧数据
+        lastCollectionData.assign(packedData.begin(), packedData.end());
+        m_hasDataToSend = true;
+    }
+    m_streamedBytes = 0;
+    elog_v(TAG, "Data collection cycle completed (%d bytes, %s)", packedData.size(),
+           m_hasDataToSend ? "queued" : "streaming");
+
+    // 清空数据矩阵并开始下一个采集周期
+    m_continuityCollector->RestartCycle();
+}
+
+void SlaveDevice::queueReadyFragments()
+{
+    if (!m_isFragmentSendingInProgress)
+    {
+        return;
+    }
+
+    // 未完成的周期只有已复制的字节可用
+    const size_t fragmentCount = m_fragmentCursor.fragmentCount();
+    const size_t available = m_streamLive ? m_streamedBytes : m_fragmentCursor.dataLength;
+    size_t end = m_queuedFragments;
+    while (end < fragmentCount && ProtocolEncoder::conductionFragmentDataEnd(m_fragmentCursor, end) <= available)
+    {
+        end++;
+    }
+    if (end == m_queuedFragments)
+    {
+        return;
+    }
+
+    // 分片进入发送队列，由激活时隙按预算发送，放不下的分片顺延到下一个激活时隙
+    m_txQueueMutex.take();
+    const bool queued = m_txQueue.PushFragments(m_fragmentCursor, m_queuedFragments, end, bulkDeadlineUs());
+    if (!queued)
+    {
+        m_txQueue.RemoveFragments(&m_fragmentCursor);
+    }
+    m_txQueueMutex.give();
+    if (!queued)
+    {
+        elog_e(TAG, "tx queue full, %d frags dropped", fragmentCount - m_queuedFragments);
+        abandonFragmentSending();
+        return;
+    }
+    m_queuedFragments = end;
+}
+
+void SlaveDevice::finishFragmentSending()
+{
+    m_currentFragmentIndex = 0;
+    m_isFragmentSendingInProgress = false;
+    m_queuedFragments = 0;
+
+    // 上一组分片仍有待重传时先不替换，重传完成后再保留本组分片
+    m_hasUnretainedFragments = true;
+    if (m_fragmentNackBitmap.load(std::memory_order_relaxed) == 0)
+    {
+        retainSentFragments();
+    }
+}
+
+void SlaveDevice::retainSentFragments()
+{
+    if (!m_hasUnretainedFragments)
+    {
+        return;
+    }
+
+    // 先使接收任务的NACK校验失效，再清除旧周期的请求
+    m_retainedFragmentTag.store(0, std::memory_order_release);
+    const uint32_t dropped = m_fragmentNackBitmap.exchange(0, std::memory_order_relaxed);
+    if (dropped != 0)
+    {
+        elog_w(TAG, "nack dropped: bitmap 0x%08lX superseded by new data", static_cast<unsigned long>(dropped));
+    }
+
+    // 交换而不复制，m_sendingData 保留容量供下一周期复用
+    // 校验分片不参与重传，NACK位图只对应数据分片
+    m_retainedData.swap(m_sendingData);
+    m_retainedCursor = m_fragmentCursor;
+    m_retainedCursor.data = m_retainedData.data();
+    m_retainedCursor.parityFragments = 0;
+    m_fragmentCursor = ConductionFragmentCursor();
+    const uint8_t retainedCount =
+        std::min(m_retainedCursor.dataFragments, Master2Slave::FragmentNackMessage::MAX_FRAGMENTS);
+    m_retainedFragmentTag.store(static_cast<uint16_t>(m_retainedCursor.cycle << 8 | retainedCount),
+                                std::memory_order_release);
+    m_hasUnretainedFragments = false;
+}
+
+void SlaveDevice::abandonFragmentSending()
+{
+    elog_w(TAG, "tx expired at frag %d/%d", m_currentFragmentIndex + 1, m_fragmentCursor.fragmentCount());
+
+    // 未发完的数据不完整，不保留供重传
+    m_fragmentCursor = ConductionFragmentCursor();
+    m_currentFragmentIndex = 0;
+    m_isFragmentSendingInProgress = false;
+    m_queuedFragments = 0;
+    m_sendingData.clear();
+
+    // 本周期仍在采集时，周期结束后整周期数据复制到 lastCollectionData 重新发送
+    if (m_streamLive)
+    {
+        m_streamLive = false;
+        m_streamedBytes = 0;
+    }
+}
+
+uint64_t SlaveDevice::bulkDeadlineUs() const
+{
+    const uint64_t slotUs = static_cast<uint64_t>(currentConfig.interval) * 1000;
+    const uint64_t totalSlots = m_slotManager ? m_slotManager->GetTotalSlots() : currentConfig.testCount;
+    const uint64_t cycleUs = totalSlots * slotUs;
+
+    // 截止在TX_BULK_DEADLINE_CYCLES个周期后的第一个激活时隙之前，新数据到来时旧分片已过期
+    return HptimerGetUs64() + TX_BULK_DEADLINE_CYCLES * cycleUs - slotUs / 2;
+}
+
+void SlaveDevice::updateLinkPlan()
+{
+#if ENABLE_LINK_PLANNER
+    size_t overhead = m_encoder.conductionFragmentOverhead(m_shortId != 0);
+    if (m_shortId == 0 && currentConfig.parityCount > 0)
+    {
+        overhead += Slave2Master::ConductionParityMessage::Schema::FIXED_SIZE;
+    }
+
+    const uint32_t samples = m_masterComm.GetLinkSampleCount();
+    if (m_linkPlan.isValid() && m_linkPlanInterval == currentConfig.interval && m_linkPlanOverhead == overhead &&
+        samples - m_linkPlanSamples < LINK_PLAN_RESAMPLE_COUNT)
+    {
+        return;
+    }
+
+    LinkTiming timing;
+    if (!m_masterComm.GetLinkTiming(timing, LINK_DEFAULT_BYTE_NS))
+    {
+        timing.perFrameUs = LINK_DEFAULT_FRAME_US;
+        timing.perByteNs = LINK_DEFAULT_BYTE_NS;
+    }
+
+    const uint32_t slotUs = static_cast<uint32_t>(currentConfig.interval) * 1000;
+    const uint32_t budgetUs = slotUs > TX_SLOT_GUARD_US ? slotUs - TX_SLOT_GUARD_US : 0;
+    const bool sameLayout = m_linkPlanInterval == currentConfig.interval && m_linkPlanOverhead == overhead;
+    m_linkPlanSamples = samples;
+    m_linkPlanInterval = currentConfig.interval;
+    m_linkPlanOverhead = overhead;
+
+    LinkPlan plan;
+    if (!LinkPlanner::plan(timing, budgetUs, overhead, LINK_PLAN_MIN_FRAME, FRAME_LEN_MAX, UWB_TX_RING_DEPTH,
+                           plan))
+    {
+        elog_w(TAG, "link plan failed: slot %d ms, %lu us + %lu ns/B", currentConfig.interval,
+               static_cast<unsigned long>(timing.perFrameUs), static_cast<unsigned long>(timing.perByteNs));
+        m_linkPlan = LinkPlan();
+        m_encoder.SetMTU(LINK_DEFAULT_MTU);
+        return;
+    }
+
+    // 当前计划仍能发完且新计划提升不明显时保持不变
+    if (sameLayout && LinkPlanner::fits(timing, budgetUs, m_linkPlan) &&
+        static_cast<size_t>(plan.slotPayload) * 100 <=
+            static_cast<size_t>(m_linkPlan.slotPayload) * (100 + LINK_PLAN_HYSTERESIS_PERCENT))
+    {
+        return;
+    }
+
+    m_linkPlan = plan;
+    m_encoder.SetMTU(plan.frameSize);
+    elog_i(TAG, "link plan: %d B x %d/slot (%d B payload), %lu us + %lu ns/B", plan.frameSize, plan.framesPerSlot,
+           plan.slotPayload, static_cast<unsigned long>(timing.perFrameUs),
+           static_cast<unsigned long>(timing.perByteNs));
+
+    // 上报主机，用于调整时隙分配
+    auto report = std::make_unique<Slave2Master::LinkPlanMessage>();
+    report->frameSize = plan.frameSize;
+    report->framesPerSlot = plan.framesPerSlot;
+    report->slotPayload = plan.slotPayload;
+    report->perFrameUs = static_cast<uint16_t>(std::min<uint32_t>(timing.perFrameUs, 0xFFFF));
+    report->perByteNs = static_cast<uint16_t>(std::min<uint32_t>(timing.perByteNs, 0xFFFF));
+    QueueMessage(TxPriority::TELEMETRY, std::move(report));
+#endif
+}
+
+void SlaveDevice::drainTxQueue(const SlotInfo &slotInfo)
+{
+    // 本时隙的发送预算：时隙间隔扣除保护时间，字节数按单时隙的链路容量
+    const uint64_t startUs = HptimerGetUs64();
+    const uint64_t slotUs = static_cast<uint64_t>(slotInfo.m_slotIntervalMs) * 1000;
+    const uint64_t budgetUs = slotUs > TX_SLOT_GUARD_US ? slotUs - TX_SLOT_GUARD_US : 0;
+    size_t bytesLeft = m_linkPlan.isValid() ? m_linkPlan.slotBytes() : TX_SLOT_BYTE_BUDGET;
+
+    while (bytesLeft > 0)
+    {
+        const uint64_t nowUs = HptimerGetUs64();
+        if (nowUs - startUs >= budgetUs)
+        {
+            break;
+        }
+
+        // 时隙回调的优先级高于UWB任务，写入的帧在回调返回后才发出；
+        // 发送环形缓冲区写满后不等待，剩余条目留到下一个激活时隙
+        if (!m_masterComm.HasTxSpace())
+        {
+            break;
+        }
+
+        const size_t sent = sendNextTxFrame(nowUs, bytesLeft);
+        if (sent == 0)
+        {
+            break;
+        }
+        bytesLeft -= std::min(sent, bytesLeft);
+    }
+}
 
-            // 发送当前时隙对应的分片
-            if (m_dataCollectionTask)
+size_t SlaveDevice::sendNextTxFrame(const uint64_t nowUs, const size_t limit)
+{
+    m_txQueueMutex.take();
+
+    // 丢弃过期条目
+    TxPriority priority = TxPriority::CONTROL;
+    TxEntry *entry = m_txQueue.Front(priority);
+    while (entry != nullptr && entry->IsExpired(nowUs))
+    {
+        if (entry->cursor == &m_fragmentCursor)
+        {
+            // 同一游标分批入队的后续分片一并移除
+            abandonFragmentSending();
+            m_txQueue.RemoveFragments(&m_fragmentCursor);
+        }
+        else
+        {
+            m_txQueue.Pop(priority);
+        }
+        m_txExpiredCount++;
+        entry = m_txQueue.Front(priority);
+    }
+
+    if (entry == nullptr)
+    {
+        m_txQueueMutex.give();
+
+        // 队列已空，用剩余预算重发主机请求的分片
+        // 重传放在新分片之后，避免与主机正在重组的本周期数据交错
+        return m_isFragmentSendingInProgress ? 0 : sendNackedFragment(limit);
+    }
+
+    size_t sent = 0;
+    if (entry->IsFragments())
+    {
+        const size_t fragmentCount = entry->cursor->fragmentCount();
+        sent = sendFragment(*entry->cursor, entry->nextFragment, limit);
+        if (sent > 0)
+        {
+            elog_i(TAG, "tx frag %d/%d", entry->nextFragment + 1, fragmentCount);
+            entry->nextFragment++;
+            if (entry->cursor == &m_fragmentCursor)
             {
-                m_dataCollectionTask->sendDataToBackend();
+                m_currentFragmentIndex = entry->nextFragment;
             }
 
-            // 检查是否还有剩余分片未发送，且当前是最后一个激活时隙
-            // 如果是，则在本时隙继续发送所有剩余分片
-            if (m_slotManager)
+            if (entry->nextFragment >= entry->endFragment)
             {
-                uint8_t deviceSlotCount = m_slotManager->GetTotalSlots() > 0 ? currentConfig.testCount : 0;
-                uint8_t lastActivePin = deviceSlotCount > 0 ? deviceSlotCount - 1 : 0;
-
-                // 如果当前是最后一个激活时隙，并且还有剩余分片未发送
-                if (slotInfo.m_activePin == lastActivePin && m_currentFragmentIndex < m_pendingFragments.size())
+                // 边采集边发送时分片分批入队，最后一批发完才算完成
+                const bool current = entry->cursor == &m_fragmentCursor && entry->endFragment >= fragmentCount;
+                m_txQueue.Pop(priority);
+                if (current)
                 {
-                    elog_w(TAG,
-                           "Last active slot reached but %d fragments remaining, sending all remaining fragments now",
-                           m_pendingFragments.size() - m_currentFragmentIndex);
-
-                    // 循环发送所有剩余分片
-                    while (m_currentFragmentIndex < m_pendingFragments.size())
-                    {
-                        // 调整索引并发送下一个分片
-                        m_dataCollectionTask->sendDataToBackend();
-                    }
+                    // 清空分片发送状态，分片保留供主机请求重传
+                    elog_i(TAG, "tx complete (%d frags)", fragmentCount);
+                    finishFragmentSending();
                 }
             }
         }
-        else
+    }
+    else
+    {
+        // 按优先级顺序收集连续的消息条目，合并进同一帧
+        static constexpr size_t MAX_BATCH = 8;
+        const Message *batch[MAX_BATCH];
+        TxPriority batchPriority[MAX_BATCH];
+        size_t count = 0;
+        for (size_t level = static_cast<size_t>(priority); level < TxQueue::PRIORITY_COUNT; ++level)
         {
-            // 如果分片数量少于激活时隙数量，说明所有分片都已发送完成
-            // 由于 activePin 是递增的，当 targetFragmentIndex >= m_pendingFragments.size() 时，
-            // 说明所有分片都已经处理过了，应该清除分片发送状态
-            if (!m_pendingFragments.empty())
+            const auto levelPriority = static_cast<TxPriority>(level);
+            size_t index = 0;
+            for (; index < m_txQueue.Size(levelPriority) && count < MAX_BATCH; ++index)
+            {
+                const TxEntry *pending = m_txQueue.At(levelPriority, index);
+                if (pending->IsFragments())
+                {
+                    break;
+                }
+                stampPingResponse(*pending->message);
+                batchPriority[count] = levelPriority;
+                batch[count++] = pending->message.get();
+            }
+            if (index < m_txQueue.Size(levelPriority))
             {
-                elog_v(TAG, "All fragments (%d) sent (activePin %d >= fragment count), clearing fragment sending state",
-                       m_pendingFragments.size(), slotInfo.m_activePin);
+                break; // 遇到分片条目或批量已满，保持发送顺序
             }
-            // 清空分片发送状态
-            m_pendingFragments.clear();
-            m_currentFragmentIndex = 0;
-            m_isFragmentSendingInProgress = false;
+        }
+
+        size_t packed = 0;
+        sent = sendMessageBatch(batch, count, limit, packed);
+        for (size_t i = 0; i < packed; ++i)
+        {
+            m_txQueue.Pop(batchPriority[i]);
+        }
+
+        // 整帧预算下仍放不下的消息（超过MTU）无法在时隙中发送，丢弃以免阻塞队列
+        if (packed == 0 && count > 0 && m_masterComm.HasTxSpace() &&
+            limit >= std::min<size_t>(m_encoder.getMTU(), FRAME_LEN_MAX))
+        {
+            elog_e(TAG, "%s exceeds MTU, dropped", batch[0]->getMessageTypeName());
+            m_txQueue.Pop(priority);
         }
     }
-    // 检查是否是本设备的第一个激活时隙
-    else if (slotInfo.m_slotType == SlotType::ACTIVE && slotInfo.m_activePin == 0)
-    { // 第一个激活引脚
 
-        // // 在TDMA模式下发送相应消息（当前在第一个激活时隙）
-        // if (m_inTdmaMode)
-        // {
-        //     // 检查是否已分配短ID
-        //     if (m_isJoined && m_shortId != 0)
-        //     {
-        //         // 有短ID，发送心跳包
-        //         sendHeartbeat();
-        //     }
-        // }
+    m_txQueueMutex.give();
+    return sent;
+}
+
+size_t SlaveDevice::sendNackedFragment(const size_t limit)
+{
+    uint32_t bitmap = m_fragmentNackBitmap.load(std::memory_order_relaxed);
+    size_t sent = 0;
+    while (bitmap != 0 && sent == 0)
+    {
+        // 从序号最小的丢失分片开始重发
+        const size_t index = static_cast<size_t>(__builtin_ctz(bitmap));
+        const uint32_t bit = 1UL << index;
 
-        // 发送数据到后端（每个周期都发送当前采集的数据）
-        // 如果数据需要分包，会在第一个时隙开始分片发送流程
-        if (m_dataCollectionTask)
+        if (index < m_retainedCursor.dataFragments)
         {
-            elog_v(TAG, "Sending current collection data to backend in first active slot");
-            m_dataCollectionTask->sendDataToBackend();
+            sent = sendFragment(m_retainedCursor, index, limit);
+            if (sent == 0)
+            {
+                return 0; // 超出预算或发送失败，保留该位，下个时隙重试
+            }
+            elog_i(TAG, "retx frag %d/%d", index + 1, m_retainedCursor.dataFragments);
         }
+
+        bitmap = m_fragmentNackBitmap.fetch_and(~bit, std::memory_order_relaxed) & ~bit;
     }
+
+    // 重传完成后保留暂存的本周期分片
+    if (bitmap == 0)
+    {
+        retainSentFragments();
+    }
+    return sent;
 }
 
 void SlaveDevice::setShortId(const uint8_t id)
 {
     m_shortId = id;
     m_isJoined = true;
+    // 紧凑同步按短ID定位条目，短ID变化后需要重新获得本从机条目
+    m_hasSyncEpoch = false;
     elog_d(TAG, "Short ID assigned: %d, device joined successfully", m_shortId);
 
     // sendHeartbeat();
@@ -541,9 +959,14 @@ void SlaveDevice::processFrame(const Frame &frame)
 
     if (frame.packetId == static_cast<uint8_t>(PacketId::MASTER_TO_SLAVE))
     {
-        std::unique_ptr<Message> masterMessage;
-
-        if (uint32_t targetSlaveId; m_processor.parseMaster2SlavePacket(frame.payload, targetSlaveId, masterMessage))
+        // 就地解析到消息存储中复用的对象，解析过程不做堆分配
+        Message *masterMessage = nullptr;
+        uint32_t targetSlaveId = 0;
+        const uint32_t allocCount = FreertosNewGetAllocCount();
+        const bool parsed = m_decoder.parseMaster2SlavePacket(frame.payload, targetSlaveId, masterMessage);
+        m_rxAllocCount += FreertosNewGetAllocCount() - allocCount;
+
+        if (parsed)
         {
             // Check if this message is for us (or broadcast)
             if (targetSlaveId == m_deviceId || targetSlaveId == BROADCAST_ID)
@@ -556,22 +979,29 @@ void SlaveDevice::processFrame(const Frame &frame)
 
                 // Process message and create response
 
-                if (const auto response = processMaster2SlaveMessage(*masterMessage))
+                if (auto response = processMaster2SlaveMessage(*masterMessage))
                 {
                     elog_v("SlaveDevice", "Generated response message");
 
-                    elog_v("SlaveDevice", "Packing Slave2Master message: %s", response->getMessageTypeName());
-                    std::vector<std::vector<uint8_t>> responseData =
-                        m_processor.packSlave2MasterMessage(m_deviceId, *response);
-
-                    elog_v("SlaveDevice", "Sending response:");
-
-                    // Send all fragments to master
-                    for (auto &fragment : responseData)
+                    if (m_isCollecting)
+                    {
+                        // 采集期间响应排队到本设备的激活时隙发送，避免与其他从机的时隙冲撞
+                        const bool telemetry = response->getMessageId() ==
+                                               static_cast<uint8_t>(Slave2MasterMessageId::PING_RSP_MSG);
+                        QueueMessage(telemetry ? TxPriority::TELEMETRY : TxPriority::CONTROL, std::move(response));
+                    }
+                    else
                     {
-                        if (send(fragment) != 0)
+                        elog_v("SlaveDevice", "Packing Slave2Master message: %s", response->getMessageTypeName());
+                        stampPingResponse(*response);
+                        const int result = sendMessage(*response);
+                        if (result == -4)
+                        {
+                            elog_w("SlaveDevice", "Tx busy, %s dropped", response->getMessageTypeName());
+                        }
+                        else if (result != 0)
                         {
-                            elog_e("SlaveDevice", "Failed to send response fragment");
+                            elog_e("SlaveDevice", "Failed to send response");
                         }
                     }
                 }
@@ -674,6 +1104,11 @@ void SlaveDevice::printSystemStackInfo() const
     elog_i(TAG, "Free Heap: %lu bytes", (unsigned long)freeHeapSize);
     elog_i(TAG, "Min Ever Free: %lu bytes", (unsigned long)minEverFreeHeapSize);
     elog_i(TAG, "Usage: %lu%%", (unsigned long)usagePercent);
+
+    const auto &reassemblyStats = m_decoder.getReassemblyStats();
+    elog_i(TAG, "Reassembly: completed %lu, expired %lu, evicted %lu", (unsigned long)reassemblyStats.completed,
+           (unsigned long)reassemblyStats.expired, (unsigned long)reassemblyStats.evicted);
+    elog_i(TAG, "RX allocations: %lu", (unsigned long)m_rxAllocCount);
     elog_i(TAG, "=============================");
 }
 
@@ -691,6 +1126,9 @@ void SlaveDevice::DataCollectionTask::task()
 
     for (;;)
     {
+        // 处理主机请求的稳定时间标定
+        processSettleCalibration();
+
         // 处理数据采集状态
         processDataCollection();
 
@@ -712,7 +1150,10 @@ void SlaveDevice::DataCollectionTask::task()
 
             wasSlotManagerRunning = isCurrentlyRunning;
 
+            // 时隙回调访问发送状态，接收任务重新配置时通过该锁等待回调结束
+            parent.m_slotMutex.take();
             parent.m_slotManager->Process();
+            parent.m_slotMutex.give();
         }
 
         // 减少轮询间隔以提高时隙切换精度
@@ -720,6 +1161,30 @@ void SlaveDevice::DataCollectionTask::task()
     }
 }
 
+void SlaveDevice::DataCollectionTask::processSettleCalibration() const
+{
+    if (!parent.m_settleCalibrationRequested.exchange(false, std::memory_order_relaxed))
+    {
+        return;
+    }
+
+    // 标定驱动采集引脚，采集中或即将开始采集时会干扰本机和其他从机的采集
+    if (parent.m_isCollecting || parent.m_isScheduledToStart || !parent.m_continuityCollector)
+    {
+        elog_w(TAG, "Settle calibration ignored while collection is active or scheduled");
+        return;
+    }
+
+#if ENABLE_SETTLE_CALIBRATION
+    // 持有时隙锁，接收任务重新配置采集器前等待标定结束
+    parent.m_slotMutex.take();
+    parent.m_continuityCollector->CalibrateSettleTime();
+    parent.m_slotMutex.give();
+#else
+    elog_w(TAG, "Settle calibration disabled");
+#endif
+}
+
 void SlaveDevice::DataCollectionTask::processDataCollection() const
 {
     // 检查是否有计划启动的采集
@@ -756,7 +1221,7 @@ void SlaveDevice::DataCollectionTask::processDataCollection() const
 
             // 启动采集和时隙管理器
             if (collectorReady && parent.m_continuityCollector && parent.m_slotManager &&
-                parent.m_continuityCollector->StartCollection() && parent.m_slotManager->Start())
+                parent.m_continuityCollector->StartCollection() && parent.StartSlotManager())
             {
                 parent.m_isCollecting = true;
                 uwb_ltlp_set_conducting_state(true); // 更新全局导通检测状态标志
@@ -790,137 +1255,245 @@ void SlaveDevice::DataCollectionTask::sendDataToBackend() const
         return;
     }
 
-    // 如果正在进行分片发送，发送下一个分片
+    // 上一组分片仍在发送队列中（跨时隙续发），新数据等待其发完或过期
     if (parent.m_isFragmentSendingInProgress)
     {
-        // 检查是否还有待发送的分片
-        if (parent.m_currentFragmentIndex < parent.m_pendingFragments.size())
-        {
-            // 发送当前分片（只输出关键信息：第几包）
-            const auto &fragment = parent.m_pendingFragments[parent.m_currentFragmentIndex];
-            elog_i(TAG, "tx frag %d/%d", parent.m_currentFragmentIndex + 1, parent.m_pendingFragments.size());
+        return;
+    }
 
-            if (parent.send(fragment) == 0)
-            {
-                parent.m_currentFragmentIndex++;
+    // 如果还没有开始分片发送，检查是否有缓存的数据可发送（边采集边发送时本周期已有采集的行即可开始）
+    const bool live = !parent.m_hasDataToSend;
+    if (live ? parent.m_streamedBytes == 0 : parent.lastCollectionData.empty())
+    {
+        return;
+    }
 
-                // 检查是否所有分片都已发送完成
-                if (parent.m_currentFragmentIndex >= parent.m_pendingFragments.size())
-                {
-                    elog_i(TAG, "tx complete (%d frags)", parent.m_pendingFragments.size());
+    // 上一周期的分片仍在等待重传时，新数据优先，丢弃未完成的重传请求
+    parent.retainSentFragments();
 
-                    // 清空分片发送状态
-                    parent.m_pendingFragments.clear();
-                    parent.m_currentFragmentIndex = 0;
-                    parent.m_isFragmentSendingInProgress = false;
+    // 分片不预先打包，每个时隙由游标直接生成到发送缓冲区，内存占用与导通矩阵大小无关
+    parent.m_hasDataToSend = false;
+    auto messageId = Slave2MasterMessageId::COND_DATA_MSG;
+    const uint8_t *data = nullptr;
+    size_t length = 0;
+    if (live)
+    {
+        // 本周期仍在采集（边采集边发送），游标直接引用采集器的数据矩阵，周期结束时才复制
+        const auto &packedData = parent.m_continuityCollector->GetPackedData();
+        data = packedData.data();
+        length = packedData.size();
+    }
+    else
+    {
+        // 采集数据移入发送缓冲区（交换不复制），采集任务可继续写入 lastCollectionData
+        parent.m_sendingData.swap(parent.lastCollectionData);
+#if ENABLE_CONDUCTION_ENCODING
+        parent.encodeSendingData();
+        messageId = Slave2MasterMessageId::COND_DATA_ENC_MSG;
+#endif
+        data = parent.m_sendingData.data();
+        length = parent.m_sendingData.size();
+    }
+    auto &cursor = parent.m_fragmentCursor;
+    elog_i(TAG, "data: %d bytes", length);
 
-                    // 清空缓存数据和标志
-                    parent.lastCollectionData.clear();
-                    parent.m_hasDataToSend = false;
-                }
-            }
-            else
-            {
-                elog_e(TAG, "tx frag %d/%d failed", parent.m_currentFragmentIndex + 1,
-                       parent.m_pendingFragments.size());
-                // 发送失败，保持状态，下次时隙重试
-            }
-        }
-        else
+    bool ready = false;
+#if ENABLE_SHORT_ID_ADDRESSING
+    // 已分配短ID时使用紧凑帧头，后续分片只携带短ID和分片偏移
+    if (parent.m_shortId != 0)
+    {
+        ready = parent.m_encoder.beginCompactConductionFragments(cursor, parent.m_shortId, parent.m_deviceStatus,
+                                                                 data, length, messageId);
+        if (!ready)
         {
-            // 所有分片已发送完成，但状态未正确更新，重置状态
-            parent.m_pendingFragments.clear();
-            parent.m_currentFragmentIndex = 0;
-            parent.m_isFragmentSendingInProgress = false;
-            parent.lastCollectionData.clear();
-            parent.m_hasDataToSend = false;
+            elog_w(TAG, "compact framing unavailable for %d bytes, using standard frames", length);
         }
-        return;
     }
+#endif
+    if (!ready)
+    {
+        // 按同步消息配置在数据分片之后追加校验分片，主机可据此恢复丢失的分片
+        ready = parent.m_encoder.beginConductionFragments(cursor, parent.m_deviceId, parent.m_deviceStatus, data,
+                                                          length, parent.currentConfig.parityCount, messageId);
 
-    // 如果还没有开始分片发送，检查是否有缓存的数据可发送
-    if (!parent.m_hasDataToSend || parent.lastCollectionData.empty())
+        // 校验分片只使用空闲的激活时隙
+        const uint8_t testCount = parent.currentConfig.testCount;
+        if (ready && cursor.parityFragments > 0 && cursor.fragmentCount() > testCount)
+        {
+            const uint8_t spareSlots = testCount > cursor.dataFragments ? testCount - cursor.dataFragments : 0;
+            ready = parent.m_encoder.beginConductionFragments(cursor, parent.m_deviceId, parent.m_deviceStatus,
+                                                              data, length, spareSlots, messageId);
+        }
+    }
+    if (!ready)
     {
+        elog_e(TAG, "cannot fragment %d bytes", length);
+        parent.m_sendingData.clear();
+        parent.lastCollectionData.clear();
+        parent.m_streamedBytes = 0;
         return;
     }
 
-    // 根据当前配置创建相应的数据消息
-    // 这里假设是导通检测模式，实际应该根据配置的模式来决定
-    auto dataMsg = std::make_unique<Slave2Master::ConductionDataMessage>();
+    // 每组分片使用新的周期号，主机的NACK回传该周期号
+    cursor.cycle = parent.m_fragmentCycle;
+    parent.m_fragmentCycle = (parent.m_fragmentCycle + 1) & (FRAME_CYCLE_MASK >> FRAME_CYCLE_SHIFT);
 
-    // 使用缓存的数据
-    dataMsg->conductionData = parent.lastCollectionData;
+    parent.m_currentFragmentIndex = 0;
+    parent.m_isFragmentSendingInProgress = true;
+    parent.m_streamLive = live;
+    parent.m_queuedFragments = 0;
 
-    if (dataMsg->conductionData.size() > 0)
+    const size_t fragmentCount = cursor.fragmentCount();
+    elog_i(TAG, "%d frags (%d parity)", fragmentCount, cursor.parityFragments);
+    if (fragmentCount > parent.currentConfig.testCount)
     {
-        elog_i(TAG, "data: %d bytes", dataMsg->conductionData.size());
+        elog_w(TAG, "frags(%d) > slots(%d)!", fragmentCount, parent.currentConfig.testCount);
+    }
 
-        // Use protocol processor to pack message in Slave2Master format (auto-fragmentation)
-        // COND_DATA_MSG 需要 DeviceStatus，使用带 DeviceStatus 的打包函数
-        // elog_i(TAG,
-        //        "Preparing to pack COND_DATA_MSG - DeviceId: 0x%08X, DeviceStatus: 0x%04X, ConductionDataSize: %d
-        //        bytes", parent.m_deviceId, parent.m_deviceStatus.toUint16(), dataMsg->conductionData.size());
-        const auto packedData =
-            parent.m_processor.packSlave2MasterMessage(parent.m_deviceId, parent.m_deviceStatus, *dataMsg);
+    // 数据已就绪的分片进入发送队列，仍在采集的周期在后续时隙追加
+    parent.queueReadyFragments();
+}
+
+int SlaveDevice::send(const std::vector<uint8_t> &frame)
+{
+    if (!m_masterComm.WaitTxSpace(TX_SPACE_WAIT_MS))
+    {
+        return -4;
+    }
+    return m_masterComm.SendData(frame.data(), frame.size(), 0);
+}
+
+size_t SlaveDevice::sendFragment(const ConductionFragmentCursor &cursor, const size_t index, const size_t limit)
+{
+    // 分片直接生成到MasterComm发送缓冲区，不保留打包好的分片
+    uint16_t length = 0;
+    const int result = m_masterComm.SendInPlace([&](uint8_t *buffer, uint16_t capacity) {
+        const size_t frameLimit = std::min<size_t>(capacity, limit);
+        length = static_cast<uint16_t>(m_encoder.packConductionFragmentInto(cursor, index, buffer, frameLimit));
+        return length;
+    });
+    return result == 0 ? length : 0;
+}
+
+int SlaveDevice::sendMessage(const Message &message)
+{
+    // 直接发送（不经过发送队列），发送环形缓冲区已满时等待空位
+    if (!m_masterComm.WaitTxSpace(TX_SPACE_WAIT_MS))
+    {
+        return -4;
+    }
 
-        // Calculate statistics
-        size_t totalFrameBytes = 0;         // Total bytes of all frames (including frame headers)
-        size_t totalPayloadBytes = 0;       // Total bytes of all payloads
-        const size_t FRAME_HEADER_SIZE = 7; // Frame header size: 7 bytes
+    // 单帧消息直接打包进MasterComm发送缓冲区，避免中间vector拷贝
+    const int result = m_masterComm.SendInPlace(
+        [this, &message](uint8_t *buffer, uint16_t capacity) {
+            const size_t limit = std::min<size_t>(capacity, m_encoder.getMTU());
+            return static_cast<uint16_t>(m_encoder.packSlave2MasterMessageInto(m_deviceId, message, buffer, limit));
+        },
+        txStampTag(message));
+    if (result != -3)
+    {
+        return result;
+    }
 
-        for (const auto &fragment : packedData)
+    // 超过MTU，回退到分片打包并逐片发送，缓冲区已满时等待空位
+    for (const auto &fragment : m_encoder.packSlave2MasterMessage(m_deviceId, message))
+    {
+        if (const int ret = send(fragment); ret != 0)
         {
-            totalFrameBytes += fragment.size();
-            // Payload of each fragment = total size - frame header size
-            if (fragment.size() >= FRAME_HEADER_SIZE)
+            return ret;
+        }
+    }
+    return 0;
+}
+
+size_t SlaveDevice::sendMessageBatch(const Message *const *messages, const size_t count, const size_t limit,
+                                     size_t &packed)
+{
+    // 尽可能多的消息首尾相接打包进MasterComm发送缓冲区，一次UWB发送
+    packed = 0;
+    uint16_t length = 0;
+    uint32_t stampTag = MasterComm::TX_STAMP_NONE;
+    const int result = m_masterComm.SendInPlace(
+        [&](uint8_t *buffer, uint16_t capacity) {
+            const size_t frameLimit = std::min({static_cast<size_t>(capacity), m_encoder.getMTU(), limit});
+            length = static_cast<uint16_t>(
+                m_encoder.packSlave2MasterBatchInto(m_deviceId, messages, count, buffer, frameLimit, packed));
+            // 只有实际打包进本帧的Ping响应才按本帧的发送时间记录T3
+            for (size_t i = 0; i < packed && stampTag == MasterComm::TX_STAMP_NONE; ++i)
             {
-                totalPayloadBytes += (fragment.size() - FRAME_HEADER_SIZE);
+                stampTag = txStampTag(*messages[i]);
             }
-        }
+            return length;
+        },
+        stampTag);
+    if (result != 0)
+    {
+        packed = 0;
+        return 0;
+    }
+    return length;
+}
 
-        // 保存所有分片，准备跨时隙发送
-        parent.m_pendingFragments = packedData;
-        parent.m_currentFragmentIndex = 0;
-        parent.m_isFragmentSendingInProgress = true;
+void SlaveDevice::BeginPingExchange(const uint16_t sequence, const uint32_t originUs, const uint32_t receiveUs)
+{
+    m_pingSequence = sequence;
+    m_pingOriginUs = originUs;
+    m_pingReceiveUs = receiveUs;
+    m_pingPending = true;
+}
 
-        elog_i(TAG, "%d frags", packedData.size());
-        if (packedData.size() > parent.currentConfig.testCount)
-        {
-            elog_w(TAG, "frags(%d) > slots(%d)!", packedData.size(), parent.currentConfig.testCount);
-        }
+void SlaveDevice::CompletePingExchange(const uint16_t sequence, const uint32_t masterReceiveUs)
+{
+    // T3为响应帧交给UWB发送的时间，与T2在接收任务取数据时记录对称
+    uint32_t transmitUs = 0;
+    if (!m_pingPending || sequence != m_pingSequence || !m_masterComm.GetTxStamp(sequence, transmitUs))
+    {
+        return; // 不是最近一次Ping，或响应尚未发出
+    }
+    m_pingPending = false;
 
-        // 发送第一个分片
-        if (!parent.m_pendingFragments.empty())
-        {
-            const auto &firstFragment = parent.m_pendingFragments[0];
-            elog_i(TAG, "tx frag 1/%d", parent.m_pendingFragments.size());
+    // 往返时延 = (T4 - T1) - (T3 - T2)，两段差值各自在同一时钟内计算，32位回绕不影响结果
+    const int32_t roundTripUs = static_cast<int32_t>(masterReceiveUs - m_pingOriginUs) -
+                                static_cast<int32_t>(transmitUs - m_pingReceiveUs);
+    if (roundTripUs < 0)
+    {
+        elog_w(TAG, "ping %d: negative round trip %ld us, ignored", sequence, static_cast<long>(roundTripUs));
+        return;
+    }
 
-            if (parent.send(firstFragment) == 0)
-            {
-                parent.m_currentFragmentIndex = 1; // 下一个要发送的分片索引
+    m_pathDelaySamples[m_pathDelayNext] = static_cast<uint32_t>(roundTripUs);
+    m_pathDelayNext = (m_pathDelayNext + 1) % PING_DELAY_WINDOW;
+    if (m_pathDelayCount < PING_DELAY_WINDOW)
+    {
+        m_pathDelayCount++;
+    }
+    const uint32_t minRoundTripUs = *std::min_element(m_pathDelaySamples, m_pathDelaySamples + m_pathDelayCount);
+    m_oneWayDelayUs.store(minRoundTripUs / 2, std::memory_order_relaxed);
 
-                // 如果只有一个分片，立即完成
-                if (parent.m_currentFragmentIndex >= parent.m_pendingFragments.size())
-                {
-                    elog_i(TAG, "tx complete (1 frag)");
-                    parent.m_pendingFragments.clear();
-                    parent.m_currentFragmentIndex = 0;
-                    parent.m_isFragmentSendingInProgress = false;
-                    parent.lastCollectionData.clear();
-                    parent.m_hasDataToSend = false;
-                }
-            }
-            else
-            {
-                elog_e(TAG, "tx frag 1/%d failed", parent.m_pendingFragments.size());
-            }
-        }
+    // 时间偏移量只由同步消息加单向时延补偿设置，Ping只提供时延估计
+    elog_d(TAG, "ping %d: rtt %ld us, one-way %lu us", sequence, static_cast<long>(roundTripUs),
+           static_cast<unsigned long>(minRoundTripUs / 2));
+}
+
+void SlaveDevice::stampPingResponse(Message &message)
+{
+    if (message.getMessageId() != static_cast<uint8_t>(Slave2MasterMessageId::PING_RSP_MSG))
+    {
+        return;
     }
+
+    auto &response = static_cast<Slave2Master::PingRspMessage &>(message);
+    response.timestamp = HptimerGetUs();
 }
 
-int SlaveDevice::send(const std::vector<uint8_t> &frame)
+uint32_t SlaveDevice::txStampTag(const Message &message) const
 {
-    return m_masterComm.SendData(frame.data(), frame.size(), 0);
+    if (message.getMessageId() != static_cast<uint8_t>(Slave2MasterMessageId::PING_RSP_MSG))
+    {
+        return MasterComm::TX_STAMP_NONE;
+    }
+    const auto &response = static_cast<const Slave2Master::PingRspMessage &>(message);
+    return response.sequenceNumber == m_pingSequence ? response.sequenceNumber : MasterComm::TX_STAMP_NONE;
 }
 
 // SlaveDataProcT 实现
@@ -941,22 +1514,21 @@ void SlaveDevice::SlaveDataProcT::task()
         if (parent.m_masterComm.ReceiveData(msg.get(), 0) == 0)
         {
             elog_v(TAG, "SlaveDataProcT recvData size: %d", msg->dataLen);
-            // copy msg.data to recvData
-            recvData.assign(msg->data, msg->data + msg->dataLen);
-
-            if (!recvData.empty())
+            if (msg->dataLen > 0)
             {
-                // process recvData
-                elog_v(TAG, "recvData size: %d", recvData.size());
-                parent.m_processor.processReceivedData(recvData);
+                // 直接写入协议处理器的接收环形缓冲区，不再经过中间vector
+                // 本次数据中完成的帧使用驱动接收时间（Ping的T2、同步的本地时间）
+                parent.m_rxTimestampUs = msg->timestampUs;
+
+                const uint32_t allocCount = FreertosNewGetAllocCount();
+                parent.m_decoder.processReceivedData(msg->data, msg->dataLen);
+                parent.m_rxAllocCount += FreertosNewGetAllocCount() - allocCount;
 
                 // process complete frame
-                Frame receivedFrame;
-                while (parent.m_processor.getNextCompleteFrame(receivedFrame))
+                while (parent.m_decoder.getNextCompleteFrame(receivedFrame))
                 {
                     parent.processFrame(receivedFrame);
                 }
-                recvData.clear();
             }
         }
         TaskBase::delay(1);
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <atomic>
 #include <memory>
 
 #include "LockController.h"
@@ -15,6 +16,7 @@
 #include "MutexCPP.h"
 #include "slave_device_state.h"
 #include "slot_manager.h"
+#include "tx_queue.h"
 
 namespace SlaveApp
 {
@@ -34,8 +36,10 @@ struct SlaveDeviceConfig
     uint8_t interval;    // 采集间隔（ms）
     uint8_t timeSlot;    // 分配的时隙
     uint8_t testCount;   // 检测数量
+    uint8_t parityCount; // 导通数据校验分片数（0表示不发送）
 
-    SlaveDeviceConfig() : mode(CollectionMode::CONDUCTION), interval(100), timeSlot(0), testCount(2)
+    SlaveDeviceConfig()
+        : mode(CollectionMode::CONDUCTION), interval(100), timeSlot(0), testCount(2), parityCount(0)
     {
     }
 };
@@ -54,12 +58,27 @@ class SlaveDevice
     bool m_isJoined;                 // 是否已入网
     bool m_isConfigured;             // 是否已配置
     SlaveDeviceConfig currentConfig; // 当前配置
+    uint16_t m_startSlot;            // 本从机的起始时隙
+    uint16_t m_syncEpoch;            // 最近应用的紧凑同步配置版本
+    bool m_hasSyncEpoch;             // m_syncEpoch是否有效（收到完整SyncMessage后失效）
     SlaveDeviceState m_deviceState;  // 设备状态
 
     // 时间同步相关
     int64_t m_timeOffset; // 与主机时间的偏移量(us)
     bool m_isCollecting;  // 是否正在采集数据
 
+    // 四时间戳Ping（T2、T3为本地HptimerGetUs时间），由下一次请求带回的T4完成一次测量
+    static constexpr size_t PING_DELAY_WINDOW = 8; // 取最近若干次往返时延的最小值，排除排队造成的抖动
+    uint32_t m_rxTimestampUs;                      // 正在处理的接收数据的驱动接收时间
+    uint16_t m_pingSequence;                       // 未完成的Ping序号
+    uint32_t m_pingOriginUs;                       // T1：主机发送时间
+    uint32_t m_pingReceiveUs;                      // T2：本地接收时间
+    bool m_pingPending;                            // 未完成的Ping尚未用T4完成测量（T3由MasterComm在发送时记录）
+    uint32_t m_pathDelaySamples[PING_DELAY_WINDOW]; // 最近的往返时延(us)
+    uint8_t m_pathDelayCount;                       // 有效的往返时延样本数
+    uint8_t m_pathDelayNext;                        // 下一个写入位置
+    std::atomic<uint32_t> m_oneWayDelayUs;          // 单向时延估计(us)，同步时补偿到时间偏移量
+
     // 心跳相关
     uint64_t m_lastSyncMessageTime;                                // 上次收到sync消息的时间戳(us)
     uint64_t m_lastHeartbeatTime;                                  // 上次发送心跳的时间戳(us)
@@ -77,21 +96,52 @@ class SlaveDevice
     bool m_hasDataToSend;                    // 是否有数据待发送
     bool m_isFirstCollection;                // 是否是第一次采集
 
-    // 分片发送相关（用于跨时隙分包发送）
-    std::vector<std::vector<uint8_t>> m_pendingFragments; // 待发送的分片数据
-    size_t m_currentFragmentIndex;                        // 当前发送到第几个分片（0-based）
-    bool m_isFragmentSendingInProgress;                   // 是否正在进行分片发送
-
-    // 待回复消息管理（避免数据冲撞）
-    bool m_hasPendingSlaveControlResponse;                                // 是否有待回复的SlaveControl消息
-    bool m_hasPendingResetResponse;                                       // 是否有待回复的Reset消息
-    std::unique_ptr<WhtsProtocol::Message> m_pendingSlaveControlResponse; // 待回复的SlaveControl响应
-    std::unique_ptr<WhtsProtocol::Message> m_pendingResetResponse;        // 待回复的Reset响应
+    // 分片发送相关（用于跨时隙分包发送，分片在发送时由游标按需生成）
+    // 本组和下面边采集边发送的状态只在时隙回调中访问（数据采集任务，持有m_slotMutex）；
+    // 接收任务重新配置时先调用StopSlotManager，开始采集时由StartSlotManager复位
+    std::vector<uint8_t> m_sendingData;                      // 正在分片发送的采集数据
+    WhtsProtocol::ConductionFragmentCursor m_fragmentCursor; // 当前发送数据的分片划分
+    size_t m_currentFragmentIndex;                           // 当前发送到第几个分片（0-based）
+    bool m_isFragmentSendingInProgress;                      // 是否正在进行分片发送
+
+    // 边采集边发送（ENABLE_ROW_STREAMING）
+    size_t m_streamedBytes;   // 本周期采集器已完整写入、可以发送的字节数
+    size_t m_queuedFragments; // 当前游标已进入发送队列的分片数
+    bool m_streamLive;        // 游标直接引用采集器中仍在采集的本周期数据矩阵，周期结束时复制到 m_sendingData
+
+    // 导通数据编码相关（ENABLE_CONDUCTION_ENCODING）
+    std::vector<uint8_t> m_previousRawData;                       // 上一周期的原始数据，作为异或参考
+    std::vector<uint8_t> m_codecScratch;                          // 编码用的临时buffer
+    WhtsProtocol::Slave2Master::EncodedConductionDataMessage m_encodedMessage; // 复用的编码消息
+    uint8_t m_conductionSequence;                                 // 导通数据周期序号
+
+    // 分片重传相关（主机通过FragmentNack请求重发丢失的分片）
+    std::vector<uint8_t> m_retainedData;                      // 最近一次发送完成的采集数据，供选择性重传
+    WhtsProtocol::ConductionFragmentCursor m_retainedCursor;  // 保留数据的分片划分
+    std::atomic<uint16_t> m_retainedFragmentTag;              // 保留分片的周期号<<8 | 分片数（接收任务校验NACK时读取）
+    uint8_t m_fragmentCycle;                                  // 下一组分片的周期号
+    std::atomic<uint32_t> m_fragmentNackBitmap;               // 待重传的分片位图，bit i 对应分片 i
+    bool m_hasUnretainedFragments;                            // 已发送完成但因重传未完成而暂未保留的数据
+
+    std::atomic<bool> m_settleCalibrationRequested; // 主机请求标定稳定时间，由数据采集任务在未采集时执行
+
+    // 发送队列（采集期间的响应和分片只在本设备的激活时隙按预算发送，避免数据冲撞）
+    TxQueue m_txQueue;         // 按优先级排队的待发送消息和分片
+    uint32_t m_txExpiredCount; // 超过截止时间被丢弃的条目数
+
+    // 链路规划（按实测发送耗时和时隙长度选择分片帧长和每时隙分片数）
+    WhtsProtocol::LinkPlan m_linkPlan; // 当前使用的计划，无效时使用固定MTU和TX_SLOT_BYTE_BUDGET
+    uint32_t m_linkPlanSamples;        // 规划时的累计耗时样本数
+    uint8_t m_linkPlanInterval;        // 规划时的时隙间隔（ms）
+    size_t m_linkPlanOverhead;         // 规划时的分片开销（字节）
 
     // 设备状态，供外部读取和内部更新
     WhtsProtocol::DeviceStatus m_deviceStatus;
 
-    WhtsProtocol::ProtocolProcessor m_processor;
+    // 编码器由DataCollectionTask等发送方使用，解码器只由SlaveDataProcT使用，两者不共享buffer
+    WhtsProtocol::ProtocolEncoder m_encoder;
+    WhtsProtocol::ProtocolDecoder m_decoder;
+    uint32_t m_rxAllocCount = 0; // 接收解析路径上发生的堆分配次数，稳定运行时应保持不变
 
     std::unique_ptr<ContinuityCollector> m_continuityCollector;
     std::unique_ptr<SlotManager> m_slotManager;
@@ -113,16 +163,64 @@ class SlaveDevice
     void processFrame(const WhtsProtocol::Frame &frame);
 
     /**
-     * 发送数据
+     * 发送数据，发送环形缓冲区已满时最多等待TX_SPACE_WAIT_MS
      * @param frame 要发送的数据帧
-     * @return 是否发送成功
+     * @return 0表示发送成功，-4表示发送缓冲区一直没有空位
      */
     int send(const std::vector<uint8_t> &frame);
 
     /**
-     * 发送待回复的响应消息（在时隙中发送以避免冲撞）
+     * 发送导通数据的第index个分片（由游标直接生成到发送缓冲区）
+     * @param cursor 分片游标
+     * @param index 分片序号
+     * @param limit 帧长度上限（本时隙剩余的字节预算）
+     * @return 发送的帧长度，超出上限或发送失败时返回0
+     */
+    size_t sendFragment(const WhtsProtocol::ConductionFragmentCursor &cursor, size_t index, size_t limit);
+
+    /**
+     * 打包并发送Slave2Master消息
+     * 单帧消息直接打包进MasterComm发送缓冲区，超过MTU时回退到分片发送
+     * 发送环形缓冲区已满时等待UWB任务取走帧（会阻塞，不能在时隙回调中调用）
+     * @param message 要发送的消息
+     * @return 0表示发送成功，-4表示等待发送缓冲区空位超时
+     */
+    int sendMessage(const WhtsProtocol::Message &message);
+
+    /**
+     * 批量发送Slave2Master消息
+     * 按顺序将尽可能多的单帧消息合并进同一个UWB载荷（不超过MTU和limit）
+     * @param messages 要发送的消息
+     * @param count 消息个数
+     * @param limit 帧长度上限（本时隙剩余的字节预算）
+     * @param packed 返回已打包发送的消息数
+     * @return 发送的帧长度，未发送时返回0
+     */
+    size_t sendMessageBatch(const WhtsProtocol::Message *const *messages, size_t count, size_t limit,
+                            size_t &packed);
+
+    /**
+     * 消息加入发送队列，在本设备的激活时隙发送，截止时间按优先级配置
+     * @return 队列满时返回false
      */
-    void sendPendingResponses();
+    bool QueueMessage(TxPriority priority, std::unique_ptr<WhtsProtocol::Message> message);
+
+    /**
+     * 从发送队列中移除当前导通数据的分片（分片划分失效时调用）
+     */
+    void ClearQueuedFragments();
+
+    /**
+     * 停止时隙管理器，返回时正在执行的时隙回调已经结束（重新配置前调用）
+     * 之后可以安全地清除发送状态、重新配置采集器
+     */
+    void StopSlotManager();
+
+    /**
+     * 复位本周期的复制进度并启动时隙管理器（开始采集时调用，与时隙回调互斥）
+     * @return 时隙管理器启动成功返回true
+     */
+    bool StartSlotManager();
 
     // 心跳包功能已关闭
     // /**
@@ -168,6 +266,26 @@ class SlaveDevice
      */
     void setShortId(uint8_t id);
 
+    /**
+     * 请求重传最近一次发送的分片（由FragmentNack处理器调用）
+     * @param cycle 分片帧头中的周期号，必须与保留分片的周期号一致
+     * @param fragmentCount 主机看到的分片总数，必须与保留的分片数一致
+     * @param missingBitmap 丢失分片位图，bit i 对应分片 i
+     * @return 请求有效并已排队返回true
+     */
+    bool RequestFragmentRetransmit(uint8_t cycle, uint8_t fragmentCount, uint32_t missingBitmap);
+
+    /**
+     * 丢弃保留的分片和待重传请求（配置变化时调用）
+     */
+    void ClearRetainedFragments();
+
+    /**
+     * 请求标定采集稳定时间（由SettleCalibrate处理器调用）
+     * 数据采集任务在未采集且未计划启动时执行标定，正在采集时忽略请求
+     */
+    void RequestSettleCalibration();
+
     /**
      * 获取当前时间戳
      * @return 当前时间戳（微秒）
@@ -192,6 +310,26 @@ class SlaveDevice
      */
     [[nodiscard]] uint32_t GetSyncTimestampMs() const;
 
+    /**
+     * 记录一次Ping请求（T1为主机发送时间，T2为本地接收时间），T3由MasterComm在响应帧发送前记录
+     */
+    void BeginPingExchange(uint16_t sequence, uint32_t originUs, uint32_t receiveUs);
+
+    /**
+     * 用主机带回的T4完成上一次Ping，更新往返时延和单向时延估计
+     * @param sequence 上一次Ping的序号
+     * @param masterReceiveUs T4：主机收到响应的时间
+     */
+    void CompletePingExchange(uint16_t sequence, uint32_t masterReceiveUs);
+
+    /**
+     * 单向时延估计（微秒），尚无Ping测量时为0
+     */
+    [[nodiscard]] uint32_t GetOneWayDelayUs() const
+    {
+        return m_oneWayDelayUs.load(std::memory_order_relaxed);
+    }
+
     /**
      * 重置设备状态
      */
@@ -228,6 +366,7 @@ class SlaveDevice
         SlaveDevice &parent;
         void task() override;
         void processDataCollection() const;
+        void processSettleCalibration() const;
         static constexpr const char TAG[] = "DataCollectionTask";
         static constexpr uint32_t PROCESS_INTERVAL_MS = 10; // 采集处理间隔
     };
@@ -238,8 +377,8 @@ class SlaveDevice
         explicit SlaveDataProcT(SlaveDevice &parent);
 
       private:
-        std::vector<uint8_t> recvData;
         SlaveDevice &parent;
+        WhtsProtocol::Frame receivedFrame; // 复用的接收帧，载荷容量在帧之间保留
         void task() override;
         static constexpr const char TAG[] = "SlaveDataProcT";
     };
@@ -299,10 +438,89 @@ class SlaveDevice
     // 时间偏移量互斥锁，保护 m_timeOffset 的并发访问
     mutable FreeRTOScpp::Mutex m_timeOffsetMutex;
 
+    // 发送队列互斥锁，接收任务入队响应，时隙回调出队发送
+    FreeRTOScpp::Mutex m_txQueueMutex;
+
+    // 时隙处理互斥锁，数据采集任务在时隙管理器处理（含时隙回调）期间持有
+    FreeRTOScpp::Mutex m_slotMutex;
+
     /**
      * 打印系统剩余堆栈信息（私有方法）
      */
     void printSystemStackInfo() const;
+
+    /**
+     * 将 m_sendingData 中的原始导通数据改写为编码消息体，原始数据保留为下一周期的异或参考
+     */
+    void encodeSendingData();
+
+    /**
+     * 更新采集器中本周期已完整写入的字节数，周期结束时将数据矩阵复制一次
+     * （发送中时复制到 m_sendingData 并改写游标，否则复制到 lastCollectionData 等待发送）并清空采集器
+     */
+    void appendCollectedRows();
+
+    /**
+     * 当前游标中数据已就绪、尚未入队的分片进入发送队列
+     */
+    void queueReadyFragments();
+
+    /**
+     * 当前周期的分片全部发送完成，清除发送状态并保留分片供重传
+     */
+    void finishFragmentSending();
+
+    /**
+     * 将已发送完成的分片转为保留分片（替换上一组保留分片）
+     */
+    void retainSentFragments();
+
+    /**
+     * 丢弃未发完的分片（超过截止时间），清除发送状态，不保留供重传
+     */
+    void abandonFragmentSending();
+
+    /**
+     * 按本时隙的字节和时间预算发送队列中的条目，放不下的留到下一个激活时隙
+     * @param slotInfo 当前激活时隙
+     */
+    void drainTxQueue(const SlotInfo &slotInfo);
+
+    /**
+     * 发送队列中最高优先级的下一帧（连续的消息条目合并为一帧），队列为空时重发主机请求的分片
+     * @param nowUs 当前本地时间，用于丢弃过期条目
+     * @param limit 帧长度上限（本时隙剩余的字节预算）
+     * @return 发送的帧长度，无可发送的帧或超出预算时返回0
+     */
+    size_t sendNextTxFrame(uint64_t nowUs, size_t limit);
+
+    /**
+     * 重发一个主机请求的分片（序号最小的丢失分片）
+     * @param limit 帧长度上限（本时隙剩余的字节预算）
+     * @return 发送的帧长度，无待重传分片或超出预算时返回0
+     */
+    size_t sendNackedFragment(size_t limit);
+
+    /**
+     * 导通数据分片的截止时间（TX_BULK_DEADLINE_CYCLES个采集周期后，下一周期第一个激活时隙之前）
+     */
+    uint64_t bulkDeadlineUs() const;
+
+    /**
+     * 时隙间隔、分片开销变化或新增足够的耗时样本后重新规划分片帧长和每时隙分片数，
+     * 计划变化时设置MTU并向主机上报LinkPlanMessage；只在没有分片发送时调用
+     */
+    void updateLinkPlan();
+
+    /**
+     * Ping响应在写入发送缓冲区前填写时间戳，使其不包含在发送队列中等待的时间
+     */
+    void stampPingResponse(WhtsProtocol::Message &message);
+
+    /**
+     * 发送帧的时间记录标记：当前Ping的响应以序号为标记，由MasterComm在发送时记录T3
+     */
+    [[nodiscard]] uint32_t txStampTag(const WhtsProtocol::Message &message) const;
 };
 
 } // namespace SlaveApp
\ No newline at end of file
@@ -0,0 +1,131 @@
+#include "tx_queue.h"
+
+#include <utility>
+
+namespace SlaveApp
+{
+
+TxQueue::TxQueue()
+{
+    for (auto &ring : m_rings)
+    {
+        ring.head = 0;
+        ring.count = 0;
+    }
+}
+
+bool TxQueue::PushMessage(const TxPriority priority, std::unique_ptr<WhtsProtocol::Message> message,
+                          const uint64_t deadlineUs)
+{
+    Ring &ring = m_rings[static_cast<size_t>(priority)];
+    if (!message || ring.count >= CAPACITY)
+    {
+        return false;
+    }
+
+    TxEntry &entry = ring.entries[(ring.head + ring.count) % CAPACITY];
+    entry.message = std::move(message);
+    entry.cursor = nullptr;
+    entry.nextFragment = 0;
+    entry.endFragment = 0;
+    entry.deadlineUs = deadlineUs;
+    ring.count++;
+    return true;
+}
+
+bool TxQueue::PushFragments(const WhtsProtocol::ConductionFragmentCursor &cursor, const size_t first,
+                            const size_t end, const uint64_t deadlineUs)
+{
+    Ring &ring = m_rings[static_cast<size_t>(TxPriority::BULK)];
+    if (first >= end || ring.count >= CAPACITY)
+    {
+        return false;
+    }
+
+    TxEntry &entry = ring.entries[(ring.head + ring.count) % CAPACITY];
+    entry.message.reset();
+    entry.cursor = &cursor;
+    entry.nextFragment = first;
+    entry.endFragment = end;
+    entry.deadlineUs = deadlineUs;
+    ring.count++;
+    return true;
+}
+
+TxEntry *TxQueue::Front(TxPriority &priority)
+{
+    for (size_t i = 0; i < PRIORITY_COUNT; ++i)
+    {
+        if (m_rings[i].count > 0)
+        {
+            priority = static_cast<TxPriority>(i);
+            return &m_rings[i].entries[m_rings[i].head];
+        }
+    }
+    return nullptr;
+}
+
+TxEntry *TxQueue::At(const TxPriority priority, const size_t index)
+{
+    Ring &ring = m_rings[static_cast<size_t>(priority)];
+    if (index >= ring.count)
+    {
+        return nullptr;
+    }
+    return &ring.entries[(ring.head + index) % CAPACITY];
+}
+
+void TxQueue::Pop(const TxPriority priority)
+{
+    Ring &ring = m_rings[static_cast<size_t>(priority)];
+    if (ring.count == 0)
+    {
+        return;
+    }
+
+    TxEntry &entry = ring.entries[ring.head];
+    entry.message.reset();
+    entry.cursor = nullptr;
+    ring.head = (ring.head + 1) % CAPACITY;
+    ring.count--;
+}
+
+void TxQueue::RemoveFragments(const WhtsProtocol::ConductionFragmentCursor *cursor)
+{
+    for (auto &ring : m_rings)
+    {
+        // 保留的条目按原顺序前移
+        size_t kept = 0;
+        for (size_t i = 0; i < ring.count; ++i)
+        {
+            TxEntry &entry = ring.entries[(ring.head + i) % CAPACITY];
+            if (entry.cursor == cursor)
+            {
+                entry.message.reset();
+                entry.cursor = nullptr;
+                continue;
+            }
+            if (kept != i)
+            {
+                ring.entries[(ring.head + kept) % CAPACITY] = std::move(entry);
+                entry.cursor = nullptr;
+            }
+            kept++;
+        }
+        ring.count = kept;
+    }
+}
+
+bool TxQueue::IsEmpty() const
+{
+    for (const auto &ring : m_rings)
+    {
+        if (ring.count > 0)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace SlaveApp
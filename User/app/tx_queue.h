@@ -0,0 +1,116 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+#include "WhtsProtocol.h"
+#include "config.h"
+
+namespace SlaveApp
+{
+
+/**
+ * 发送优先级，数值越小越先发送
+ */
+enum class TxPriority : uint8_t
+{
+    CONTROL = 0,   // 控制响应（复位响应、短ID确认等）
+    TELEMETRY = 1, // 遥测（Ping响应、心跳）
+    BULK = 2       // 批量数据（导通数据分片）
+};
+
+/**
+ * 发送队列条目：一个消息，或一个分片游标中 [nextFragment, endFragment) 的分片
+ */
+struct TxEntry
+{
+    std::unique_ptr<WhtsProtocol::Message> message;       // 消息条目，出队时释放
+    const WhtsProtocol::ConductionFragmentCursor *cursor; // 分片条目的游标（由发送方持有）
+    size_t nextFragment;                                  // 下一个待发送的分片序号
+    size_t endFragment;                                   // 分片结束序号（不含）
+    uint64_t deadlineUs;                                  // 截止时间（本地us），0表示不过期
+
+    TxEntry() : message(nullptr), cursor(nullptr), nextFragment(0), endFragment(0), deadlineUs(0)
+    {
+    }
+
+    bool IsFragments() const
+    {
+        return cursor != nullptr;
+    }
+
+    bool IsExpired(uint64_t nowUs) const
+    {
+        return deadlineUs != 0 && nowUs >= deadlineUs;
+    }
+};
+
+/**
+ * 有界优先级发送队列
+ * 每个优先级一个固定容量的FIFO环形队列，总是从最高优先级的队首发送。
+ * 队列本身不加锁，由SlaveDevice在接收任务和时隙回调之间加锁使用
+ */
+class TxQueue
+{
+  public:
+    static constexpr size_t PRIORITY_COUNT = 3;
+    static constexpr size_t CAPACITY = TX_QUEUE_CAPACITY; // 每个优先级的容量
+
+    TxQueue();
+
+    // 删除拷贝构造函数和赋值操作符
+    TxQueue(const TxQueue &) = delete;
+    TxQueue &operator=(const TxQueue &) = delete;
+
+    /**
+     * 消息入队，队列满时返回false（消息被释放）
+     */
+    bool PushMessage(TxPriority priority, std::unique_ptr<WhtsProtocol::Message> message, uint64_t deadlineUs);
+
+    /**
+     * 分片入队（BULK优先级），分片发送时由游标按序号生成
+     */
+    bool PushFragments(const WhtsProtocol::ConductionFragmentCursor &cursor, size_t first, size_t end,
+                       uint64_t deadlineUs);
+
+    /**
+     * 最高优先级的队首条目，队列为空时返回nullptr
+     * @param priority 返回该条目的优先级
+     */
+    TxEntry *Front(TxPriority &priority);
+
+    /**
+     * 某优先级中的第index个条目（0为队首），越界返回nullptr
+     */
+    TxEntry *At(TxPriority priority, size_t index);
+
+    /**
+     * 移除某优先级的队首条目
+     */
+    void Pop(TxPriority priority);
+
+    /**
+     * 移除引用该游标的所有分片条目（游标失效前调用）
+     */
+    void RemoveFragments(const WhtsProtocol::ConductionFragmentCursor *cursor);
+
+    size_t Size(TxPriority priority) const
+    {
+        return m_rings[static_cast<size_t>(priority)].count;
+    }
+
+    bool IsEmpty() const;
+
+  private:
+    struct Ring
+    {
+        TxEntry entries[CAPACITY];
+        size_t head;
+        size_t count;
+    };
+
+    Ring m_rings[PRIORITY_COUNT];
+};
+
+} // namespace SlaveApp
@@ -5,42 +5,18 @@
 
 #include "FreeRTOS.h"
 #include "elog.h"
+#include "hptimer.hpp"
 #include "task.h"
 
-// 端口时钟使能函数
-static void enableGpioPortClock(GPIO_TypeDef *port)
-{
-    if (port == GPIOA)
-        __HAL_RCC_GPIOA_CLK_ENABLE();
-    else if (port == GPIOB)
-        __HAL_RCC_GPIOB_CLK_ENABLE();
-    else if (port == GPIOC)
-        __HAL_RCC_GPIOC_CLK_ENABLE();
-    else if (port == GPIOD)
-        __HAL_RCC_GPIOD_CLK_ENABLE();
-    else if (port == GPIOE)
-        __HAL_RCC_GPIOE_CLK_ENABLE();
-    else if (port == GPIOF)
-        __HAL_RCC_GPIOF_CLK_ENABLE();
-    else if (port == GPIOG)
-        __HAL_RCC_GPIOG_CLK_ENABLE();
-}
-
-// 将逻辑引脚号转换为GPIO端口和引脚
-GpioPin CollectorConfig::GetGpioPin(uint8_t logicalPin)
-{
-    if (logicalPin < 64)
-    {
-        // 直接使用映射表中的GPIO信息
-        return GpioPin(HARDWARE_PIN_MAP[logicalPin].m_port, HARDWARE_PIN_MAP[logicalPin].m_pin);
-    }
+#if ENABLE_SHIFT_REGISTER_EXPANDER
+#include "shift_register_pin_driver.h"
+#include "spi.h"
+#include "spi_shift_register_bus.h"
+#endif
 
-    // 默认返回PA0
-    elog_e("CollectorConfig", "Invalid logical pin: %d", logicalPin);
-    return GpioPin(GPIOA, GPIO_PIN_0);
-}
-
-ContinuityCollector::ContinuityCollector() : m_status(CollectionStatus::IDLE), m_currentCycle(0), m_lastActivePin(-1)
+ContinuityCollector::ContinuityCollector()
+    : m_status(CollectionStatus::IDLE), m_currentCycle(0), m_settleUs(COLLECT_SETTLE_MAX_US),
+      m_pinDriver(&m_gpioDriver)
 {
     elog_v(TAG, "Constructor: config_.num: %d", m_config.m_num);
 }
@@ -48,7 +24,7 @@ ContinuityCollector::ContinuityCollector() : m_status(CollectionStatus::IDLE), m
 ContinuityCollector::~ContinuityCollector()
 {
     StopCollection();
-    DeinitializeGpioPins();
+    m_pinDriver->Deinitialize();
 }
 
 bool ContinuityCollector::Configure(const CollectorConfig &config)
@@ -57,7 +33,7 @@ bool ContinuityCollector::Configure(const CollectorConfig &config)
     //     return false;    // 不能在运行时重新配置
     // }
 
-    if (config.m_num == 0 || config.m_num > MAX_GPIO_PINS)
+    if (config.m_num == 0 || config.m_num > m_pinDriver->GetMaxPins())
     {
         return false;
     }
@@ -67,30 +43,32 @@ bool ContinuityCollector::Configure(const CollectorConfig &config)
         return false;
     }
 
+    // 引脚数变化说明线束已更换，之前的标定结果不再适用，恢复最长等待时间直到重新标定
+    if (config.m_num != m_config.m_num)
+    {
+        m_settleUs = COLLECT_SETTLE_MAX_US;
+    }
+
     m_config = config;
 
-    // 优化内存分配策略 - 预分配所有内存
+    // 预分配按位打包的数据矩阵（一次分配，采集过程中不再增长）
     {
-        m_dataMatrix.clear();
-        m_dataMatrix.reserve(m_config.m_totalDetectionNum);
-
-        // 预分配所有行的内存，避免动态增长
-        for (uint16_t i = 0; i < m_config.m_totalDetectionNum; ++i)
-        {
-            m_dataMatrix.emplace_back(m_config.m_num, ContinuityState::DISCONNECTED);
-        }
+        size_t totalElements = static_cast<size_t>(m_config.m_totalDetectionNum) * m_config.m_num;
+        size_t totalBytes = (totalElements + 7) / 8;
+        m_packedData.assign(totalBytes, 0);
 
         // 监控内存使用情况
-        size_t totalElements = m_config.m_totalDetectionNum * m_config.m_num;
-        size_t totalBytes = totalElements * sizeof(ContinuityState);
         elog_v(TAG, "Memory allocated: %d rows x %d cols = %d elements (%d bytes)", m_config.m_totalDetectionNum,
                m_config.m_num, totalElements, totalBytes);
     }
 
     m_currentCycle = 0;
 
-    // 初始化GPIO引脚
-    InitializeGpioPins();
+    // 初始化引脚，所有引脚处于空闲状态
+    if (!m_pinDriver->Configure(m_config.m_num))
+    {
+        return false;
+    }
 
     m_status = CollectionStatus::IDLE;
 
@@ -115,7 +93,6 @@ bool ContinuityCollector::StartCollection()
     // 重置状态
     m_currentCycle = 0;
     m_status = CollectionStatus::RUNNING;
-    m_lastActivePin = -1; // 重置上一个激活的引脚
 
     elog_v(TAG, "startCollection completed, status: RUNNING");
     return true;
@@ -126,13 +103,8 @@ void ContinuityCollector::StopCollection()
     if (m_status == CollectionStatus::RUNNING)
     {
         m_status = CollectionStatus::IDLE;
-        // 复位所有引脚
-        if (m_lastActivePin >= 0)
-        {
-            GpioPin gpioPin = m_config.GetGpioPin(m_lastActivePin);
-            HalGpioInit(gpioPin, GPIO_MODE_INPUT, GPIO_PULLDOWN);
-            m_lastActivePin = -1;
-        }
+        // 复位激活的引脚
+        m_pinDriver->SetActivePin(-1);
     }
 }
 
@@ -141,14 +113,7 @@ void ContinuityCollector::SetAllPinsToInputMode()
     elog_v(TAG, "Setting all pins to input mode");
 
     // 将所有已配置的引脚设置为输入模式
-    for (uint8_t pin = 0; pin < m_config.m_num; pin++)
-    {
-        GpioPin gpioPin = m_config.GetGpioPin(pin);
-        HalGpioInit(gpioPin, GPIO_MODE_INPUT, GPIO_PULLDOWN);
-    }
-
-    // 重置最后一个激活的引脚标记
-    m_lastActivePin = -1;
+    m_pinDriver->SetIdle();
 
     elog_v(TAG, "All pins set to input mode");
 }
@@ -161,9 +126,89 @@ void ContinuityCollector::SetAllPinsToInputMode()
 //     return hal_hptimer_get_us();
 // }
 
-void ContinuityCollector::DelayMs(uint32_t ms)
+void ContinuityCollector::DelayUs(uint32_t us)
 {
-    vTaskDelay(pdMS_TO_TICKS(ms));
+    // 超过两个tick时让出CPU，多等一个tick保证不短于us；否则用硬件定时器忙等
+    if (us >= 2 * portTICK_PERIOD_MS * 1000)
+    {
+        vTaskDelay(pdMS_TO_TICKS(us / 1000) + 1);
+    }
+    else
+    {
+        HptimerDelayUs(us);
+    }
+}
+
+bool ContinuityCollector::ScanMatchesReference(const std::vector<ContinuityRow> &reference, uint32_t settleUs)
+{
+    ContinuityRow sample;
+    for (uint8_t pin = 0; pin < m_config.m_num; pin++)
+    {
+        ConfigurePinsForSlot(pin, true);
+        DelayUs(settleUs);
+        m_pinDriver->Sample(sample);
+        if (sample != reference[pin])
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+uint32_t ContinuityCollector::CalibrateSettleTime()
+{
+    m_settleUs = COLLECT_SETTLE_MAX_US;
+    if (m_config.m_num == 0 || m_status == CollectionStatus::RUNNING)
+    {
+        return m_settleUs;
+    }
+
+    // 参考：按采集顺序逐个驱动引脚，等待最长时间后多数表决
+    const uint16_t rowBytes = (m_config.m_num + 7) / 8;
+    std::vector<ContinuityRow> reference(m_config.m_num);
+    uint32_t connections = 0;
+    for (uint8_t pin = 0; pin < m_config.m_num; pin++)
+    {
+        ConfigurePinsForSlot(pin, true);
+        DelayUs(COLLECT_SETTLE_MAX_US);
+        reference[pin] = ReadRowContinuityWithVoting();
+        connections += reference[pin].Count(rowBytes) - (reference[pin].Test(pin) ? 1 : 0);
+    }
+
+    // 没有任何引脚之间导通（未接线束）时无法测量稳定时间，保持最长等待时间
+    if (connections == 0)
+    {
+        ConfigurePinsForSlot(0, false);
+        elog_w(TAG, "Settle calibration skipped: no connections between pins");
+        return m_settleUs;
+    }
+
+    // 等待时间逐级加倍，每级多次扫描，单次采样全部与参考一致才算稳定
+    uint32_t stableUs = 0;
+    for (uint32_t settleUs = COLLECT_SETTLE_MIN_US; settleUs < COLLECT_SETTLE_MAX_US && stableUs == 0;
+         settleUs *= 2)
+    {
+        bool stable = true;
+        for (uint8_t pass = 0; pass < COLLECT_SETTLE_CAL_PASSES && stable; pass++)
+        {
+            stable = ScanMatchesReference(reference, settleUs);
+        }
+        if (stable)
+        {
+            stableUs = settleUs;
+        }
+    }
+
+    ConfigurePinsForSlot(0, false);
+
+    if (stableUs != 0)
+    {
+        m_settleUs = std::min<uint32_t>(COLLECT_SETTLE_MAX_US,
+                                        stableUs + stableUs * COLLECT_SETTLE_MARGIN_PERCENT / 100);
+    }
+    elog_i(TAG, "Settle time calibrated: %lu us (stable at %lu us)", static_cast<unsigned long>(m_settleUs),
+           static_cast<unsigned long>(stableUs));
+    return m_settleUs;
 }
 
 // 处理时隙事件（由外部时隙管理器调用）
@@ -187,25 +232,14 @@ void ContinuityCollector::ProcessSlot(uint16_t slotNumber, uint8_t activePin, bo
     // 配置当前时隙的引脚状态
     ConfigurePinsForSlot(activePin, isActive);
 
-    DelayMs(3);
+    // 等待线束输入稳定
+    DelayUs(m_settleUs);
 
-    // 使用静态缓冲区避免频繁的内存分配
-    static std::vector<ContinuityState> slotData;
-    slotData.clear();
-    slotData.reserve(m_config.m_num);
+    // 读取当前时隙的所有引脚状态（连续采集5次，取出现最多的状态），引脚0在最高位
+    const ContinuityRow rowBits = ReadRowContinuityWithVoting();
 
-    // 读取当前时隙的所有引脚状态（连续采集5次，取出现最多的状态）
-    for (uint8_t pin = 0; pin < m_config.m_num; pin++)
-    {
-        ContinuityState state = ReadPinContinuityWithVoting(pin);
-        slotData.push_back(state);
-    }
-
-    // 保存数据到矩阵 - 直接复制，避免移动操作
-    if (m_currentCycle < m_dataMatrix.size())
-    {
-        m_dataMatrix[m_currentCycle] = slotData;
-    }
+    // 按发送格式直接写入数据矩阵
+    WriteRow(m_currentCycle, rowBits);
 
     // 减少日志输出频率，只在每10个周期输出一次
     if (m_currentCycle % 10 == 0)
@@ -274,86 +308,141 @@ bool ContinuityCollector::IsCollectionComplete() const
 
 ContinuityMatrix ContinuityCollector::GetDataMatrix() const
 {
-    return m_dataMatrix;
+    ContinuityMatrix matrix;
+    matrix.reserve(m_config.m_totalDetectionNum);
+    for (uint16_t row = 0; row < m_config.m_totalDetectionNum; row++)
+    {
+        matrix.push_back(GetCycleData(row));
+    }
+    return matrix;
 }
 
 std::vector<uint8_t> ContinuityCollector::GetDataVector() const
 {
-    std::vector<uint8_t> compressedData;
-
-    size_t totalBits = m_dataMatrix.size() * m_config.m_num;
-    size_t totalBytes = (totalBits + 7) / 8; // 向上取整
-    compressedData.reserve(totalBytes);
+    // 数据矩阵已按发送格式存储
+    return m_packedData;
+}
 
-    uint8_t currentByte = 0;
-    uint8_t bitPosition = 7; // 从高位开始（大端）
+std::vector<ContinuityState> ContinuityCollector::GetCycleData(uint16_t cycle) const
+{
+    if (cycle >= m_config.m_totalDetectionNum)
+    {
+        return {};
+    }
 
-    for (const auto &row : m_dataMatrix)
+    std::vector<ContinuityState> result;
+    result.reserve(m_config.m_num);
+    const ContinuityRow rowBits = ReadRow(cycle);
+    for (uint8_t pin = 0; pin < m_config.m_num; pin++)
     {
-        for (size_t pin = 0; pin < m_config.m_num && pin < row.size(); pin++)
-        {
-            uint8_t bitValue = (row[pin] == ContinuityState::CONNECTED) ? 1 : 0;
+        result.push_back(rowBits.Test(pin) ? ContinuityState::CONNECTED : ContinuityState::DISCONNECTED);
+    }
+    return result;
+}
 
-            // 设置对应的高位
-            currentByte |= (bitValue << bitPosition);
+std::vector<ContinuityState> ContinuityCollector::GetPinData(uint8_t pin) const
+{
+    std::vector<ContinuityState> result;
 
-            if (bitPosition == 0)
-            {
-                compressedData.push_back(currentByte);
-                currentByte = 0;
-                bitPosition = 7;
-            }
-            else
-            {
-                bitPosition--;
-            }
+    if (pin < m_config.m_num)
+    {
+        result.reserve(m_config.m_totalDetectionNum);
+        for (uint16_t row = 0; row < m_config.m_totalDetectionNum; row++)
+        {
+            result.push_back(ReadCell(row, pin));
         }
     }
 
-    // 处理不足8位的最后一个字节
-    if (bitPosition != 7)
+    return result;
+}
+
+void ContinuityCollector::ClearData()
+{
+    std::fill(m_packedData.begin(), m_packedData.end(), 0);
+    m_currentCycle = 0;
+}
+
+void ContinuityCollector::RestartCycle()
+{
+    ClearData();
+    if (m_status == CollectionStatus::COMPLETED)
     {
-        compressedData.push_back(currentByte);
+        m_status = CollectionStatus::RUNNING;
     }
-
-    return compressedData;
 }
 
-std::vector<ContinuityState> ContinuityCollector::GetCycleData(uint16_t cycle) const
+size_t ContinuityCollector::GetCompletedBytes() const
 {
-    if (cycle < m_dataMatrix.size())
+    if (m_status == CollectionStatus::COMPLETED)
     {
-        return m_dataMatrix[cycle];
+        return m_packedData.size();
     }
-    return {};
+    // 最后一行可能只写了部分字节
+    return std::min(m_packedData.size(), static_cast<size_t>(m_currentCycle) * m_config.m_num / 8);
 }
 
-std::vector<ContinuityState> ContinuityCollector::GetPinData(uint8_t pin) const
+void ContinuityCollector::WriteRow(uint16_t row, const ContinuityRow &bits)
 {
-    std::vector<ContinuityState> result;
+    const size_t start = static_cast<size_t>(row) * m_config.m_num;
+    if ((start + m_config.m_num + 7) / 8 > m_packedData.size())
+    {
+        return;
+    }
 
-    if (pin < m_config.m_num)
+    // 行按字节高位在前排列，与数据矩阵只差 start % 8 位的偏移，逐字节移位后写入跨越的两个字节
+    const uint8_t offset = start % 8;
+    uint8_t *dest = &m_packedData[start / 8];
+    uint16_t remaining = m_config.m_num;
+    for (uint8_t i = 0; remaining > 0; i++)
     {
-        result.reserve(m_dataMatrix.size());
-        for (const auto &row : m_dataMatrix)
+        const uint8_t take = remaining < 8 ? remaining : 8;
+        const uint16_t mask = static_cast<uint16_t>((0xFF00U >> take) & 0xFF) << (8 - offset);
+        const uint16_t chunk = (static_cast<uint16_t>(bits.m_bytes[i]) << (8 - offset)) & mask;
+
+        dest[i] = static_cast<uint8_t>((dest[i] & ~(mask >> 8)) | (chunk >> 8));
+        if (mask & 0xFF)
         {
-            if (pin < row.size())
-            {
-                result.push_back(row[pin]);
-            }
+            dest[i + 1] = static_cast<uint8_t>((dest[i + 1] & ~mask) | chunk);
         }
+        remaining -= take;
     }
+}
 
-    return result;
+ContinuityRow ContinuityCollector::ReadRow(uint16_t row) const
+{
+    ContinuityRow bits{};
+    const size_t start = static_cast<size_t>(row) * m_config.m_num;
+    if ((start + m_config.m_num + 7) / 8 > m_packedData.size())
+    {
+        return bits;
+    }
+
+    const uint8_t offset = start % 8;
+    const uint8_t *src = &m_packedData[start / 8];
+    const size_t available = m_packedData.size() - start / 8;
+    uint16_t remaining = m_config.m_num;
+    for (uint8_t i = 0; remaining > 0; i++)
+    {
+        const uint8_t take = remaining < 8 ? remaining : 8;
+        uint16_t window = static_cast<uint16_t>(src[i]) << 8;
+        if (i + 1U < available)
+        {
+            window |= src[i + 1];
+        }
+        bits.m_bytes[i] = static_cast<uint8_t>(window >> (8 - offset)) & static_cast<uint8_t>(0xFF00U >> take);
+        remaining -= take;
+    }
+    return bits;
 }
 
-void ContinuityCollector::ClearData()
+ContinuityState ContinuityCollector::ReadCell(uint16_t row, uint8_t pin) const
 {
-    for (auto &row : m_dataMatrix)
+    const size_t bit = static_cast<size_t>(row) * m_config.m_num + pin;
+    if (pin >= m_config.m_num || bit / 8 >= m_packedData.size())
     {
-        std::fill(row.begin(), row.end(), ContinuityState::DISCONNECTED);
+        return ContinuityState::DISCONNECTED;
     }
-    m_currentCycle = 0;
+    return (m_packedData[bit / 8] & (0x80 >> (bit % 8))) ? ContinuityState::CONNECTED : ContinuityState::DISCONNECTED;
 }
 
 void ContinuityCollector::SetProgressCallback(ProgressCallback callback)
@@ -370,14 +459,15 @@ ContinuityCollector::Statistics ContinuityCollector::CalculateStatistics() const
     std::map<uint8_t, uint32_t> pinActivity;
 
     // 统计数据
-    for (const auto &row : m_dataMatrix)
+    for (uint16_t row = 0; row < m_config.m_totalDetectionNum; row++)
     {
-        for (uint8_t pin = 0; pin < row.size(); pin++)
+        const ContinuityRow rowBits = ReadRow(row);
+        totalReadings += m_config.m_num;
+        totalConnections += rowBits.Count(RowBytes());
+        for (uint8_t pin = 0; pin < m_config.m_num; pin++)
         {
-            totalReadings++;
-            if (row[pin] == ContinuityState::CONNECTED)
+            if (rowBits.Test(pin))
             {
-                totalConnections++;
                 pinActivity[pin]++;
             }
         }
@@ -404,160 +494,67 @@ ContinuityCollector::Statistics ContinuityCollector::CalculateStatistics() const
     return stats;
 }
 
-void ContinuityCollector::InitializeGpioPins()
-{
-    elog_v(TAG, "initializeGpioPins");
-
-    elog_v(TAG, "initializeGpioPins: config_.num: %d", m_config.m_num);
-
-    // 初始化所有需要的GPIO引脚为输入模式
-    for (uint8_t logicalPin = 0; logicalPin < m_config.m_num; logicalPin++)
-    {
-        elog_v(TAG, "logicalPin: %d", logicalPin);
-        GpioPin gpioPin = m_config.GetGpioPin(logicalPin);
-        elog_v(TAG, "GPIO port: %p, pin: 0x%04x", gpioPin.m_port, gpioPin.m_pin);
-        HalGpioInit(gpioPin, GPIO_MODE_INPUT, GPIO_PULLDOWN);
-        elog_v(TAG, "GPIO initialized");
-    }
-}
-
-void ContinuityCollector::DeinitializeGpioPins()
-{
-    // 反初始化所有GPIO引脚
-    for (uint8_t logicalPin = 0; logicalPin < m_config.m_num; logicalPin++)
-    {
-        GpioPin gpioPin = m_config.GetGpioPin(logicalPin);
-        HalGpioDeinit(gpioPin);
-    }
-}
-
-ContinuityState ContinuityCollector::ReadPinContinuity(uint8_t logicalPin)
-{
-    if (logicalPin >= m_config.m_num)
-    {
-        return ContinuityState::DISCONNECTED;
-    }
-
-    GpioPin gpioPin = m_config.GetGpioPin(logicalPin);
-    GPIO_PinState pinState = HalGpioRead(gpioPin);
-
-    // 高电平表示导通，低电平表示断开
-    return (pinState == GPIO_PIN_SET) ? ContinuityState::CONNECTED : ContinuityState::DISCONNECTED;
-}
-
-ContinuityState ContinuityCollector::ReadPinContinuityWithVoting(uint8_t logicalPin)
+ContinuityRow ContinuityCollector::ReadRowContinuityWithVoting()
 {
-    if (logicalPin >= m_config.m_num)
-    {
-        return ContinuityState::DISCONNECTED;
-    }
-
-    // 连续采集5次IO状态
-    constexpr uint8_t SAMPLE_COUNT = 5;
-    uint8_t connectedCount = 0;
-    uint8_t disconnectedCount = 0;
+    // 按位计数（三个位平面 count2:count1:count0），每个引脚独立累加导通次数
+    const uint8_t rowBytes = RowBytes();
+    ContinuityRow count0{};
+    ContinuityRow count1{};
+    ContinuityRow count2{};
+    ContinuityRow anyConnected{};
+    ContinuityRow allConnected;
+    std::fill(std::begin(allConnected.m_bytes), std::end(allConnected.m_bytes), 0xFF);
 
-    for (uint8_t i = 0; i < SAMPLE_COUNT; i++)
+    ContinuityRow sample;
+    for (uint8_t i = 0; i < VOTING_SAMPLES; i++)
     {
-        ContinuityState state = ReadPinContinuity(logicalPin);
-        if (state == ContinuityState::CONNECTED)
+        m_pinDriver->Sample(sample);
+        for (uint8_t b = 0; b < rowBytes; b++)
         {
-            connectedCount++;
+            const uint8_t bits = sample.m_bytes[b];
+            const uint8_t carry0 = count0.m_bytes[b] & bits;
+            count0.m_bytes[b] ^= bits;
+            const uint8_t carry1 = count1.m_bytes[b] & carry0;
+            count1.m_bytes[b] ^= carry0;
+            count2.m_bytes[b] |= carry1;
+
+            anyConnected.m_bytes[b] |= bits;
+            allConnected.m_bytes[b] &= bits;
         }
-        else
-        {
-            disconnectedCount++;
-        }
-    }
-
-    if (abs(connectedCount - disconnectedCount) != 5)
-    {
-        elog_w(TAG, " connected(%d)/disconnected(%d)", connectedCount, disconnectedCount);
-    }
-
-    // 返回出现最多的状态
-    return (connectedCount > disconnectedCount) ? ContinuityState::CONNECTED : ContinuityState::DISCONNECTED;
-}
-
-void ContinuityCollector::ConfigurePinsForSlot(uint8_t activePin, bool isActive)
-{
-    // // 1. 立即复位上一个激活的引脚（如果有）
-    // if (lastActivePin_ >= 0 && lastActivePin_ < config_.num) {
-    //     GpioPin gpioPin = config_.getGpioPin(lastActivePin_);
-    //     halGpioInit(gpioPin, GPIO_MODE_INPUT, GPIO_PULLDOWN);
-    //     elog_v(TAG, "Reset previous active pin: logical=%d", lastActivePin_);
-    // }
-
-    // 复位所有已配置引脚
-    for (uint8_t pin = 0; pin < m_config.m_num; pin++)
-    {
-        GpioPin gpioPin = m_config.GetGpioPin(pin);
-        HalGpioInit(gpioPin, GPIO_MODE_INPUT, GPIO_PULLDOWN);
     }
 
-    // 2. 如果当前时隙是激活时隙，配置对应引脚为输出高电平
-    if (isActive && activePin < m_config.m_num)
-    {
-        GpioPin activeGpioPin = m_config.GetGpioPin(activePin);
-        HalGpioInit(activeGpioPin, GPIO_MODE_OUTPUT_PP, GPIO_NOPULL, GPIO_PIN_SET);
-        HalGpioWrite(activeGpioPin, GPIO_PIN_SET);
-
-        elog_v(TAG, "Activated pin logical=%d", activePin);
-        m_lastActivePin = activePin;
-    }
-    else
+    // 导通次数 >= 3：count >= 4 时count2置位，count == 3 时count1和count0均置位
+    // 5次采样结果不一致的引脚只统计数量
+    ContinuityRow result{};
+    uint16_t unstableCount = 0;
+    for (uint8_t b = 0; b < rowBytes; b++)
     {
-        m_lastActivePin = -1;
+        result.m_bytes[b] = count2.m_bytes[b] | (count1.m_bytes[b] & count0.m_bytes[b]);
+        unstableCount += __builtin_popcount(anyConnected.m_bytes[b] & ~allConnected.m_bytes[b] & 0xFF);
     }
-}
-
-// HAL库GPIO辅助函数实现
-void ContinuityCollector::HalGpioInit(const GpioPin &gpioPin, uint32_t mode, uint32_t pull, GPIO_PinState initialState)
-{
-    if (!gpioPin.m_port)
-        return;
-
-    // 使能对应端口的时钟
-    enableGpioPortClock(gpioPin.m_port);
-
-    GPIO_InitTypeDef GPIO_InitStruct = {0};
-    GPIO_InitStruct.Pin = gpioPin.m_pin;
-    GPIO_InitStruct.Mode = mode;
-    GPIO_InitStruct.Pull = pull;
-    GPIO_InitStruct.Speed = GPIO_SPEED_FREQ_LOW;
-
-    // 如果是输出模式且指定了初始状态，先设置引脚状态
-    if ((mode == GPIO_MODE_OUTPUT_PP || mode == GPIO_MODE_OUTPUT_OD) && initialState != GPIO_PIN_RESET)
+    if (unstableCount != 0)
     {
-        HAL_GPIO_WritePin(gpioPin.m_port, gpioPin.m_pin, initialState);
+        elog_w(TAG, " %d pins unstable", unstableCount);
     }
-
-    HAL_GPIO_Init(gpioPin.m_port, &GPIO_InitStruct);
-}
-
-void ContinuityCollector::HalGpioDeinit(const GpioPin &gpioPin)
-{
-    if (!gpioPin.m_port)
-        return;
-    HAL_GPIO_DeInit(gpioPin.m_port, gpioPin.m_pin);
-}
-
-GPIO_PinState ContinuityCollector::HalGpioRead(const GpioPin &gpioPin)
-{
-    if (!gpioPin.m_port)
-        return GPIO_PIN_RESET;
-    return HAL_GPIO_ReadPin(gpioPin.m_port, gpioPin.m_pin);
+    return result;
 }
 
-void ContinuityCollector::HalGpioWrite(const GpioPin &gpioPin, GPIO_PinState state)
+void ContinuityCollector::ConfigurePinsForSlot(uint8_t activePin, bool isActive)
 {
-    if (!gpioPin.m_port)
-        return;
-    HAL_GPIO_WritePin(gpioPin.m_port, gpioPin.m_pin, state);
+    // 驱动只切换上一个和当前的激活引脚
+    m_pinDriver->SetActivePin((isActive && activePin < m_config.m_num) ? activePin : -1);
 }
 
 // 工厂类实现
 std::unique_ptr<ContinuityCollector> ContinuityCollectorFactory::Create()
 {
-    return std::make_unique<ContinuityCollector>();
+    auto collector = std::make_unique<ContinuityCollector>();
+#if ENABLE_SHIFT_REGISTER_EXPANDER
+    // 扩展芯片链与采集器同生命周期（整个固件运行期间），使用静态对象
+    static SpiShiftRegisterBus expanderBus(&EXPANDER_SPI_HANDLE, GpioPin(EXPANDER_LATCH_GPIO_Port, EXPANDER_LATCH_Pin),
+                                           GpioPin(EXPANDER_LOAD_GPIO_Port, EXPANDER_LOAD_Pin));
+    static ShiftRegisterPinDriver expanderDriver(expanderBus, EXPANDER_CHIP_COUNT);
+    collector->SetPinDriver(expanderDriver);
+#endif
+    return collector;
 }
\ No newline at end of file
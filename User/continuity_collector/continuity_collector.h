@@ -7,8 +7,10 @@
 #include <string>
 #include <vector>
 
+#include "config.h"
 #include "elog.h"
-#include "main.h"
+#include "gpio_pin_driver.h"
+#include "pin_driver.h"
 
 // 导通状态枚举
 enum class ContinuityState : uint8_t
@@ -17,90 +19,6 @@ enum class ContinuityState : uint8_t
     CONNECTED = 1     // 导通
 };
 
-// GPIO端口和引脚映射结构
-struct GpioPin
-{
-    GPIO_TypeDef *m_port;
-    uint16_t m_pin;
-
-    explicit GpioPin(GPIO_TypeDef *p = nullptr, const uint16_t pinNum = 0) : m_port(p), m_pin(pinNum)
-    {
-    }
-};
-
-// 使用CubeMX生成的宏定义的引脚映射表 (64个引脚)
-static const struct
-{
-    GPIO_TypeDef *m_port;
-    uint16_t m_pin;
-} HARDWARE_PIN_MAP[64] = {
-    // IO1-IO64 使用CubeMX生成的宏定义
-    {IO1_GPIO_Port, IO1_Pin},   // IO1
-    {IO2_GPIO_Port, IO2_Pin},   // IO2
-    {IO3_GPIO_Port, IO3_Pin},   // IO3
-    {IO4_GPIO_Port, IO4_Pin},   // IO4
-    {IO5_GPIO_Port, IO5_Pin},   // IO5
-    {IO6_GPIO_Port, IO6_Pin},   // IO6
-    {IO7_GPIO_Port, IO7_Pin},   // IO7
-    {IO8_GPIO_Port, IO8_Pin},   // IO8
-    {IO9_GPIO_Port, IO9_Pin},   // IO9
-    {IO10_GPIO_Port, IO10_Pin}, // IO10
-    {IO11_GPIO_Port, IO11_Pin}, // IO11
-    {IO12_GPIO_Port, IO12_Pin}, // IO12
-    {IO13_GPIO_Port, IO13_Pin}, // IO13
-    {IO14_GPIO_Port, IO14_Pin}, // IO14
-    {IO15_GPIO_Port, IO15_Pin}, // IO15
-    {IO16_GPIO_Port, IO16_Pin}, // IO16
-    {IO17_GPIO_Port, IO17_Pin}, // IO17
-    {IO18_GPIO_Port, IO18_Pin}, // IO18
-    {IO19_GPIO_Port, IO19_Pin}, // IO19
-    {IO20_GPIO_Port, IO20_Pin}, // IO20
-    {IO21_GPIO_Port, IO21_Pin}, // IO21
-    {IO22_GPIO_Port, IO22_Pin}, // IO22
-    {IO23_GPIO_Port, IO23_Pin}, // IO23
-    {IO24_GPIO_Port, IO24_Pin}, // IO24
-    {IO25_GPIO_Port, IO25_Pin}, // IO25
-    {IO26_GPIO_Port, IO26_Pin}, // IO26
-    {IO27_GPIO_Port, IO27_Pin}, // IO27
-    {IO28_GPIO_Port, IO28_Pin}, // IO28
-    {IO29_GPIO_Port, IO29_Pin}, // IO29
-    {IO30_GPIO_Port, IO30_Pin}, // IO30
-    {IO31_GPIO_Port, IO31_Pin}, // IO31
-    {IO32_GPIO_Port, IO32_Pin}, // IO32
-    {IO33_GPIO_Port, IO33_Pin}, // IO33
-    {IO34_GPIO_Port, IO34_Pin}, // IO34
-    {IO35_GPIO_Port, IO35_Pin}, // IO35
-    {IO36_GPIO_Port, IO36_Pin}, // IO36
-    {IO37_GPIO_Port, IO37_Pin}, // IO37
-    {IO38_GPIO_Port, IO38_Pin}, // IO38
-    {IO39_GPIO_Port, IO39_Pin}, // IO39
-    {IO40_GPIO_Port, IO40_Pin}, // IO40
-    {IO41_GPIO_Port, IO41_Pin}, // IO41
-    {IO42_GPIO_Port, IO42_Pin}, // IO42
-    {IO43_GPIO_Port, IO43_Pin}, // IO43
-    {IO44_GPIO_Port, IO44_Pin}, // IO44
-    {IO45_GPIO_Port, IO45_Pin}, // IO45
-    {IO46_GPIO_Port, IO46_Pin}, // IO46
-    {IO47_GPIO_Port, IO47_Pin}, // IO47
-    {IO48_GPIO_Port, IO48_Pin}, // IO48
-    {IO49_GPIO_Port, IO49_Pin}, // IO49
-    {IO50_GPIO_Port, IO50_Pin}, // IO50
-    {IO51_GPIO_Port, IO51_Pin}, // IO51
-    {IO52_GPIO_Port, IO52_Pin}, // IO52
-    {IO53_GPIO_Port, IO53_Pin}, // IO53
-    {IO54_GPIO_Port, IO54_Pin}, // IO54
-    {IO55_GPIO_Port, IO55_Pin}, // IO55
-    {IO56_GPIO_Port, IO56_Pin}, // IO56
-    {IO57_GPIO_Port, IO57_Pin}, // IO57
-    {IO58_GPIO_Port, IO58_Pin}, // IO58
-    {IO59_GPIO_Port, IO59_Pin}, // IO59
-    {IO60_GPIO_Port, IO60_Pin}, // IO60
-    {IO61_GPIO_Port, IO61_Pin}, // IO61
-    {IO62_GPIO_Port, IO62_Pin}, // IO62
-    {IO63_GPIO_Port, IO63_Pin}, // IO63
-    {IO64_GPIO_Port, IO64_Pin}  // IO64
-};
-
 // 导通数据采集配置
 struct CollectorConfig
 {
@@ -110,8 +28,6 @@ struct CollectorConfig
     explicit CollectorConfig(const uint8_t n = 2, const uint16_t totalDetNum = 4)
         : m_num(n), m_totalDetectionNum(totalDetNum)
     {
-        if (m_num > 64)
-            m_num = 64;
         if (m_totalDetectionNum == 0 || m_totalDetectionNum > 65535)
             m_totalDetectionNum = 65535;
 
@@ -133,12 +49,9 @@ struct CollectorConfig
         elog_v("CollectorConfig", "logicalPin out of range, returning: %d", logicalPin);
         return logicalPin; // 如果超出范围，返回逻辑引脚号
     }
-
-    // 将逻辑引脚号转换为GPIO端口和引脚
-    static GpioPin GetGpioPin(uint8_t logicalPin);
 };
 
-// 导通数据矩阵类型
+// 导通数据矩阵类型（展开后的副本，仅用于调试查看；采集器内部按位打包存储）
 using ContinuityMatrix = std::vector<std::vector<ContinuityState>>;
 
 // 采集状态枚举
@@ -162,31 +75,38 @@ class ContinuityCollector
   private:
     // define TAG
     static constexpr auto TAG = "ConCollector";
-    static constexpr uint8_t MAX_GPIO_PINS = 64;
+    static constexpr uint8_t VOTING_SAMPLES = 5; // 每个时隙的采样次数，按多数表决
 
-    CollectorConfig m_config;      // 采集配置
-    ContinuityMatrix m_dataMatrix; // 数据矩阵
+    CollectorConfig m_config; // 采集配置
+
+    // 按位打包的数据矩阵：第r行引脚p位于第 (r * m_num + p) 位，每字节高位在前，
+    // 与发送格式一致，行与行之间不按字节对齐
+    std::vector<uint8_t> m_packedData;
 
     CollectionStatus m_status;           // 采集状态
     uint16_t m_currentCycle;             // 当前周期
     ProgressCallback m_progressCallback; // 进度回调
 
-    // 引脚状态跟踪
-    int8_t m_lastActivePin; // 上一个激活的引脚（-1表示无）
+    uint32_t m_settleUs; // 驱动引脚到采样之间的等待时间（us），由当前线束标定
+
+    // 引脚驱动（默认直接使用GPIO）
+    GpioPinDriver m_gpioDriver;
+    IPinDriver *m_pinDriver;
 
     // 私有方法
-    void InitializeGpioPins();                                       // 初始化GPIO引脚
-    void DeinitializeGpioPins();                                     // 反初始化GPIO引脚
-    ContinuityState ReadPinContinuity(uint8_t logicalPin);           // 读取单个引脚导通状态
-    ContinuityState ReadPinContinuityWithVoting(uint8_t logicalPin); // 连续采集5次IO状态，返回出现最多的状态
+    [[nodiscard]] uint8_t RowBytes() const
+    {
+        return static_cast<uint8_t>((m_config.m_num + 7) / 8);
+    }
+    ContinuityRow ReadRowContinuityWithVoting();                 // 连续采样5次，每个引脚取出现最多的状态
     void ConfigurePinsForSlot(uint8_t activePin, bool isActive); // 为指定时隙配置引脚模式
-    void DelayMs(uint32_t ms);                                   // 延迟函数
+    void DelayUs(uint32_t us);                                   // 延迟函数（短延迟忙等，长延迟让出CPU）
+    bool ScanMatchesReference(const std::vector<ContinuityRow> &reference, uint32_t settleUs); // 按给定等待时间扫描一遍并与参考比较
 
-    // HAL库GPIO辅助函数
-    void HalGpioInit(const GpioPin &gpioPin, uint32_t mode, uint32_t pull, GPIO_PinState initialState = GPIO_PIN_RESET);
-    void HalGpioDeinit(const GpioPin &gpioPin);
-    GPIO_PinState HalGpioRead(const GpioPin &gpioPin);
-    void HalGpioWrite(const GpioPin &gpioPin, GPIO_PinState state);
+    // 按位打包矩阵的行读写
+    void WriteRow(uint16_t row, const ContinuityRow &bits);
+    [[nodiscard]] ContinuityRow ReadRow(uint16_t row) const;
+    [[nodiscard]] ContinuityState ReadCell(uint16_t row, uint8_t pin) const;
 
   public:
     ContinuityCollector();
@@ -196,6 +116,18 @@ class ContinuityCollector
     ContinuityCollector(const ContinuityCollector &) = delete;
     ContinuityCollector &operator=(const ContinuityCollector &) = delete;
 
+    // 替换引脚驱动（默认直接使用GPIO，见ContinuityCollectorFactory），需在Configure之前调用
+    void SetPinDriver(IPinDriver &driver)
+    {
+        m_pinDriver = &driver;
+    }
+
+    // 默认的GPIO引脚驱动
+    [[nodiscard]] GpioPinDriver &GetGpioDriver()
+    {
+        return m_gpioDriver;
+    }
+
     // 配置采集参数
     bool Configure(const CollectorConfig &config);
 
@@ -208,6 +140,23 @@ class ContinuityCollector
     // 将所有引脚设置为输入模式（用于周期结束时）
     void SetAllPinsToInputMode();
 
+    // 标定当前线束的稳定时间：以最长等待时间的采样为参考，等待时间从最短值逐级加倍，
+    // 多次扫描所有引脚的单次采样都与参考一致时取该值加余量，返回并保存标定结果；
+    // 参考中没有引脚之间导通（未接线束）时保持最长等待时间
+    // 只在收到标定命令时于Configure之后、采集开始之前调用（阻塞约0.3~1秒并驱动采集引脚）；
+    // Configure不标定，引脚数变化时恢复最长等待时间
+    uint32_t CalibrateSettleTime();
+
+    // 获取/设置驱动引脚到采样之间的等待时间（us）
+    [[nodiscard]] uint32_t GetSettleUs() const
+    {
+        return m_settleUs;
+    }
+    void SetSettleUs(uint32_t settleUs)
+    {
+        m_settleUs = settleUs;
+    }
+
     // 处理时隙事件（由外部时隙管理器调用）
     void ProcessSlot(uint16_t slotNumber, uint8_t activePin, bool isActive);
 
@@ -244,15 +193,27 @@ class ContinuityCollector
     // 获取采集进度百分比
     [[nodiscard]] float GetProgress() const;
 
-    // 获取压缩数据向量（按位压缩，小端模式）
+    // 获取压缩数据向量（按位压缩，每字节高位在前）
     [[nodiscard]] std::vector<uint8_t> GetDataVector() const;
 
+    // 已完整写入的数据字节数，采集过程中这些字节不再改变，可以提前发送
+    [[nodiscard]] size_t GetCompletedBytes() const;
+
+    // 按位压缩的数据（即GetDataVector的内容，不复制）
+    [[nodiscard]] const std::vector<uint8_t> &GetPackedData() const
+    {
+        return m_packedData;
+    }
+
     // 获取指定引脚的所有周期数据
     [[nodiscard]] std::vector<ContinuityState> GetPinData(uint8_t pin) const;
 
     // 清空数据矩阵
     void ClearData();
 
+    // 清空数据矩阵，已完成的采集从第0个周期重新开始（连续采集时在周期结束时调用）
+    void RestartCycle();
+
     // 统计功能
     struct Statistics
     {
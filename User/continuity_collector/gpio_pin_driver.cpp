@@ -0,0 +1,199 @@
+#include "gpio_pin_driver.h"
+
+#include "elog.h"
+
+GpioPinDriver::GpioPinDriver()
+    : m_registers(&HalGpioRegisters::GetInstance()), m_pinCount(0), m_activePin(-1), m_gatherPlan{},
+      m_gatherPortCount(0), m_pinRegisters{}
+{
+}
+
+// 将逻辑引脚号转换为GPIO端口和引脚
+GpioPin GpioPinDriver::GetGpioPin(uint8_t logicalPin)
+{
+    if (logicalPin < MAX_GPIO_PINS)
+    {
+        // 直接使用映射表中的GPIO信息
+        return GpioPin(HARDWARE_PIN_MAP[logicalPin].m_port, HARDWARE_PIN_MAP[logicalPin].m_pin);
+    }
+
+    // 默认返回PA0
+    elog_e(TAG, "Invalid logical pin: %d", logicalPin);
+    return GpioPin(GPIOA, GPIO_PIN_0);
+}
+
+bool GpioPinDriver::Configure(uint8_t pinCount)
+{
+    if (pinCount == 0 || pinCount > MAX_GPIO_PINS)
+    {
+        return false;
+    }
+
+    m_pinCount = pinCount;
+
+    // 使能端口时钟后由SetIdle写入空闲映像，把所有已配置引脚初始化为下拉输入
+    // （与HAL_GPIO_Init输入下拉模式写入的MODER/PUPDR相同）
+    BuildPortPlan();
+    SetIdle();
+    return true;
+}
+
+void GpioPinDriver::Deinitialize()
+{
+    // 反初始化所有GPIO引脚
+    for (uint8_t pin = 0; pin < m_pinCount; pin++)
+    {
+        HalGpioDeinit(GetGpioPin(pin));
+    }
+    m_activePin = -1;
+}
+
+void GpioPinDriver::BuildPortPlan()
+{
+    m_gatherPortCount = 0;
+    for (uint8_t pin = 0; pin < m_pinCount; pin++)
+    {
+        const GpioPin gpioPin = GetGpioPin(pin);
+        if (!gpioPin.m_port)
+        {
+            continue;
+        }
+
+        // 查找或新建该端口的分组
+        uint8_t index = 0;
+        while (index < m_gatherPortCount && m_gatherPlan[index].m_port != gpioPin.m_port)
+        {
+            index++;
+        }
+        if (index == m_gatherPortCount)
+        {
+            if (m_gatherPortCount >= MAX_GPIO_PORTS)
+            {
+                elog_e(TAG, "Too many GPIO ports in pin map");
+                continue;
+            }
+            m_gatherPlan[index] = PortGather();
+            m_gatherPlan[index].m_port = gpioPin.m_port;
+            m_gatherPortCount++;
+            m_registers->EnableClock(gpioPin.m_port);
+        }
+
+        // 引脚号（HAL的GPIO_PIN_x为单个位）
+        const uint32_t pinNumber = __builtin_ctz(gpioPin.m_pin);
+        const uint32_t fieldMask = 0x3UL << (pinNumber * 2);
+        PinRegisters &registers = m_pinRegisters[pin];
+        registers.m_port = gpioPin.m_port;
+        registers.m_fieldMask = fieldMask;
+        registers.m_moderOutput = 0x1UL << (pinNumber * 2);
+        registers.m_pupdrPullDown = 0x2UL << (pinNumber * 2);
+        registers.m_bsrrSet = gpioPin.m_pin;
+        registers.m_bsrrReset = static_cast<uint32_t>(gpioPin.m_pin) << 16;
+
+        PortGather &gather = m_gatherPlan[index];
+        if (gather.m_pinCount >= 16)
+        {
+            continue;
+        }
+        gather.m_pinMasks[gather.m_pinCount] = gpioPin.m_pin;
+        gather.m_pins[gather.m_pinCount] = pin;
+        gather.m_pinCount++;
+
+        gather.m_moderMask |= registers.m_fieldMask;
+        gather.m_pupdrPullDown |= registers.m_pupdrPullDown;
+        gather.m_bsrrReset |= registers.m_bsrrReset;
+    }
+
+    elog_v(TAG, "Gather plan: %d pins on %d ports", m_pinCount, m_gatherPortCount);
+}
+
+void GpioPinDriver::SetIdle()
+{
+    for (uint8_t i = 0; i < m_gatherPortCount; i++)
+    {
+        const PortGather &gather = m_gatherPlan[i];
+        m_registers->Write(gather.m_port, GpioReg::BSRR, gather.m_bsrrReset);
+        m_registers->Modify(gather.m_port, GpioReg::MODER, gather.m_moderMask, 0);
+        m_registers->Modify(gather.m_port, GpioReg::PUPDR, gather.m_moderMask, gather.m_pupdrPullDown);
+        m_registers->Modify(gather.m_port, GpioReg::OTYPER, gather.m_bsrrReset >> 16, 0);
+        m_registers->Modify(gather.m_port, GpioReg::OSPEEDR, gather.m_moderMask, 0);
+    }
+    m_activePin = -1;
+}
+
+void GpioPinDriver::SetActivePin(int16_t pin)
+{
+    if (pin >= m_pinCount)
+    {
+        pin = -1;
+    }
+
+    // 其他引脚在Configure时已设为下拉输入，只需切换上一个和当前的激活引脚
+    if (m_activePin >= 0 && m_activePin != pin)
+    {
+        SetPinIdle(m_activePin);
+    }
+
+    if (pin >= 0 && pin != m_activePin)
+    {
+        SetPinActive(pin);
+        elog_v(TAG, "Activated pin logical=%d", pin);
+    }
+
+    m_activePin = pin;
+}
+
+void GpioPinDriver::SetPinIdle(uint8_t pin)
+{
+    const PinRegisters &registers = m_pinRegisters[pin];
+    if (!registers.m_port)
+        return;
+
+    // 先切回输入，再恢复下拉，输出锁存清零
+    m_registers->Modify(registers.m_port, GpioReg::MODER, registers.m_fieldMask, 0);
+    m_registers->Modify(registers.m_port, GpioReg::PUPDR, registers.m_fieldMask, registers.m_pupdrPullDown);
+    m_registers->Write(registers.m_port, GpioReg::BSRR, registers.m_bsrrReset);
+}
+
+void GpioPinDriver::SetPinActive(uint8_t pin)
+{
+    const PinRegisters &registers = m_pinRegisters[pin];
+    if (!registers.m_port)
+        return;
+
+    // 先置位输出锁存，切换为输出时直接输出高电平
+    m_registers->Write(registers.m_port, GpioReg::BSRR, registers.m_bsrrSet);
+    m_registers->Modify(registers.m_port, GpioReg::PUPDR, registers.m_fieldMask, 0);
+    m_registers->Modify(registers.m_port, GpioReg::MODER, registers.m_fieldMask, registers.m_moderOutput);
+}
+
+void GpioPinDriver::Sample(ContinuityRow &row)
+{
+    // 先连续读取所有端口的IDR，使同一次采样的各端口时间尽量接近
+    uint32_t snapshots[MAX_GPIO_PORTS];
+    for (uint8_t i = 0; i < m_gatherPortCount; i++)
+    {
+        snapshots[i] = m_registers->Read(m_gatherPlan[i].m_port, GpioReg::IDR);
+    }
+
+    // 高电平表示导通
+    row = ContinuityRow();
+    for (uint8_t i = 0; i < m_gatherPortCount; i++)
+    {
+        const PortGather &gather = m_gatherPlan[i];
+        for (uint8_t j = 0; j < gather.m_pinCount; j++)
+        {
+            if (snapshots[i] & gather.m_pinMasks[j])
+            {
+                row.Set(gather.m_pins[j]);
+            }
+        }
+    }
+}
+
+// HAL库GPIO辅助函数实现
+void GpioPinDriver::HalGpioDeinit(const GpioPin &gpioPin)
+{
+    if (!gpioPin.m_port)
+        return;
+    HAL_GPIO_DeInit(gpioPin.m_port, gpioPin.m_pin);
+}
@@ -0,0 +1,167 @@
+#ifndef GPIO_PIN_DRIVER_H
+#define GPIO_PIN_DRIVER_H
+
+#include <cstdint>
+
+#include "gpio_registers.h"
+#include "main.h"
+#include "pin_driver.h"
+
+// GPIO端口和引脚映射结构
+struct GpioPin
+{
+    GPIO_TypeDef *m_port;
+    uint16_t m_pin;
+
+    explicit GpioPin(GPIO_TypeDef *p = nullptr, const uint16_t pinNum = 0) : m_port(p), m_pin(pinNum)
+    {
+    }
+};
+
+// 使用CubeMX生成的宏定义的引脚映射表 (64个引脚)
+static const struct
+{
+    GPIO_TypeDef *m_port;
+    uint16_t m_pin;
+} HARDWARE_PIN_MAP[64] = {
+    // IO1-IO64 使用CubeMX生成的宏定义
+    {IO1_GPIO_Port, IO1_Pin},   // IO1
+    {IO2_GPIO_Port, IO2_Pin},   // IO2
+    {IO3_GPIO_Port, IO3_Pin},   // IO3
+    {IO4_GPIO_Port, IO4_Pin},   // IO4
+    {IO5_GPIO_Port, IO5_Pin},   // IO5
+    {IO6_GPIO_Port, IO6_Pin},   // IO6
+    {IO7_GPIO_Port, IO7_Pin},   // IO7
+    {IO8_GPIO_Port, IO8_Pin},   // IO8
+    {IO9_GPIO_Port, IO9_Pin},   // IO9
+    {IO10_GPIO_Port, IO10_Pin}, // IO10
+    {IO11_GPIO_Port, IO11_Pin}, // IO11
+    {IO12_GPIO_Port, IO12_Pin}, // IO12
+    {IO13_GPIO_Port, IO13_Pin}, // IO13
+    {IO14_GPIO_Port, IO14_Pin}, // IO14
+    {IO15_GPIO_Port, IO15_Pin}, // IO15
+    {IO16_GPIO_Port, IO16_Pin}, // IO16
+    {IO17_GPIO_Port, IO17_Pin}, // IO17
+    {IO18_GPIO_Port, IO18_Pin}, // IO18
+    {IO19_GPIO_Port, IO19_Pin}, // IO19
+    {IO20_GPIO_Port, IO20_Pin}, // IO20
+    {IO21_GPIO_Port, IO21_Pin}, // IO21
+    {IO22_GPIO_Port, IO22_Pin}, // IO22
+    {IO23_GPIO_Port, IO23_Pin}, // IO23
+    {IO24_GPIO_Port, IO24_Pin}, // IO24
+    {IO25_GPIO_Port, IO25_Pin}, // IO25
+    {IO26_GPIO_Port, IO26_Pin}, // IO26
+    {IO27_GPIO_Port, IO27_Pin}, // IO27
+    {IO28_GPIO_Port, IO28_Pin}, // IO28
+    {IO29_GPIO_Port, IO29_Pin}, // IO29
+    {IO30_GPIO_Port, IO30_Pin}, // IO30
+    {IO31_GPIO_Port, IO31_Pin}, // IO31
+    {IO32_GPIO_Port, IO32_Pin}, // IO32
+    {IO33_GPIO_Port, IO33_Pin}, // IO33
+    {IO34_GPIO_Port, IO34_Pin}, // IO34
+    {IO35_GPIO_Port, IO35_Pin}, // IO35
+    {IO36_GPIO_Port, IO36_Pin}, // IO36
+    {IO37_GPIO_Port, IO37_Pin}, // IO37
+    {IO38_GPIO_Port, IO38_Pin}, // IO38
+    {IO39_GPIO_Port, IO39_Pin}, // IO39
+    {IO40_GPIO_Port, IO40_Pin}, // IO40
+    {IO41_GPIO_Port, IO41_Pin}, // IO41
+    {IO42_GPIO_Port, IO42_Pin}, // IO42
+    {IO43_GPIO_Port, IO43_Pin}, // IO43
+    {IO44_GPIO_Port, IO44_Pin}, // IO44
+    {IO45_GPIO_Port, IO45_Pin}, // IO45
+    {IO46_GPIO_Port, IO46_Pin}, // IO46
+    {IO47_GPIO_Port, IO47_Pin}, // IO47
+    {IO48_GPIO_Port, IO48_Pin}, // IO48
+    {IO49_GPIO_Port, IO49_Pin}, // IO49
+    {IO50_GPIO_Port, IO50_Pin}, // IO50
+    {IO51_GPIO_Port, IO51_Pin}, // IO51
+    {IO52_GPIO_Port, IO52_Pin}, // IO52
+    {IO53_GPIO_Port, IO53_Pin}, // IO53
+    {IO54_GPIO_Port, IO54_Pin}, // IO54
+    {IO55_GPIO_Port, IO55_Pin}, // IO55
+    {IO56_GPIO_Port, IO56_Pin}, // IO56
+    {IO57_GPIO_Port, IO57_Pin}, // IO57
+    {IO58_GPIO_Port, IO58_Pin}, // IO58
+    {IO59_GPIO_Port, IO59_Pin}, // IO59
+    {IO60_GPIO_Port, IO60_Pin}, // IO60
+    {IO61_GPIO_Port, IO61_Pin}, // IO61
+    {IO62_GPIO_Port, IO62_Pin}, // IO62
+    {IO63_GPIO_Port, IO63_Pin}, // IO63
+    {IO64_GPIO_Port, IO64_Pin}  // IO64
+};
+
+// 直接使用MCU GPIO的引脚驱动（HARDWARE_PIN_MAP，最多64个引脚）
+// 空闲引脚为下拉输入，激活引脚为推挽输出高电平；寄存器映像在Configure时生成，
+// 切换时隙只改写上一个和当前激活引脚的寄存器，采样时每个端口只读一次IDR
+class GpioPinDriver final : public IPinDriver
+{
+  public:
+    static constexpr uint8_t MAX_GPIO_PINS = 64;
+
+    GpioPinDriver();
+
+    // 替换寄存器访问层（默认直接访问硬件），需在Configure之前调用
+    void SetRegisterAccess(IGpioRegisters &registers)
+    {
+        m_registers = &registers;
+    }
+
+    // 将逻辑引脚号转换为GPIO端口和引脚
+    static GpioPin GetGpioPin(uint8_t logicalPin);
+
+    [[nodiscard]] uint16_t GetMaxPins() const override
+    {
+        return MAX_GPIO_PINS;
+    }
+
+    bool Configure(uint8_t pinCount) override;
+    void Deinitialize() override;
+    void SetIdle() override;
+    void SetActivePin(int16_t pin) override;
+    void Sample(ContinuityRow &row) override;
+
+  private:
+    static constexpr auto TAG = "GpioPinDriver";
+    static constexpr uint8_t MAX_GPIO_PORTS = 11; // GPIOA ~ GPIOK
+
+    // 按端口分组的读取计划和空闲寄存器映像：每次采样每个端口只读一次IDR，再按掩码取出各引脚；
+    // 空闲映像把本端口所有已配置引脚设为下拉输入
+    struct PortGather
+    {
+        GPIO_TypeDef *m_port;
+        uint8_t m_pinCount;
+        uint16_t m_pinMasks[16];  // 引脚在IDR中的掩码
+        uint8_t m_pins[16];       // 对应的逻辑引脚号
+        uint32_t m_moderMask;     // 已配置引脚的MODER/OSPEEDR字段（清零为输入/低速）
+        uint32_t m_pupdrPullDown; // 已配置引脚的PUPDR下拉映像（字段掩码同m_moderMask）
+        uint32_t m_bsrrReset;     // 已配置引脚的BSRR复位映像
+    };
+
+    // 单个引脚在激活/空闲之间切换时写入的寄存器映像
+    struct PinRegisters
+    {
+        GPIO_TypeDef *m_port;
+        uint32_t m_fieldMask;     // MODER/PUPDR中该引脚的2位字段
+        uint32_t m_moderOutput;   // MODER输出模式
+        uint32_t m_pupdrPullDown; // PUPDR下拉
+        uint32_t m_bsrrSet;       // BSRR置位
+        uint32_t m_bsrrReset;     // BSRR复位
+    };
+
+    IGpioRegisters *m_registers; // 寄存器访问层
+    uint8_t m_pinCount;
+    int16_t m_activePin; // 当前激活的引脚（-1表示无）
+    PortGather m_gatherPlan[MAX_GPIO_PORTS];
+    uint8_t m_gatherPortCount;
+    PinRegisters m_pinRegisters[MAX_GPIO_PINS];
+
+    void BuildPortPlan();             // 按端口分组生成读取计划和寄存器映像
+    void SetPinIdle(uint8_t pin);     // 激活引脚恢复为下拉输入
+    void SetPinActive(uint8_t pin);   // 引脚设为推挽输出高电平
+
+    // HAL库GPIO辅助函数
+    static void HalGpioDeinit(const GpioPin &gpioPin);
+};
+
+#endif // GPIO_PIN_DRIVER_H
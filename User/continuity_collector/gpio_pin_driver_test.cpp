@@ -0,0 +1,317 @@
+/**
+ * @file gpio_pin_driver_test.cpp
+ * @brief GpioPinDriver寄存器映像的主机测试
+ *
+ * 用记录读写的IGpioRegisters替换硬件寄存器，按不同引脚数Configure后检查：
+ * 已配置引脚的MODER/PUPDR/OTYPER/OSPEEDR字段和输出锁存、未配置位保持不变、
+ * 激活引脚切换时的MODER/PUPDR/BSRR映像及写入顺序，以及按端口读取IDR的采样结果。
+ * 期望值直接由main.h中的IOx_Pin/IOx_GPIO_Port逐位计算，不复用驱动的映像
+ *
+ * 主机编译运行（在仓库根目录；CMSIS头文件把外设地址转换为uint32_t，64位主机需-fpermissive）：
+ *   g++ -std=c++17 -O2 -fpermissive -DGPIO_PIN_DRIVER_TEST_MAIN -DUSE_HAL_DRIVER -DSTM32F429xx \
+ *       -ICore/Inc -IDrivers/STM32F4xx_HAL_Driver/Inc -IDrivers/CMSIS/Include \
+ *       -IDrivers/CMSIS/Device/ST/STM32F4xx/Include -Ieasylogger/inc \
+ *       User/continuity_collector/gpio_pin_driver_test.cpp \
+ *       User/continuity_collector/gpio_pin_driver.cpp -o gpio_pin_driver_test
+ *   ./gpio_pin_driver_test
+ */
+
+#ifdef GPIO_PIN_DRIVER_TEST_MAIN
+
+#include <algorithm>
+#include <cstdio>
+#include <map>
+#include <vector>
+
+#include "gpio_pin_driver.h"
+
+// 主机上没有HAL库和日志后端，提供空实现（Deinitialize与日志输出不在测试范围内）
+extern "C" void HAL_GPIO_DeInit(GPIO_TypeDef *, uint32_t)
+{
+}
+
+extern "C" void elog_output(uint8_t, const char *, const char *, const char *, const long, const char *, ...)
+{
+}
+
+namespace
+{
+
+// 复位后的寄存器填充值，用于检查未配置引脚的字段不被改写
+constexpr uint32_t BACKGROUND = 0xA5A5A5A5;
+
+// 记录寄存器读写的模拟端口，BSRR写入作用到输出锁存ODR上
+class MockGpioRegisters final : public IGpioRegisters
+{
+  public:
+    struct Port
+    {
+        uint32_t m_moder = BACKGROUND;
+        uint32_t m_otyper = BACKGROUND;
+        uint32_t m_ospeedr = BACKGROUND;
+        uint32_t m_pupdr = BACKGROUND;
+        uint32_t m_idr = 0;
+        uint32_t m_odr = 0xFFFF;
+        bool m_clockEnabled = false;
+        int m_idrReads = 0;
+    };
+
+    struct Access
+    {
+        GPIO_TypeDef *m_port;
+        GpioReg m_reg;
+        uint32_t m_value;
+    };
+
+    std::map<GPIO_TypeDef *, Port> m_ports;
+    std::vector<Access> m_writes;
+    bool m_accessWithoutClock = false;
+
+    uint32_t Read(GPIO_TypeDef *port, GpioReg reg) override
+    {
+        Port &state = getPort(port);
+        switch (reg)
+        {
+        case GpioReg::MODER:
+            return state.m_moder;
+        case GpioReg::OTYPER:
+            return state.m_otyper;
+        case GpioReg::OSPEEDR:
+            return state.m_ospeedr;
+        case GpioReg::PUPDR:
+            return state.m_pupdr;
+        case GpioReg::IDR:
+            state.m_idrReads++;
+            return state.m_idr;
+        case GpioReg::BSRR:
+            break;
+        }
+        return 0;
+    }
+
+    void Write(GPIO_TypeDef *port, GpioReg reg, uint32_t value) override
+    {
+        Port &state = getPort(port);
+        m_writes.push_back({port, reg, value});
+        switch (reg)
+        {
+        case GpioReg::MODER:
+            state.m_moder = value;
+            break;
+        case GpioReg::OTYPER:
+            state.m_otyper = value;
+            break;
+        case GpioReg::OSPEEDR:
+            state.m_ospeedr = value;
+            break;
+        case GpioReg::PUPDR:
+            state.m_pupdr = value;
+            break;
+        case GpioReg::BSRR:
+            // 复位优先级低于置位
+            state.m_odr &= ~(value >> 16);
+            state.m_odr |= value & 0xFFFF;
+            break;
+        case GpioReg::IDR:
+            break;
+        }
+    }
+
+    void EnableClock(GPIO_TypeDef *port) override
+    {
+        m_ports[port].m_clockEnabled = true;
+    }
+
+  private:
+    Port &getPort(GPIO_TypeDef *port)
+    {
+        Port &state = m_ports[port];
+        if (!state.m_clockEnabled)
+        {
+            m_accessWithoutClock = true;
+        }
+        return state;
+    }
+};
+
+uint32_t pinNumber(uint16_t pinMask)
+{
+    for (uint32_t i = 0; i < 16; i++)
+    {
+        if (pinMask == (1U << i))
+        {
+            return i;
+        }
+    }
+    return 16;
+}
+
+uint32_t field2(uint32_t reg, uint32_t number)
+{
+    return (reg >> (number * 2)) & 0x3;
+}
+
+int g_failures = 0;
+
+void report(const char *name, bool ok)
+{
+    std::printf("%-44s %s\n", name, ok ? "ok" : "MISMATCH");
+    if (!ok)
+    {
+        g_failures++;
+    }
+}
+
+// 检查引脚pin的寄存器字段：激活为推挽输出高电平，空闲为下拉输入低电平
+bool checkPin(MockGpioRegisters &mock, uint8_t pin, bool active)
+{
+    const GpioPin gpioPin = GpioPinDriver::GetGpioPin(pin);
+    const MockGpioRegisters::Port &state = mock.m_ports[gpioPin.m_port];
+    const uint32_t number = pinNumber(gpioPin.m_pin);
+    const bool latched = (state.m_odr & gpioPin.m_pin) != 0;
+    return field2(state.m_moder, number) == (active ? 0x1U : 0x0U) &&
+           field2(state.m_pupdr, number) == (active ? 0x0U : 0x2U) && field2(state.m_ospeedr, number) == 0 &&
+           (state.m_otyper & gpioPin.m_pin) == 0 && latched == active;
+}
+
+// 未配置的引脚位保持填充值
+bool checkUntouched(MockGpioRegisters &mock, uint8_t pinCount)
+{
+    std::map<GPIO_TypeDef *, uint32_t> usedPins;
+    for (uint8_t pin = 0; pin < pinCount; pin++)
+    {
+        const GpioPin gpioPin = GpioPinDriver::GetGpioPin(pin);
+        usedPins[gpioPin.m_port] |= gpioPin.m_pin;
+    }
+
+    for (const auto &entry : mock.m_ports)
+    {
+        const uint32_t used = usedPins[entry.first];
+        uint32_t fieldMask = 0;
+        for (uint32_t i = 0; i < 16; i++)
+        {
+            if (used & (1U << i))
+            {
+                fieldMask |= 0x3U << (i * 2);
+            }
+        }
+        const MockGpioRegisters::Port &state = entry.second;
+        if ((state.m_moder & ~fieldMask) != (BACKGROUND & ~fieldMask) ||
+            (state.m_pupdr & ~fieldMask) != (BACKGROUND & ~fieldMask) ||
+            (state.m_ospeedr & ~fieldMask) != (BACKGROUND & ~fieldMask) ||
+            (state.m_otyper & ~used) != (BACKGROUND & ~used) || (state.m_odr & ~used) != (0xFFFF & ~used))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+void runConfiguration(uint8_t pinCount, const std::vector<int16_t> &activePins)
+{
+    char name[64];
+    MockGpioRegisters mock;
+    GpioPinDriver driver;
+    driver.SetRegisterAccess(mock);
+
+    std::snprintf(name, sizeof(name), "pins=%2d configure", pinCount);
+    bool ok = driver.Configure(pinCount) && !mock.m_accessWithoutClock;
+    for (uint8_t pin = 0; pin < pinCount; pin++)
+    {
+        ok = ok && checkPin(mock, pin, false);
+    }
+    ok = ok && checkUntouched(mock, pinCount);
+    report(name, ok);
+
+    int16_t previous = -1;
+    for (int16_t active : activePins)
+    {
+        mock.m_writes.clear();
+        driver.SetActivePin(active);
+        const int16_t expected = active < pinCount ? active : -1;
+
+        std::snprintf(name, sizeof(name), "pins=%2d active %2d -> %2d", pinCount, previous, active);
+        ok = true;
+        for (uint8_t pin = 0; pin < pinCount; pin++)
+        {
+            ok = ok && checkPin(mock, pin, pin == expected);
+        }
+        ok = ok && checkUntouched(mock, pinCount);
+
+        // 只改写上一个和当前激活引脚所在端口；激活时先置位锁存再切换为输出
+        size_t bsrrSetAt = mock.m_writes.size();
+        size_t moderOutputAt = mock.m_writes.size();
+        for (size_t i = 0; i < mock.m_writes.size(); i++)
+        {
+            const MockGpioRegisters::Access &access = mock.m_writes[i];
+            const bool previousPort = previous >= 0 && access.m_port == GpioPinDriver::GetGpioPin(previous).m_port;
+            const bool activePort = expected >= 0 && access.m_port == GpioPinDriver::GetGpioPin(expected).m_port;
+            ok = ok && (previousPort || activePort);
+            if (expected >= 0 && activePort)
+            {
+                const GpioPin gpioPin = GpioPinDriver::GetGpioPin(expected);
+                if (access.m_reg == GpioReg::BSRR && (access.m_value & gpioPin.m_pin))
+                {
+                    bsrrSetAt = std::min(bsrrSetAt, i);
+                }
+                if (access.m_reg == GpioReg::MODER && field2(access.m_value, pinNumber(gpioPin.m_pin)) == 0x1)
+                {
+                    moderOutputAt = std::min(moderOutputAt, i);
+                }
+            }
+        }
+        if (expected >= 0 && expected != previous)
+        {
+            ok = ok && bsrrSetAt < moderOutputAt && moderOutputAt < mock.m_writes.size();
+        }
+        report(name, ok);
+        previous = expected;
+    }
+
+    driver.SetIdle();
+    std::snprintf(name, sizeof(name), "pins=%2d idle", pinCount);
+    ok = true;
+    for (uint8_t pin = 0; pin < pinCount; pin++)
+    {
+        ok = ok && checkPin(mock, pin, false);
+    }
+    report(name, ok && checkUntouched(mock, pinCount));
+
+    // 每隔三个引脚置高IDR，采样结果应只含这些引脚，且每个端口只读一次IDR
+    ContinuityRow expectedRow = ContinuityRow();
+    for (auto &entry : mock.m_ports)
+    {
+        entry.second.m_idr = 0;
+        entry.second.m_idrReads = 0;
+    }
+    for (uint8_t pin = 0; pin < pinCount; pin += 3)
+    {
+        const GpioPin gpioPin = GpioPinDriver::GetGpioPin(pin);
+        mock.m_ports[gpioPin.m_port].m_idr |= gpioPin.m_pin;
+        expectedRow.Set(pin);
+    }
+    ContinuityRow row;
+    driver.Sample(row);
+    std::snprintf(name, sizeof(name), "pins=%2d sample", pinCount);
+    ok = row == expectedRow;
+    for (const auto &entry : mock.m_ports)
+    {
+        ok = ok && entry.second.m_idrReads == 1;
+    }
+    report(name, ok);
+}
+
+} // namespace
+
+int main()
+{
+    // 单引脚、跨端口的前几个引脚、同一端口跨两个配置批次，以及全部64个引脚
+    runConfiguration(1, {0, 0, -1});
+    runConfiguration(7, {0, 5, 6, 4, 7, -1});
+    runConfiguration(16, {9, 14, 15, 8, 0});
+    runConfiguration(64, {0, 50, 53, 31, 63, 62, 64, 10});
+
+    std::printf("%s\n", g_failures == 0 ? "all ok" : "FAILED");
+    return g_failures == 0 ? 0 : 1;
+}
+#endif // GPIO_PIN_DRIVER_TEST_MAIN
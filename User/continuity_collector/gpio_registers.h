@@ -0,0 +1,115 @@
+#ifndef GPIO_REGISTERS_H
+#define GPIO_REGISTERS_H
+
+#include <cstdint>
+
+#include "main.h"
+
+// 采集器使用的GPIO寄存器
+enum class GpioReg : uint8_t
+{
+    MODER = 0,   // 模式（每引脚2位：00输入，01输出）
+    OTYPER = 1,  // 输出类型（每引脚1位：0推挽）
+    OSPEEDR = 2, // 输出速度（每引脚2位：00低速）
+    PUPDR = 3,   // 上下拉（每引脚2位：00无，10下拉）
+    IDR = 4,     // 输入数据
+    BSRR = 5     // 置位/复位（低16位置位，高16位复位，只写）
+};
+
+// GPIO寄存器访问层
+// 采集器只通过该接口读写端口寄存器，主机测试时可替换为记录读写的实现，检查寄存器映像
+class IGpioRegisters
+{
+  public:
+    virtual ~IGpioRegisters() = default;
+
+    virtual uint32_t Read(GPIO_TypeDef *port, GpioReg reg) = 0;
+    virtual void Write(GPIO_TypeDef *port, GpioReg reg, uint32_t value) = 0;
+
+    // 使能端口时钟，需在首次访问该端口寄存器之前调用
+    virtual void EnableClock(GPIO_TypeDef *port) = 0;
+
+    // 读-改-写：清除clearMask中的位后置位setBits
+    void Modify(GPIO_TypeDef *port, GpioReg reg, uint32_t clearMask, uint32_t setBits)
+    {
+        Write(port, reg, (Read(port, reg) & ~clearMask) | setBits);
+    }
+};
+
+// 直接访问硬件寄存器的实现
+class HalGpioRegisters final : public IGpioRegisters
+{
+  public:
+    static HalGpioRegisters &GetInstance()
+    {
+        static HalGpioRegisters instance;
+        return instance;
+    }
+
+    uint32_t Read(GPIO_TypeDef *port, GpioReg reg) override
+    {
+        switch (reg)
+        {
+        case GpioReg::MODER:
+            return port->MODER;
+        case GpioReg::OTYPER:
+            return port->OTYPER;
+        case GpioReg::OSPEEDR:
+            return port->OSPEEDR;
+        case GpioReg::PUPDR:
+            return port->PUPDR;
+        case GpioReg::IDR:
+            return port->IDR;
+        case GpioReg::BSRR:
+            break;
+        }
+        return 0;
+    }
+
+    void Write(GPIO_TypeDef *port, GpioReg reg, uint32_t value) override
+    {
+        switch (reg)
+        {
+        case GpioReg::MODER:
+            port->MODER = value;
+            break;
+        case GpioReg::OTYPER:
+            port->OTYPER = value;
+            break;
+        case GpioReg::OSPEEDR:
+            port->OSPEEDR = value;
+            break;
+        case GpioReg::PUPDR:
+            port->PUPDR = value;
+            break;
+        case GpioReg::BSRR:
+            port->BSRR = value;
+            break;
+        case GpioReg::IDR:
+            break;
+        }
+    }
+
+    void EnableClock(GPIO_TypeDef *port) override
+    {
+        if (port == GPIOA)
+            __HAL_RCC_GPIOA_CLK_ENABLE();
+        else if (port == GPIOB)
+            __HAL_RCC_GPIOB_CLK_ENABLE();
+        else if (port == GPIOC)
+            __HAL_RCC_GPIOC_CLK_ENABLE();
+        else if (port == GPIOD)
+            __HAL_RCC_GPIOD_CLK_ENABLE();
+        else if (port == GPIOE)
+            __HAL_RCC_GPIOE_CLK_ENABLE();
+        else if (port == GPIOF)
+            __HAL_RCC_GPIOF_CLK_ENABLE();
+        else if (port == GPIOG)
+            __HAL_RCC_GPIOG_CLK_ENABLE();
+    }
+
+  private:
+    HalGpioRegisters() = default;
+};
+
+#endif // GPIO_REGISTERS_H
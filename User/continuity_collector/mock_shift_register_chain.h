@@ -0,0 +1,123 @@
+#ifndef MOCK_SHIFT_REGISTER_CHAIN_H
+#define MOCK_SHIFT_REGISTER_CHAIN_H
+
+#include <cstdint>
+#include <vector>
+
+#include "shift_register_pin_driver.h"
+
+// 模拟的74HC595/74HC165级联链和线束，供主机上验证ShiftRegisterPinDriver和采集流程
+// 按IShiftRegisterBus描述的接线逐字节移位；165的输入取引脚所在导通网络的电平：
+//   DIODE_PULLDOWN：595输出经串联二极管接到引脚，165输入有弱下拉（ShiftRegisterPinDriver要求的接法），
+//                   网络中有输出高电平的引脚时为高，低电平输出被二极管隔离，否则被下拉为低
+//   DIRECT：595输出只经限流电阻直接接到引脚，网络中同时有高、低电平输出时两个电阻分压，
+//           165读到约VCC/2的不确定电平，记为冲突并读为低
+class MockShiftRegisterChain final : public IShiftRegisterBus
+{
+  public:
+    enum class Network
+    {
+        DIODE_PULLDOWN,
+        DIRECT
+    };
+
+    explicit MockShiftRegisterChain(uint8_t chipCount, Network network = Network::DIODE_PULLDOWN)
+        : m_chipCount(chipCount), m_network(network), m_outputShift(chipCount, 0), m_outputLatch(chipCount, 0),
+          m_inputShift(chipCount, 0), m_connections(static_cast<size_t>(chipCount) * 8)
+    {
+    }
+
+    // 线束中引脚a与b导通（双向）
+    void Connect(uint16_t a, uint16_t b)
+    {
+        m_connections[a].Set(b);
+        m_connections[b].Set(a);
+    }
+
+    // 595锁存后的输出电平
+    [[nodiscard]] bool GetOutput(uint16_t pin) const
+    {
+        return (m_outputLatch[pin / 8] >> (7 - pin % 8)) & 1;
+    }
+
+    // 累计移位的字节数
+    [[nodiscard]] uint32_t GetTransferredBytes() const
+    {
+        return m_transferredBytes;
+    }
+
+    // 累计装入时电平冲突（高、低输出直接相连）的引脚数
+    [[nodiscard]] uint32_t GetConflictCount() const
+    {
+        return m_conflicts;
+    }
+
+    void Transfer(const uint8_t *tx, uint8_t *rx, uint16_t length) override
+    {
+        for (uint16_t i = 0; i < length; i++)
+        {
+            // 595：新字节移入第0片，其余各片向链尾移动一片
+            for (uint8_t chip = m_chipCount - 1; chip > 0; chip--)
+            {
+                m_outputShift[chip] = m_outputShift[chip - 1];
+            }
+            m_outputShift[0] = tx[i];
+
+            // 165：第0片移出，其余各片向MISO移动一片，链尾的SER接地
+            rx[i] = m_inputShift[0];
+            for (uint8_t chip = 0; chip + 1 < m_chipCount; chip++)
+            {
+                m_inputShift[chip] = m_inputShift[chip + 1];
+            }
+            m_inputShift[m_chipCount - 1] = 0;
+        }
+        m_transferredBytes += length;
+    }
+
+    void LatchOutputs() override
+    {
+        m_outputLatch = m_outputShift;
+    }
+
+    void LoadInputs() override
+    {
+        const uint16_t pinCount = static_cast<uint16_t>(m_chipCount) * 8;
+        for (uint16_t pin = 0; pin < pinCount; pin++)
+        {
+            // 引脚本身及与之导通的引脚组成一个网络（线束只模拟直接导通，不做传递）
+            bool drivenHigh = GetOutput(pin);
+            bool drivenLow = !drivenHigh;
+            for (uint16_t other = 0; other < pinCount; other++)
+            {
+                if (m_connections[pin].Test(other))
+                {
+                    drivenHigh = drivenHigh || GetOutput(other);
+                    drivenLow = drivenLow || !GetOutput(other);
+                }
+            }
+
+            bool high = drivenHigh;
+            if (m_network == Network::DIRECT && drivenHigh && drivenLow)
+            {
+                m_conflicts++;
+                high = false;
+            }
+
+            const uint8_t mask = static_cast<uint8_t>(0x80 >> (pin % 8));
+            uint8_t &input = m_inputShift[pin / 8];
+            input = static_cast<uint8_t>(high ? (input | mask) : (input & ~mask));
+        }
+    }
+
+  private:
+    uint8_t m_chipCount;
+    Network m_network;
+    std::vector<uint8_t> m_outputShift; // 595移位寄存器，按芯片序号
+    std::vector<uint8_t> m_outputLatch; // 595输出锁存，按芯片序号
+    std::vector<uint8_t> m_inputShift;  // 165移位寄存器，按芯片序号
+    std::vector<ContinuityRow> m_connections;
+    uint32_t m_transferredBytes = 0;
+    uint32_t m_conflicts = 0;
+};
+
+#endif // MOCK_SHIFT_REGISTER_CHAIN_H
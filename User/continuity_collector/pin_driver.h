@@ -0,0 +1,73 @@
+#ifndef PIN_DRIVER_H
+#define PIN_DRIVER_H
+
+#include <cstdint>
+#include <cstring>
+
+// 一行（一个时隙）的导通状态，按发送格式排列：引脚p位于第 p/8 字节的第 (7 - p%8) 位，即每字节高位在前
+// 未使用的引脚位保持为0
+struct ContinuityRow
+{
+    static constexpr uint16_t MAX_PINS = 256;
+    static constexpr uint16_t MAX_BYTES = MAX_PINS / 8;
+
+    uint8_t m_bytes[MAX_BYTES];
+
+    [[nodiscard]] bool Test(uint16_t pin) const
+    {
+        return (m_bytes[pin / 8] >> (7 - pin % 8)) & 1;
+    }
+
+    void Set(uint16_t pin)
+    {
+        m_bytes[pin / 8] |= static_cast<uint8_t>(0x80 >> (pin % 8));
+    }
+
+    [[nodiscard]] uint16_t Count(uint16_t byteCount) const
+    {
+        uint16_t count = 0;
+        for (uint16_t i = 0; i < byteCount; i++)
+        {
+            count += __builtin_popcount(m_bytes[i]);
+        }
+        return count;
+    }
+
+    bool operator==(const ContinuityRow &other) const
+    {
+        return std::memcmp(m_bytes, other.m_bytes, sizeof(m_bytes)) == 0;
+    }
+
+    bool operator!=(const ContinuityRow &other) const
+    {
+        return !(*this == other);
+    }
+};
+
+// 采集引脚驱动接口
+// 采集器通过该接口驱动激活引脚、采样所有引脚，不关心引脚接在MCU的GPIO上还是扩展芯片上
+class IPinDriver
+{
+  public:
+    virtual ~IPinDriver() = default;
+
+    // 可驱动的最大引脚数
+    [[nodiscard]] virtual uint16_t GetMaxPins() const = 0;
+
+    // 按引脚数初始化硬件，所有引脚处于空闲（下拉输入）状态
+    virtual bool Configure(uint8_t pinCount) = 0;
+
+    // 释放硬件
+    virtual void Deinitialize() = 0;
+
+    // 所有引脚恢复为空闲状态
+    virtual void SetIdle() = 0;
+
+    // 切换激活引脚（输出高电平），-1表示不激活任何引脚；上一个激活引脚恢复为空闲
+    virtual void SetActivePin(int16_t pin) = 0;
+
+    // 采样所有引脚，高电平表示导通
+    virtual void Sample(ContinuityRow &row) = 0;
+};
+
+#endif // PIN_DRIVER_H
@@ -0,0 +1,90 @@
+#include "shift_register_pin_driver.h"
+
+#include <algorithm>
+#include <cstring>
+
+ShiftRegisterPinDriver::ShiftRegisterPinDriver(IShiftRegisterBus &bus, uint8_t chipCount)
+    : m_bus(bus), m_chipCount(std::min(chipCount, MAX_CHIPS)), m_pinCount(0), m_activePin(-1), m_outputImage{},
+      m_inputBuffer{}
+{
+}
+
+uint16_t ShiftRegisterPinDriver::GetMaxPins() const
+{
+    // 导通检测数量为uint8_t
+    return std::min<uint16_t>(m_chipCount * 8, UINT8_MAX);
+}
+
+bool ShiftRegisterPinDriver::Configure(uint8_t pinCount)
+{
+    if (pinCount == 0 || pinCount > GetMaxPins())
+    {
+        return false;
+    }
+
+    m_pinCount = pinCount;
+    SetIdle();
+    return true;
+}
+
+void ShiftRegisterPinDriver::Deinitialize()
+{
+    SetIdle();
+}
+
+void ShiftRegisterPinDriver::SetIdle()
+{
+    std::memset(m_outputImage, 0, sizeof(m_outputImage));
+    m_activePin = -1;
+    WriteOutputs();
+}
+
+void ShiftRegisterPinDriver::SetActivePin(int16_t pin)
+{
+    if (pin >= m_pinCount)
+    {
+        pin = -1;
+    }
+    if (pin == m_activePin)
+    {
+        return;
+    }
+
+    // 输出映像中只有上一个和当前激活引脚的位变化，但595链需整条重新移出
+    if (m_activePin >= 0)
+    {
+        OutputByte(m_activePin) &= static_cast<uint8_t>(~(0x80 >> (m_activePin % 8)));
+    }
+    if (pin >= 0)
+    {
+        OutputByte(pin) |= static_cast<uint8_t>(0x80 >> (pin % 8));
+    }
+    m_activePin = pin;
+    WriteOutputs();
+}
+
+void ShiftRegisterPinDriver::Sample(ContinuityRow &row)
+{
+    // 第0片离MISO最近，只需读出已使用的芯片；移出的输出映像未锁存，不影响595的输出
+    const uint8_t usedChips = static_cast<uint8_t>((m_pinCount + 7) / 8);
+    m_bus.LoadInputs();
+    m_bus.Transfer(m_outputImage, m_inputBuffer, usedChips);
+
+    row = ContinuityRow();
+    std::memcpy(row.m_bytes, m_inputBuffer, usedChips);
+    if (m_pinCount % 8 != 0)
+    {
+        // 清除最后一片中未使用的输入
+        row.m_bytes[usedChips - 1] &= static_cast<uint8_t>(0xFF00U >> (m_pinCount % 8));
+    }
+}
+
+void ShiftRegisterPinDriver::WriteOutputs()
+{
+    if (m_chipCount == 0)
+    {
+        return;
+    }
+    m_bus.Transfer(m_outputImage, m_inputBuffer, m_chipCount);
+    m_bus.LatchOutputs();
+}
@@ -0,0 +1,66 @@
+#ifndef SHIFT_REGISTER_PIN_DRIVER_H
+#define SHIFT_REGISTER_PIN_DRIVER_H
+
+#include <cstdint>
+
+#include "pin_driver.h"
+
+// 74HC595/74HC165级联链的总线接口
+// 595链：MOSI接第0片的SER，第k片的QH'接第k+1片的SER，所有片共用RCLK（锁存）
+// 165链：第0片的QH接MISO，第k+1片的QH接第k片的SER，所有片共用SH/LD（装入）
+class IShiftRegisterBus
+{
+  public:
+    virtual ~IShiftRegisterBus() = default;
+
+    // 全双工移位length字节，每字节高位在前：tx[0]最先移出，rx[0]为最先移入的字节
+    virtual void Transfer(const uint8_t *tx, uint8_t *rx, uint16_t length) = 0;
+
+    // 595移位寄存器内容送到输出（RCLK上升沿）
+    virtual void LatchOutputs() = 0;
+
+    // 165并行输入装入移位寄存器（SH/LD低脉冲）
+    virtual void LoadInputs() = 0;
+};
+
+// 级联移位寄存器扩展芯片的引脚驱动
+// 引脚p接第 p/8 片595的输出Q(7 - p%8)和第 p/8 片165的输入D(7 - p%8)，
+// 165读回的字节即为ContinuityRow的字节，采样不需要逐引脚处理；
+// 激活引脚输出高电平，空闲引脚输出低电平（595没有逐引脚的高阻态）
+// 硬件要求：每个595输出经串联二极管（阳极接595）接到引脚，每个165输入接弱下拉电阻到地。
+// 否则激活引脚与导通的空闲引脚的输出直接相连，两个限流电阻分压，165读到约VCC/2的不确定电平；
+// 接二极管后空闲引脚的低电平被隔离，导通网络由激活引脚拉高，未导通的引脚由下拉保持低电平
+// 每次采样一次SPI传输读回所有引脚，切换激活引脚一次传输改写整条595链
+class ShiftRegisterPinDriver final : public IPinDriver
+{
+  public:
+    static constexpr uint8_t MAX_CHIPS = ContinuityRow::MAX_BYTES;
+
+    ShiftRegisterPinDriver(IShiftRegisterBus &bus, uint8_t chipCount);
+
+    [[nodiscard]] uint16_t GetMaxPins() const override;
+
+    bool Configure(uint8_t pinCount) override;
+    void Deinitialize() override;
+    void SetIdle() override;
+    void SetActivePin(int16_t pin) override;
+    void Sample(ContinuityRow &row) override;
+
+  private:
+    IShiftRegisterBus &m_bus;
+    uint8_t m_chipCount; // 链上的芯片数（595和165各一片为一组）
+    uint8_t m_pinCount;
+    int16_t m_activePin; // 当前激活的引脚（-1表示无）
+
+    uint8_t m_outputImage[MAX_CHIPS]; // 按移出顺序排列：第k字节送到第 (m_chipCount - 1 - k) 片595
+    uint8_t m_inputBuffer[MAX_CHIPS];
+
+    [[nodiscard]] uint8_t &OutputByte(uint16_t pin)
+    {
+        return m_outputImage[m_chipCount - 1 - pin / 8];
+    }
+
+    void WriteOutputs(); // 移出输出映像并锁存
+};
+
+#endif // SHIFT_REGISTER_PIN_DRIVER_H
@@ -0,0 +1,202 @@
+/**
+ * @file shift_register_pin_driver_test.cpp
+ * @brief ShiftRegisterPinDriver在模拟595/165级联链上的主机测试
+ *
+ * 按不同芯片数和引脚数（含非8的整数倍）驱动MockShiftRegisterChain，逐个激活引脚后检查：
+ * 595锁存输出只有激活引脚为高（输出映像的移出顺序）、165采样结果与按线束连接表
+ * 独立计算的期望行一致（导通对跨越芯片边界）、未使用引脚被屏蔽，以及每次切换和采样的移位字节数；
+ * 另外对单个导通对比较两种接法：要求的二极管加下拉接法读回两个引脚都为高，
+ * 输出直接相连时激活引脚与空闲引脚的输出冲突（分压），读回结果错误
+ *
+ * 主机编译运行（在本目录）：
+ *   g++ -std=c++17 -O2 -DSHIFT_REGISTER_PIN_DRIVER_TEST_MAIN \
+ *       shift_register_pin_driver_test.cpp shift_register_pin_driver.cpp \
+ *       -o shift_register_pin_driver_test
+ *   ./shift_register_pin_driver_test
+ */
+
+#ifdef SHIFT_REGISTER_PIN_DRIVER_TEST_MAIN
+
+#include <cstdio>
+#include <utility>
+#include <vector>
+
+#include "mock_shift_register_chain.h"
+#include "shift_register_pin_driver.h"
+
+namespace
+{
+
+int g_failures = 0;
+
+void report(const char *name, bool ok)
+{
+    std::printf("%-52s %s\n", name, ok ? "ok" : "MISMATCH");
+    if (!ok)
+    {
+        g_failures++;
+    }
+}
+
+// 激活引脚active时期望的采样行：激活引脚本身及与之导通的已配置引脚为高
+ContinuityRow expectedRow(int16_t active, uint8_t pinCount, const std::vector<std::pair<uint16_t, uint16_t>> &wires)
+{
+    ContinuityRow row = ContinuityRow();
+    if (active < 0)
+    {
+        return row;
+    }
+    row.Set(active);
+    for (const auto &wire : wires)
+    {
+        if (wire.first == active && wire.second < pinCount)
+        {
+            row.Set(wire.second);
+        }
+        if (wire.second == active && wire.first < pinCount)
+        {
+            row.Set(wire.first);
+        }
+    }
+    return row;
+}
+
+void runChain(uint8_t chipCount, uint8_t pinCount, const std::vector<std::pair<uint16_t, uint16_t>> &wires)
+{
+    char name[80];
+    MockShiftRegisterChain chain(chipCount);
+    for (const auto &wire : wires)
+    {
+        chain.Connect(wire.first, wire.second);
+    }
+
+    ShiftRegisterPinDriver driver(chain, chipCount);
+    const uint16_t chainPins = static_cast<uint16_t>(chipCount) * 8;
+    const uint8_t usedChips = static_cast<uint8_t>((pinCount + 7) / 8);
+
+    std::snprintf(name, sizeof(name), "chips=%2d pins=%3d configure", chipCount, pinCount);
+    bool ok = driver.Configure(pinCount) && chain.GetTransferredBytes() == chipCount;
+    for (uint16_t pin = 0; pin < chainPins; pin++)
+    {
+        ok = ok && !chain.GetOutput(pin);
+    }
+    report(name, ok);
+
+    // 依次激活每个引脚（最后一个越界值应等同于不激活）
+    bool latchOk = true;
+    bool sampleOk = true;
+    bool bytesOk = true;
+    int firstBad = -1;
+    for (int16_t active = 0; active <= pinCount; active++)
+    {
+        const int16_t expected = active < pinCount ? active : -1;
+        uint32_t before = chain.GetTransferredBytes();
+        driver.SetActivePin(active);
+        bytesOk = bytesOk && chain.GetTransferredBytes() - before == chipCount;
+
+        for (uint16_t pin = 0; pin < chainPins; pin++)
+        {
+            latchOk = latchOk && chain.GetOutput(pin) == (pin == expected);
+        }
+
+        ContinuityRow row;
+        before = chain.GetTransferredBytes();
+        driver.Sample(row);
+        bytesOk = bytesOk && chain.GetTransferredBytes() - before == usedChips;
+        // 采样移出的数据未锁存，不能改变595的输出
+        latchOk = latchOk && (expected < 0 || chain.GetOutput(expected));
+        if (row != expectedRow(expected, pinCount, wires))
+        {
+            sampleOk = false;
+            if (firstBad < 0)
+            {
+                firstBad = active;
+            }
+        }
+    }
+
+    std::snprintf(name, sizeof(name), "chips=%2d pins=%3d latch order", chipCount, pinCount);
+    report(name, latchOk);
+    std::snprintf(name, sizeof(name), "chips=%2d pins=%3d sample", chipCount, pinCount);
+    report(name, sampleOk);
+    if (!sampleOk)
+    {
+        std::printf("  first mismatched active pin: %d\n", firstBad);
+    }
+    std::snprintf(name, sizeof(name), "chips=%2d pins=%3d transferred bytes", chipCount, pinCount);
+    report(name, bytesOk);
+
+    // 重复激活同一引脚不重新移位
+    driver.SetActivePin(0);
+    const uint32_t before = chain.GetTransferredBytes();
+    driver.SetActivePin(0);
+    std::snprintf(name, sizeof(name), "chips=%2d pins=%3d same pin no transfer", chipCount, pinCount);
+    report(name, chain.GetTransferredBytes() == before);
+
+    driver.SetIdle();
+    ok = true;
+    for (uint16_t pin = 0; pin < chainPins; pin++)
+    {
+        ok = ok && !chain.GetOutput(pin);
+    }
+    std::snprintf(name, sizeof(name), "chips=%2d pins=%3d idle", chipCount, pinCount);
+    report(name, ok);
+}
+
+// 引脚a与b导通，依次激活a和b，检查读回的行和冲突计数
+void runConnection(MockShiftRegisterChain::Network network, uint16_t a, uint16_t b)
+{
+    const bool diode = network == MockShiftRegisterChain::Network::DIODE_PULLDOWN;
+    char name[80];
+    MockShiftRegisterChain chain(2, network);
+    chain.Connect(a, b);
+    ShiftRegisterPinDriver driver(chain, 2);
+    bool configured = driver.Configure(16);
+
+    bool rowsOk = configured;
+    for (const uint16_t active : {a, b})
+    {
+        driver.SetActivePin(static_cast<int16_t>(active));
+        ContinuityRow row;
+        driver.Sample(row);
+
+        ContinuityRow expected = ContinuityRow();
+        expected.Set(a);
+        expected.Set(b);
+        rowsOk = rowsOk && row == expected;
+    }
+
+    std::snprintf(name, sizeof(name), "%s pins %d-%d rows", diode ? "diode+pulldown" : "direct", a, b);
+    report(name, diode ? rowsOk : !rowsOk);
+    std::snprintf(name, sizeof(name), "%s pins %d-%d conflicts", diode ? "diode+pulldown" : "direct", a, b);
+    report(name, diode ? chain.GetConflictCount() == 0 : chain.GetConflictCount() > 0);
+}
+
+} // namespace
+
+int main()
+{
+    // 单片：片内导通，以及导通到未配置引脚（应被屏蔽）
+    runChain(1, 8, {{0, 7}, {2, 5}});
+    runChain(1, 5, {{0, 4}, {1, 6}});
+
+    // 三片：导通对跨越芯片边界7/8、15/16，首尾相连；引脚数非8的整数倍时第三片部分使用
+    runChain(3, 24, {{7, 8}, {15, 16}, {0, 23}, {3, 12}});
+    runChain(3, 20, {{7, 8}, {15, 16}, {0, 19}, {9, 22}});
+
+    // 三片链只使用前两片：采样只读出已使用的芯片
+    runChain(3, 11, {{7, 8}, {10, 16}});
+
+    // 最大链长：32片，255个引脚
+    runChain(32, 255, {{7, 8}, {127, 128}, {0, 254}, {100, 255}, {31, 200}});
+
+    // 激活引脚与空闲引脚导通：二极管加下拉接法读回正确，直接相连时电平冲突
+    runConnection(MockShiftRegisterChain::Network::DIODE_PULLDOWN, 2, 5);
+    runConnection(MockShiftRegisterChain::Network::DIODE_PULLDOWN, 7, 8);
+    runConnection(MockShiftRegisterChain::Network::DIRECT, 2, 5);
+    runConnection(MockShiftRegisterChain::Network::DIRECT, 7, 8);
+
+    std::printf("%s\n", g_failures == 0 ? "all ok" : "FAILED");
+    return g_failures == 0 ? 0 : 1;
+}
+#endif // SHIFT_REGISTER_PIN_DRIVER_TEST_MAIN
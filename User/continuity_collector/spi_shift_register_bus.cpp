@@ -0,0 +1,42 @@
+#include "spi_shift_register_bus.h"
+
+#include "elog.h"
+
+SpiShiftRegisterBus::SpiShiftRegisterBus(SPI_HandleTypeDef *spi, const GpioPin &latchPin, const GpioPin &loadPin)
+    : m_spi(spi), m_latchPin(latchPin), m_loadPin(loadPin)
+{
+    // 空闲时RCLK为低、SH/LD为高（移位模式）
+    HAL_GPIO_WritePin(m_latchPin.m_port, m_latchPin.m_pin, GPIO_PIN_RESET);
+    HAL_GPIO_WritePin(m_loadPin.m_port, m_loadPin.m_pin, GPIO_PIN_SET);
+}
+
+void SpiShiftRegisterBus::Transfer(const uint8_t *tx, uint8_t *rx, uint16_t length)
+{
+    if (HAL_SPI_TransmitReceive(m_spi, const_cast<uint8_t *>(tx), rx, length, SPI_TIMEOUT_MS) != HAL_OK)
+    {
+        elog_e("ShiftRegBus", "SPI transfer failed (%d bytes)", length);
+    }
+}
+
+// 74HC系列在3.3V下的最小脉宽约20ns，两次BSRR写入之间补几个周期
+static inline void shortPulseDelay()
+{
+    __NOP();
+    __NOP();
+    __NOP();
+    __NOP();
+}
+
+void SpiShiftRegisterBus::LatchOutputs()
+{
+    m_latchPin.m_port->BSRR = m_latchPin.m_pin;
+    shortPulseDelay();
+    m_latchPin.m_port->BSRR = static_cast<uint32_t>(m_latchPin.m_pin) << 16;
+}
+
+void SpiShiftRegisterBus::LoadInputs()
+{
+    m_loadPin.m_port->BSRR = static_cast<uint32_t>(m_loadPin.m_pin) << 16;
+    shortPulseDelay();
+    m_loadPin.m_port->BSRR = m_loadPin.m_pin;
+}
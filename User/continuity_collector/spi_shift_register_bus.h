@@ -0,0 +1,29 @@
+#ifndef SPI_SHIFT_REGISTER_BUS_H
+#define SPI_SHIFT_REGISTER_BUS_H
+
+#include <cstdint>
+
+#include "gpio_pin_driver.h"
+#include "main.h"
+#include "shift_register_pin_driver.h"
+
+// 通过HAL SPI访问74HC595/74HC165级联链
+// SPI需配置为主机、8位、高位在前、CPOL=0/CPHA=0；latchPin接595的RCLK，loadPin接165的SH/LD
+class SpiShiftRegisterBus final : public IShiftRegisterBus
+{
+  public:
+    SpiShiftRegisterBus(SPI_HandleTypeDef *spi, const GpioPin &latchPin, const GpioPin &loadPin);
+
+    void Transfer(const uint8_t *tx, uint8_t *rx, uint16_t length) override;
+    void LatchOutputs() override;
+    void LoadInputs() override;
+
+  private:
+    static constexpr uint32_t SPI_TIMEOUT_MS = 10;
+
+    SPI_HandleTypeDef *m_spi;
+    GpioPin m_latchPin;
+    GpioPin m_loadPin;
+};
+
+#endif // SPI_SHIFT_REGISTER_BUS_H
@@ -11,9 +11,31 @@
 #ifdef __cplusplus
 
 #include "FreeRTOS.h"
+#include <atomic>
 #include <cstdlib>
 #include <new>
 
+/// Number of successful allocations, see FreertosNewGetAllocCount()
+static std::atomic<uint32_t> s_allocCount{0};
+
+/**
+ * @brief Allocate from the FreeRTOS heap and count successful allocations
+ */
+static void *countedAlloc(std::size_t size)
+{
+    void *ptr = pvPortMalloc(size);
+    if (ptr != nullptr)
+    {
+        s_allocCount.fetch_add(1, std::memory_order_relaxed);
+    }
+    return ptr;
+}
+
+uint32_t FreertosNewGetAllocCount()
+{
+    return s_allocCount.load(std::memory_order_relaxed);
+}
+
 /**
  * @brief Override global operator new to use FreeRTOS pvPortMalloc
  *
@@ -21,7 +43,7 @@
  */
 void *operator new(std::size_t size)
 {
-    return pvPortMalloc(size);
+    return countedAlloc(size);
 }
 
 /**
@@ -31,7 +53,7 @@ void *operator new(std::size_t size)
  */
 void *operator new[](std::size_t size)
 {
-    return pvPortMalloc(size);
+    return countedAlloc(size);
 }
 
 /**
@@ -40,7 +62,7 @@ void *operator new[](std::size_t size)
 void *operator new(std::size_t size, const std::nothrow_t &nothrow_tag) noexcept
 {
     (void)nothrow_tag; // Unused parameter
-    return pvPortMalloc(size);
+    return countedAlloc(size);
 }
 
 /**
@@ -49,7 +71,7 @@ void *operator new(std::size_t size, const std::nothrow_t &nothrow_tag) noexcept
 void *operator new[](std::size_t size, const std::nothrow_t &nothrow_tag) noexcept
 {
     (void)nothrow_tag; // Unused parameter
-    return pvPortMalloc(size);
+    return countedAlloc(size);
 }
 
 /**
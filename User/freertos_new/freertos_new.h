@@ -17,6 +17,18 @@
 
 #include <cstddef>
 #include <new>
+#include <cstdint>
+
+/**
+ * @brief Get the number of successful operator new calls since startup
+ *
+ * Sample the counter before and after a code path to check that it does not
+ * allocate (e.g. the steady-state receive path). The counter is global, so
+ * allocations made by other tasks preempting that path are counted as well.
+ *
+ * @return Total number of allocations made through operator new / new[]
+ */
+uint32_t FreertosNewGetAllocCount();
 
 /**
  * @brief Override global operator new to use FreeRTOS pvPortMalloc
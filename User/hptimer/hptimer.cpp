@@ -13,8 +13,6 @@ extern "C"
 }
 #endif
 
-static volatile bool s_initialized = false;
-
 uint32_t HptimerGetUs(void)
 {
     return __HAL_TIM_GET_COUNTER(&htim2); // 返回当前计数值（1μs 单位）
@@ -51,7 +49,8 @@ bool HptimerIsTimeoutUs(uint32_t refTime, uint32_t timeoutUs)
 
 void HptimerDelayUs(uint32_t us)
 {
-    if (!s_initialized || us == 0)
+    // 定时器未启动时计数值不变，直接返回避免死等
+    if (us == 0 || (htim2.Instance->CR1 & TIM_CR1_CEN) == 0)
         return;
 
     uint32_t start = HptimerGetUs();
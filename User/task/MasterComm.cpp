@@ -8,6 +8,7 @@
 // #include "deca_regs.h"
 // #include "port.h"
 #include "CX310.hpp"
+#include "hptimer.hpp"
 #include "uwb_interface.hpp"
 #if ENABLE_OTA_TASK
 #include "uwb_ltlp_queue.h"
@@ -21,6 +22,9 @@ extern CX310_SlaveSpiAdapter *g_uwbAdapter;
 #define TX_QUEUE_SIZE 10
 #define RX_QUEUE_SIZE 20
 
+// 超过该耗时的发送样本（发送命令异常重试等）不计入链路耗时
+#define LINK_SAMPLE_MAX_US 50000
+
 // 静态包装函数，用于FreeRTOS任务创建
 void MasterComm::UwbCommTaskWrapper(void *argument)
 {
@@ -117,14 +121,18 @@ void MasterComm::UwbCommTask()
 
     for (;;)
     {
-        // 等待发送信号量，有数据需要发送时被唤醒
+        // 等待发送信号量，有数据需要发送时被唤醒，依次发出环形缓冲区中的所有帧
+        // （时隙回调的优先级更高，一个激活时隙的多个分片在回调返回后连续发出）
         if (osSemaphoreAcquire(uwbTxSemaphore, 0) == osOK)
         {
-            // 获取互斥锁，从全局buffer读取数据
-            if (osMutexAcquire(uwbTxMutex, 10) == osOK)
+            while (txQueued != 0 && osMutexAcquire(uwbTxMutex, 10) == osOK)
             {
-                // 直接从全局buffer读取，避免拷贝
-                tx_data.assign(txBuffer, txBuffer + txBufferLen);
+                // 取出最早写入的帧，空位立即可供下一帧写入
+                const TxSlot &slot = txRing[txHead];
+                tx_data.assign(slot.data, slot.data + slot.len);
+                const uint32_t stampTag = slot.stampTag;
+                txHead = static_cast<uint8_t>((txHead + 1) % UWB_TX_RING_DEPTH);
+                txQueued = txQueued - 1;
                 uint32_t currentTxCount = ++txCount; // 增加发送计数
 
                 osMutexRelease(uwbTxMutex);
@@ -132,7 +140,27 @@ void MasterComm::UwbCommTask()
                 // 只输出关键信息：发送第几包
                 elog_i(TAG, "tx #%lu", currentTxCount);
                 uwb->update();
-                uwb->data_transmit(tx_data);
+                // 与接收时间戳对称，紧接发送命令之前记录标记帧的发送时间（如Ping响应的T3）
+                if (stampTag != TX_STAMP_NONE)
+                {
+                    txStampTag = TX_STAMP_NONE;
+                    txStampUs = HptimerGetUs();
+                    txStampTag = stampTag;
+                }
+                // 只计发送命令本身的耗时（SPI传输、空口、命令往返），
+                // 帧在环形缓冲区中等待UWB任务调度的时间不属于链路开销
+                const uint64_t transmitStartUs = HptimerGetUs64();
+                if (uwb->data_transmit(tx_data))
+                {
+                    // 用于规划每时隙的分片
+                    const uint64_t elapsedUs = HptimerGetUs64() - transmitStartUs;
+                    if (elapsedUs <= LINK_SAMPLE_MAX_US && osMutexAcquire(uwbTxMutex, 10) == osOK)
+                    {
+                        linkEstimator.addSample(tx_data.size(), static_cast<uint32_t>(elapsedUs));
+                        linkSampleCount = linkEstimator.totalSamples();
+                        osMutexRelease(uwbTxMutex);
+                    }
+                }
             }
         }
 
@@ -188,6 +216,8 @@ void MasterComm::UwbCommTask()
 
         if (uwb->get_recv_data(buffer))
         {
+            // 尽早记录接收时间，排除后续任务排队的延迟
+            const uint32_t timestampUs = HptimerGetUs();
             size_t bufferSize = buffer.size();
             uint32_t timestamp = osKernelGetTickCount();
 
@@ -200,6 +230,7 @@ void MasterComm::UwbCommTask()
                 memcpy(rxBuffer, buffer.data(), dataSize);
                 rxBufferLen = dataSize;
                 rxTimestamp = timestamp;
+                rxTimestampUs = timestampUs;
 
                 osMutexRelease(uwbRxMutex);
 
@@ -213,6 +244,7 @@ void MasterComm::UwbCommTask()
                 rxMsg->dataLen = dataSize;
                 memcpy(rxMsg->data, buffer.data(), dataSize);
                 rxMsg->timestamp = timestamp;
+                rxMsg->timestampUs = timestampUs;
                 rxMsg->statusReg = 0;
                 uwbRxCallback(rxMsg.get());
             }
@@ -245,7 +277,9 @@ void MasterComm::UwbCommTask()
 
 MasterComm::MasterComm()
     : uwbCommTaskHandle(nullptr), uwbTxMutex(nullptr), uwbRxMutex(nullptr), uwbTxSemaphore(nullptr),
-      uwbRxSemaphore(nullptr), uwbRxCallback(nullptr), txBufferLen(0), rxBufferLen(0), rxTimestamp(0), txCount(0)
+      uwbRxSemaphore(nullptr), uwbRxCallback(nullptr), txRing{}, txHead(0), txQueued(0),
+      rxBufferLen(0), rxTimestamp(0), rxTimestampUs(0), txStampTag(TX_STAMP_NONE), txStampUs(0), txCount(0),
+      linkSampleCount(0)
 {
     Initialize();
 }
@@ -329,15 +363,64 @@ int MasterComm::SendData(const uint8_t *data, uint16_t len, uint32_t delayMs)
         return -1;
     }
 
-    // 获取互斥锁，直接写入全局buffer（避免队列拷贝）
+    // 获取互斥锁，直接写入发送环形缓冲区的空位
+    if (osMutexAcquire(uwbTxMutex, 100) != osOK)
+    {
+        return -2; // 获取互斥锁超时
+    }
+
+    // 环形缓冲区已满，不覆盖未发送的帧
+    if (txQueued >= UWB_TX_RING_DEPTH)
+    {
+        osMutexRelease(uwbTxMutex);
+        return -4;
+    }
+
+    // 直接拷贝到空位（只拷贝一次）
+    TxSlot &slot = txRing[(txHead + txQueued) % UWB_TX_RING_DEPTH];
+    memcpy(slot.data, data, len);
+    slot.len = len;
+    slot.stampTag = TX_STAMP_NONE;
+    txQueued = txQueued + 1;
+
+    osMutexRelease(uwbTxMutex);
+
+    // 释放信号量通知UWB任务有数据需要发送
+    osSemaphoreRelease(uwbTxSemaphore);
+
+    return 0;
+}
+
+int MasterComm::SendInPlace(const UwbTxFillFunc &fill, const uint32_t &stampTag)
+{
+    if (!fill)
+    {
+        return -1;
+    }
+
+    // 获取互斥锁，由调用方直接在发送环形缓冲区的空位中构建数据（零拷贝）
     if (osMutexAcquire(uwbTxMutex, 100) != osOK)
     {
         return -2; // 获取互斥锁超时
     }
 
-    // 直接拷贝到全局buffer（只拷贝一次，不需要队列）
-    memcpy(txBuffer, data, len);
-    txBufferLen = len;
+    // 环形缓冲区已满，不覆盖未发送的帧
+    if (txQueued >= UWB_TX_RING_DEPTH)
+    {
+        osMutexRelease(uwbTxMutex);
+        return -4;
+    }
+
+    TxSlot &slot = txRing[(txHead + txQueued) % UWB_TX_RING_DEPTH];
+    const uint16_t len = fill(slot.data, FRAME_LEN_MAX);
+    if (len == 0 || len > FRAME_LEN_MAX)
+    {
+        osMutexRelease(uwbTxMutex);
+        return -3; // 调用方未写入数据
+    }
+    slot.len = len;
+    slot.stampTag = stampTag;
+    txQueued = txQueued + 1;
 
     osMutexRelease(uwbTxMutex);
 
@@ -347,6 +430,40 @@ int MasterComm::SendData(const uint8_t *data, uint16_t len, uint32_t delayMs)
     return 0;
 }
 
+bool MasterComm::GetTxStamp(const uint32_t stampTag, uint32_t &transmitUs) const
+{
+    if (stampTag == TX_STAMP_NONE || txStampTag != stampTag)
+    {
+        return false;
+    }
+    transmitUs = txStampUs;
+    return true;
+}
+
+bool MasterComm::WaitTxSpace(uint32_t timeoutMs) const
+{
+    for (uint32_t waitedMs = 0; !HasTxSpace(); waitedMs++)
+    {
+        if (waitedMs >= timeoutMs)
+        {
+            return false;
+        }
+        osDelay(1);
+    }
+    return true;
+}
+
+bool MasterComm::GetLinkTiming(WhtsProtocol::LinkTiming &timing, uint32_t defaultPerByteNs)
+{
+    if (osMutexAcquire(uwbTxMutex, 100) != osOK)
+    {
+        return false;
+    }
+    const bool valid = linkEstimator.estimate(timing, defaultPerByteNs);
+    osMutexRelease(uwbTxMutex);
+    return valid;
+}
+
 int MasterComm::ReceiveData(uwbRxMsg *msg, uint32_t timeoutMs)
 {
     if (msg == nullptr)
@@ -370,6 +487,7 @@ int MasterComm::ReceiveData(uwbRxMsg *msg, uint32_t timeoutMs)
     msg->dataLen = rxBufferLen;
     memcpy(msg->data, rxBuffer, rxBufferLen);
     msg->timestamp = rxTimestamp;
+    msg->timestampUs = rxTimestampUs;
     msg->statusReg = 0;
 
     osMutexRelease(uwbRxMutex);
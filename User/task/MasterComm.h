@@ -1,7 +1,10 @@
 #ifndef UWB_TASK_H
 #define UWB_TASK_H
 
+#include "LinkPlanner.h"
 #include "cmsis_os2.h"
+#include "config.h"
+#include <functional>
 #include <stdint.h>
 
 #define FRAME_LEN_MAX 1016
@@ -11,20 +14,59 @@ typedef struct
 {
     uint16_t dataLen;
     uint8_t data[FRAME_LEN_MAX];
-    uint32_t timestamp; // 接收时间戳
+    uint32_t timestamp;   // 接收时间戳
+    uint32_t timestampUs; // 驱动收到数据的时间（HptimerGetUs，us），用于Ping和时间同步
     uint32_t statusReg; // 状态寄存器值
 } uwbRxMsg;
 
 // 接收数据回调函数指针
 typedef void (*UwbRxCallback)(const uwbRxMsg *msg);
 
+// 发送缓冲区填充函数：直接在发送缓冲区中构建数据，返回写入长度（0表示无数据）
+using UwbTxFillFunc = std::function<uint16_t(uint8_t *buffer, uint16_t capacity)>;
+
 class MasterComm
 {
   public:
     MasterComm();
     ~MasterComm();
 
+    // 不需要记录发送时间的帧
+    static constexpr uint32_t TX_STAMP_NONE = 0xFFFFFFFF;
+
     int SendData(const uint8_t *data, uint16_t len, uint32_t delayMs);
+    // stampTag不为TX_STAMP_NONE时，UWB任务发送该帧时记录发送时间（见GetTxStamp）
+    // stampTag在fill返回后读取，fill可按实际写入的内容设置
+    int SendInPlace(const UwbTxFillFunc &fill, const uint32_t &stampTag = TX_STAMP_NONE);
+
+    // 最近一个带标记的帧的发送时间（HptimerGetUs，紧接发送命令之前记录，与接收时间戳对称），
+    // 该帧的标记不是stampTag或尚未发送时返回false
+    bool GetTxStamp(uint32_t stampTag, uint32_t &transmitUs) const;
+
+    // 发送环形缓冲区中有尚未被UWB任务取走的帧
+    bool IsTxPending() const
+    {
+        return txQueued != 0;
+    }
+
+    // 发送环形缓冲区有空位（已满时SendData/SendInPlace返回-4，不覆盖未发送的帧）
+    bool HasTxSpace() const
+    {
+        return txQueued < UWB_TX_RING_DEPTH;
+    }
+
+    // 等待发送环形缓冲区出现空位，超时返回false
+    // 会阻塞调用任务，不能在时隙回调中使用
+    bool WaitTxSpace(uint32_t timeoutMs) const;
+
+    // 由实测的发送耗时（UWB发送命令开始到完成）拟合的链路耗时，样本不足时返回false
+    bool GetLinkTiming(WhtsProtocol::LinkTiming &timing, uint32_t defaultPerByteNs);
+    // 累计发送耗时样本数
+    uint32_t GetLinkSampleCount() const
+    {
+        return linkSampleCount;
+    }
+
     int ReceiveData(uwbRxMsg *msg, uint32_t timeoutMs);
     void SetRxCallback(UwbRxCallback callback);
 
@@ -43,14 +85,31 @@ class MasterComm
     osSemaphoreId_t uwbRxSemaphore; // 接收数据信号量（通知有数据）
     UwbRxCallback uwbRxCallback;    // 接收数据回调函数指针
 
-    // 全局buffer（避免队列拷贝）
-    uint8_t txBuffer[FRAME_LEN_MAX];
-    uint16_t txBufferLen;
+    // 发送环形缓冲区：调用方直接在空位中构建帧，UWB任务每次唤醒依次发出所有已写入的帧
+    struct TxSlot
+    {
+        uint8_t data[FRAME_LEN_MAX];
+        uint16_t len;
+        uint32_t stampTag; // 发送时记录时间的标记，TX_STAMP_NONE表示不记录
+    };
+    TxSlot txRing[UWB_TX_RING_DEPTH];
+    uint8_t txHead;            // 下一个待发送的帧
+    volatile uint8_t txQueued; // 已写入、尚未被UWB任务取走的帧数
+    // 接收buffer（避免队列拷贝）
     uint8_t rxBuffer[FRAME_LEN_MAX];
     uint16_t rxBufferLen;
     uint32_t rxTimestamp;
+    uint32_t rxTimestampUs;
+
+    // 最近一个带标记的帧的发送时间，先写时间后写标记，读取方优先级更高，读到标记即时间有效
+    volatile uint32_t txStampTag;
+    volatile uint32_t txStampUs;
 
     // 统计信息（用于日志输出）
     uint32_t txCount; // 已发送包计数
+
+    // 发送耗时统计（uwbTxMutex保护）
+    WhtsProtocol::LinkTimingEstimator linkEstimator;
+    volatile uint32_t linkSampleCount;
 };
 #endif /* UWB_TASK_H */
\ No newline at end of file
@@ -82,6 +82,312 @@ extern "C" {
 #define ENABLE_OTA_TASK                       0
 #endif
 
+/* Protocol Options ---------------------------------------------------------*/
+
+/**
+ * @brief 导通数据紧凑短ID寻址开关
+ * 
+ * 可选值：
+ *   0 - 导通数据使用完整4字节从机ID，每个分片都携带ID和DeviceStatus
+ *   1 - 分配短ID后，导通数据使用1字节短ID的紧凑帧头（主机需支持）
+ * 
+ * 默认值：0 (禁用)
+ */
+#ifndef ENABLE_SHORT_ID_ADDRESSING
+#define ENABLE_SHORT_ID_ADDRESSING            0
+#endif
+
+/**
+ * @brief 导通数据编码开关
+ * 
+ * 可选值：
+ *   0 - 导通数据按原始位图发送（COND_DATA_MSG）
+ *   1 - 导通数据在稀疏列表/游程/与上一周期异或中选择最小的编码发送（COND_DATA_ENC_MSG，主机需支持）
+ * 
+ * 默认值：0 (禁用)
+ */
+#ifndef ENABLE_CONDUCTION_ENCODING
+#define ENABLE_CONDUCTION_ENCODING            0
+#endif
+
+/**
+ * @brief 导通数据参考周期间隔
+ * 
+ * 启用导通数据编码时，每隔该周期数发送一次不与上一周期异或的数据，
+ * 主机丢失某个周期后最多经过该周期数即可恢复解码
+ * 
+ * 默认值：16
+ */
+#ifndef CONDUCTION_KEYFRAME_INTERVAL
+#define CONDUCTION_KEYFRAME_INTERVAL          16
+#endif
+
+/**
+ * @brief 导通数据边采集边发送
+ * 
+ * 启用后数据已就绪的分片直接从采集器的数据矩阵生成，在本周期的激活时隙中发送，
+ * 不必等到周期结束；编码需要整周期数据，启用ENABLE_CONDUCTION_ENCODING时不生效。
+ * 分片发送与采集在同一周期内交错进行，需在实际时隙配置下验证后再启用
+ * 
+ * 默认值：0 (禁用)
+ */
+#ifndef ENABLE_ROW_STREAMING
+#define ENABLE_ROW_STREAMING                  0
+#endif
+
+/* Transmit Scheduling Options ----------------------------------------------*/
+
+/**
+ * @brief 发送队列每个优先级的容量（条目数）
+ * 
+ * 优先级从高到低为：控制响应、遥测、导通数据分片，队列满时新条目被拒绝
+ * 
+ * 默认值：8
+ */
+#ifndef TX_QUEUE_CAPACITY
+#define TX_QUEUE_CAPACITY                     8
+#endif
+
+/**
+ * @brief 每个激活时隙可发送的字节数
+ * 
+ * 单个时隙内的链路容量，超出预算的分片留到下一个激活时隙发送
+ * 
+ * 默认值：1016 (一个UWB帧)
+ */
+#ifndef TX_SLOT_BYTE_BUDGET
+#define TX_SLOT_BYTE_BUDGET                   1016
+#endif
+
+/**
+ * @brief 激活时隙末尾的保护时间（微秒）
+ * 
+ * 时隙间隔扣除保护时间后为本时隙的发送时间预算，避免发送延续到其他从机的时隙
+ * 
+ * 默认值：1000
+ */
+#ifndef TX_SLOT_GUARD_US
+#define TX_SLOT_GUARD_US                      1000
+#endif
+
+/**
+ * @brief 控制响应的发送截止时间（毫秒）
+ * 
+ * 入队后超过该时间仍未发送的控制响应被丢弃
+ * 
+ * 默认值：2000
+ */
+#ifndef TX_CONTROL_DEADLINE_MS
+#define TX_CONTROL_DEADLINE_MS                2000
+#endif
+
+/**
+ * @brief 遥测消息的发送截止时间（毫秒）
+ * 
+ * 默认值：500
+ */
+#ifndef TX_TELEMETRY_DEADLINE_MS
+#define TX_TELEMETRY_DEADLINE_MS              500
+#endif
+
+/**
+ * @brief UWB发送环形缓冲区的帧数
+ * 
+ * 时隙回调的优先级高于UWB通信任务，回调中写入的帧在回调返回后才被发出；
+ * 一个激活时隙内按预算发送的帧数不超过该值，超出的条目留到下一个激活时隙
+ * 
+ * 默认值：4
+ */
+#ifndef UWB_TX_RING_DEPTH
+#define UWB_TX_RING_DEPTH                     4
+#endif
+
+/**
+ * @brief 直接发送时等待发送缓冲区空位的最长时间（毫秒）
+ * 
+ * 不经过发送队列的发送（非采集期间的响应、超过MTU的分片回退）在发送环形缓冲区已满时
+ * 等待UWB任务取走帧，超时后放弃发送；时隙回调中的发送不等待，留到下一个激活时隙
+ * 
+ * 默认值：20
+ */
+#ifndef TX_SPACE_WAIT_MS
+#define TX_SPACE_WAIT_MS                      20
+#endif
+
+/**
+ * @brief 导通数据分片的发送截止时间（采集周期数）
+ * 
+ * 分片可跨时隙续发，超过该周期数仍未发完的分片被丢弃，为新采集的数据让出时隙
+ * 
+ * 默认值：1
+ */
+#ifndef TX_BULK_DEADLINE_CYCLES
+#define TX_BULK_DEADLINE_CYCLES               1
+#endif
+
+/**
+ * @brief 按实测链路耗时自动规划分片帧长和每时隙分片数
+ * 
+ * 启用后MTU和每时隙发送字节数由LinkPlanner按时隙长度和实测耗时计算，
+ * 每时隙帧数不超过UWB_TX_RING_DEPTH；计划变化时向主机上报LinkPlanMessage（主机需支持），
+ * 禁用时使用固定的MTU和TX_SLOT_BYTE_BUDGET
+ * 
+ * 默认值：0 (禁用)
+ */
+#ifndef ENABLE_LINK_PLANNER
+#define ENABLE_LINK_PLANNER                   0
+#endif
+
+/**
+ * @brief 未启用链路规划或规划失败时的固定MTU（字节）
+ * 
+ * 默认值：800
+ */
+#ifndef LINK_DEFAULT_MTU
+#define LINK_DEFAULT_MTU                      800
+#endif
+
+/**
+ * @brief 实测样本不足时假定的每帧固定开销（微秒）
+ * 
+ * 包括UWB发送命令的往返和芯片状态切换
+ * 
+ * 默认值：1500
+ */
+#ifndef LINK_DEFAULT_FRAME_US
+#define LINK_DEFAULT_FRAME_US                 1500
+#endif
+
+/**
+ * @brief 实测样本不足或帧长过于集中时假定的每字节开销（纳秒）
+ * 
+ * 包括SPI传输和6.8Mbps空口时间
+ * 
+ * 默认值：2000
+ */
+#ifndef LINK_DEFAULT_BYTE_NS
+#define LINK_DEFAULT_BYTE_NS                  2000
+#endif
+
+/**
+ * @brief 规划的最小分片帧长（字节）
+ * 
+ * 帧长过小时分片数超过255，导通数据无法分片
+ * 
+ * 默认值：64
+ */
+#ifndef LINK_PLAN_MIN_FRAME
+#define LINK_PLAN_MIN_FRAME                   64
+#endif
+
+/**
+ * @brief 新增多少个实测样本后重新规划
+ * 
+ * 默认值：32
+ */
+#ifndef LINK_PLAN_RESAMPLE_COUNT
+#define LINK_PLAN_RESAMPLE_COUNT              32
+#endif
+
+/**
+ * @brief 重新规划的滞回（百分比）
+ * 
+ * 当前计划仍能在时隙内发完时，新计划的每时隙载荷需多出该比例才会替换，避免MTU来回切换
+ * 
+ * 默认值：5
+ */
+#ifndef LINK_PLAN_HYSTERESIS_PERCENT
+#define LINK_PLAN_HYSTERESIS_PERCENT          5
+#endif
+
+/**
+ * @brief 响应主机的标定命令标定线束稳定时间
+ * 
+ * 启用后收到SETTLE_CALIBRATE_MSG时，在未采集的间隙按实测的输入稳定时间设置驱动引脚到采样
+ * 之间的等待时间（标定约0.3~1秒，期间驱动采集引脚）；重新配置和计划启动不标定，
+ * 引脚数变化或未标定时等待COLLECT_SETTLE_MAX_US；禁用时忽略标定命令
+ * 
+ * 默认值：1 (启用)
+ */
+#ifndef ENABLE_SETTLE_CALIBRATION
+#define ENABLE_SETTLE_CALIBRATION             1
+#endif
+
+/**
+ * @brief 驱动引脚到采样之间的最短等待时间（微秒）
+ * 
+ * 标定从该值开始逐级加倍
+ * 
+ * 默认值：10
+ */
+#ifndef COLLECT_SETTLE_MIN_US
+#define COLLECT_SETTLE_MIN_US                 10
+#endif
+
+/**
+ * @brief 驱动引脚到采样之间的最长等待时间（微秒）
+ * 
+ * 作为标定的参考等待时间，标定失败时使用该值
+ * 
+ * 默认值：3000
+ */
+#ifndef COLLECT_SETTLE_MAX_US
+#define COLLECT_SETTLE_MAX_US                 3000
+#endif
+
+/**
+ * @brief 标定结果的余量（百分比）
+ * 
+ * 默认值：50
+ */
+#ifndef COLLECT_SETTLE_MARGIN_PERCENT
+#define COLLECT_SETTLE_MARGIN_PERCENT         50
+#endif
+
+/**
+ * @brief 每级等待时间重复扫描所有引脚的次数
+ * 
+ * 所有扫描的采样都与参考一致时该等待时间才视为稳定
+ * 
+ * 默认值：3
+ */
+#ifndef COLLECT_SETTLE_CAL_PASSES
+#define COLLECT_SETTLE_CAL_PASSES             3
+#endif
+
+/**
+ * @brief 导通采集使用74HC595/74HC165级联扩展芯片
+ * 
+ * 启用后采集引脚由SPI级联的扩展芯片驱动和读回，引脚数不再受HARDWARE_PIN_MAP限制
+ * （最多255个，受导通检测数量字段限制）；禁用时直接使用MCU GPIO（最多64个）
+ * 启用时需在CubeMX中配置EXPANDER_SPI_HANDLE对应的SPI，以及用户标签为
+ * EXPANDER_LATCH（595的RCLK）和EXPANDER_LOAD（165的SH/LD）的输出引脚；
+ * 每个595输出需经串联二极管接到采集引脚，每个165输入需接弱下拉电阻（见ShiftRegisterPinDriver）
+ * 
+ * 默认值：0 (禁用)
+ */
+#ifndef ENABLE_SHIFT_REGISTER_EXPANDER
+#define ENABLE_SHIFT_REGISTER_EXPANDER        0
+#endif
+
+/**
+ * @brief 扩展芯片链的SPI句柄
+ * 
+ * 默认值：hspi1
+ */
+#ifndef EXPANDER_SPI_HANDLE
+#define EXPANDER_SPI_HANDLE                   hspi1
+#endif
+
+/**
+ * @brief 扩展芯片链的级数（每级一片595和一片165，8个引脚）
+ * 
+ * 默认值：16 (128个引脚)
+ */
+#ifndef EXPANDER_CHIP_COUNT
+#define EXPANDER_CHIP_COUNT                   16
+#endif
+
 /* Task Stack Size Definitions -----------------------------------------------*/
 
 /**
@@ -1,6 +1,7 @@
 #ifndef WHTS_PROTOCOL_COMMON_H
 #define WHTS_PROTOCOL_COMMON_H
 
+#include <cstddef>
 #include <cstdint>
 
 namespace WhtsProtocol {
@@ -10,6 +11,39 @@ constexpr uint8_t FRAME_DELIMITER_1 = 0xAB;
 constexpr uint8_t FRAME_DELIMITER_2 = 0xCD;
 constexpr uint32_t BROADCAST_ID = 0xFFFFFFFF;
 
+// 帧头长度：delimiter(2) + packetId(1) + fragmentsSequence(1) +
+// moreFragmentsFlag(1) + packetLength(2)
+constexpr size_t FRAME_HEADER_SIZE = 7;
+
+// moreFragmentsFlag字节的最高位表示帧尾带CRC-32校验（packetLength包含校验的4字节）
+// 仅在对端支持时发送，旧设备只使用该字节的0/1取值
+constexpr uint8_t FRAME_FLAG_CRC32 = 0x80;
+constexpr size_t FRAME_CRC_SIZE = 4;
+
+// 载荷前缀长度
+constexpr size_t MESSAGE_ID_PREFIX_SIZE = 1; // messageId
+constexpr size_t ADDRESSED_PREFIX_SIZE = 5;  // messageId + ID
+constexpr size_t STATUS_PREFIX_SIZE = 7;     // messageId + ID + status
+
+// moreFragmentsFlag字节的bit6表示紧凑短ID头（仅Slave2Master带DeviceStatus的消息）：
+//   首个分片载荷: messageId(1) + shortId(1) + status(2) + 数据
+//   后续分片载荷: shortId(1) + fragmentOffset(1) + 数据
+// fragmentOffset为该分片数据在重组流 [messageId + status + 消息体] 中的字节偏移除以8，
+// 接收端据此校验分片是否属于同一分片流；最后一个分片的偏移超过255*8字节时
+// 不能使用紧凑帧，发送端改用标准帧
+constexpr uint8_t FRAME_FLAG_SHORT_ID = 0x40;
+constexpr size_t COMPACT_FIRST_PREFIX_SIZE = 4; // messageId + shortId + status
+constexpr size_t COMPACT_NEXT_PREFIX_SIZE = 2;  // shortId + fragmentOffset
+constexpr size_t COMPACT_OFFSET_SHIFT = 3;      // fragmentOffset单位为8字节
+constexpr size_t COMPACT_MAX_FRAGMENT_OFFSET = 0xFF;
+
+// moreFragmentsFlag字节的bit0为还有后续分片，bit1~bit5为导通数据分片的周期号（按周期0~31循环），
+// 同一组数据分片和校验分片的周期号相同；主机在分片重传请求中回传该周期号，
+// 从机据此拒绝针对已被新数据替换的旧周期的迟到或重复请求
+constexpr uint8_t FRAME_FLAG_MORE_FRAGMENTS = 0x01;
+constexpr uint8_t FRAME_CYCLE_MASK = 0x3E;
+constexpr uint8_t FRAME_CYCLE_SHIFT = 1;
+
 // Packet ID 枚举
 enum class PacketId : uint8_t {
     MASTER_TO_SLAVE = 0x00,
@@ -21,8 +55,11 @@ enum class PacketId : uint8_t {
 // Master2Slave Message ID 枚举
 enum class Master2SlaveMessageId : uint8_t {
     SYNC_MSG = 0x00,
+    COMPACT_SYNC_MSG = 0x01,
     PING_REQ_MSG = 0x40,
     SHORT_ID_ASSIGN_MSG = 0x50,
+    FRAGMENT_NACK_MSG = 0x60,
+    SETTLE_CALIBRATE_MSG = 0x70,
 };
 
 // Slave2Master Message ID 枚举
@@ -33,6 +70,9 @@ enum class Slave2MasterMessageId : uint8_t {
     SHORT_ID_CONFIRM_MSG = 0x51,
     HEARTBEAT_MSG = 0x52,
     COND_DATA_MSG = 0x53,
+    COND_PARITY_MSG = 0x54,
+    COND_DATA_ENC_MSG = 0x55,
+    LINK_PLAN_MSG = 0x56,
 };
 
 // Backend2Master Message ID 枚举
@@ -0,0 +1,219 @@
+#include "ConductionCodec.h"
+
+#include <cstring>
+
+namespace WhtsProtocol {
+namespace ConductionCodec {
+
+namespace {
+
+size_t varintSize(size_t value) {
+    size_t size = 1;
+    while (value >= 0x80) {
+        value >>= 7;
+        ++size;
+    }
+    return size;
+}
+
+void writeVarint(std::vector<uint8_t> &out, size_t value) {
+    while (value >= 0x80) {
+        out.push_back(static_cast<uint8_t>(value | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<uint8_t>(value));
+}
+
+bool readVarint(const uint8_t *&in, const uint8_t *end, size_t &value) {
+    value = 0;
+    for (size_t shift = 0; in < end && shift < 8 * sizeof(size_t); shift += 7) {
+        uint8_t byte = *in++;
+        value |= static_cast<size_t>(byte & 0x7F) << shift;
+        if ((byte & 0x80) == 0) return true;
+    }
+    return false;
+}
+
+// 按位序遍历置位位置，零字节整体跳过
+template <typename Visitor>
+void forEachSetBit(const uint8_t *data, size_t length, Visitor &&visit) {
+    for (size_t byteIndex = 0; byteIndex < length; ++byteIndex) {
+        uint8_t byte = data[byteIndex];
+        while (byte != 0) {
+            unsigned bit = static_cast<unsigned>(__builtin_clz(byte)) - 24;
+            visit(byteIndex * 8 + bit);
+            byte &= static_cast<uint8_t>(~(0x80u >> bit));
+        }
+    }
+}
+
+// 按位序遍历游程边界（位值发生变化的位置）
+template <typename Visitor>
+void forEachRun(const uint8_t *data, size_t length, Visitor &&visit) {
+    uint8_t current = 0;
+    size_t runStart = 0;
+    for (size_t byteIndex = 0; byteIndex < length; ++byteIndex) {
+        uint8_t byte = data[byteIndex];
+        // 整字节与当前游程相同时跳过
+        if (byte == (current ? 0xFF : 0x00)) continue;
+        for (unsigned bit = 0; bit < 8; ++bit) {
+            uint8_t value = (byte >> (7 - bit)) & 1;
+            if (value != current) {
+                size_t position = byteIndex * 8 + bit;
+                visit(position - runStart);
+                runStart = position;
+                current = value;
+            }
+        }
+    }
+    visit(length * 8 - runStart);
+}
+
+void encodeSparse(const uint8_t *data, size_t length, std::vector<uint8_t> &out) {
+    size_t previous = 0;
+    forEachSetBit(data, length, [&](size_t position) {
+        writeVarint(out, position - previous);
+        previous = position + 1;
+    });
+}
+
+void encodeRle(const uint8_t *data, size_t length, std::vector<uint8_t> &out) {
+    forEachRun(data, length, [&](size_t run) { writeVarint(out, run); });
+}
+
+bool decodeSparse(const uint8_t *in, size_t inLength, uint8_t *out,
+                  size_t rawLength) {
+    const uint8_t *end = in + inLength;
+    size_t position = 0;
+    while (in < end) {
+        size_t gap = 0;
+        if (!readVarint(in, end, gap)) return false;
+        position += gap;
+        if (position >= rawLength * 8) return false;
+        out[position / 8] |= static_cast<uint8_t>(0x80u >> (position % 8));
+        ++position;
+    }
+    return true;
+}
+
+bool decodeRle(const uint8_t *in, size_t inLength, uint8_t *out,
+               size_t rawLength) {
+    const uint8_t *end = in + inLength;
+    size_t position = 0;
+    uint8_t value = 0;
+    while (in < end) {
+        size_t run = 0;
+        if (!readVarint(in, end, run)) return false;
+        if (run > rawLength * 8 - position) return false;
+        if (value) {
+            for (size_t i = position; i < position + run; ++i) {
+                out[i / 8] |= static_cast<uint8_t>(0x80u >> (i % 8));
+            }
+        }
+        position += run;
+        value ^= 1;
+    }
+    return position == rawLength * 8;
+}
+
+// 在已选的最小长度基础上比较候选编码
+void consider(const uint8_t *data, size_t length, uint8_t xorFlag,
+              uint8_t &bestEncoding, size_t &bestSize, const uint8_t *&bestData) {
+    size_t sparse = sparseSize(data, length);
+    if (sparse < bestSize) {
+        bestEncoding = ENCODING_SPARSE | xorFlag;
+        bestSize = sparse;
+        bestData = data;
+    }
+    size_t rle = rleSize(data, length);
+    if (rle < bestSize) {
+        bestEncoding = ENCODING_RLE | xorFlag;
+        bestSize = rle;
+        bestData = data;
+    }
+}
+
+} // namespace
+
+size_t sparseSize(const uint8_t *data, size_t length) {
+    size_t size = 0;
+    size_t previous = 0;
+    forEachSetBit(data, length, [&](size_t position) {
+        size += varintSize(position - previous);
+        previous = position + 1;
+    });
+    return size;
+}
+
+size_t rleSize(const uint8_t *data, size_t length) {
+    size_t size = 0;
+    forEachRun(data, length, [&](size_t run) { size += varintSize(run); });
+    return size;
+}
+
+uint8_t encode(const uint8_t *data, size_t length, const uint8_t *previous,
+               std::vector<uint8_t> &scratch, std::vector<uint8_t> &out) {
+    uint8_t bestEncoding = ENCODING_RAW;
+    size_t bestSize = length;
+    const uint8_t *bestData = data;
+
+    consider(data, length, 0, bestEncoding, bestSize, bestData);
+    if (previous != nullptr) {
+        scratch.resize(length);
+        for (size_t i = 0; i < length; ++i) {
+            scratch[i] = data[i] ^ previous[i];
+        }
+        consider(scratch.data(), length, ENCODING_XOR_PREVIOUS, bestEncoding,
+                 bestSize, bestData);
+    }
+
+    out.clear();
+    out.reserve(bestSize);
+    switch (bestEncoding & ENCODING_METHOD_MASK) {
+        case ENCODING_SPARSE:
+            encodeSparse(bestData, length, out);
+            break;
+        case ENCODING_RLE:
+            encodeRle(bestData, length, out);
+            break;
+        default:
+            out.assign(data, data + length);
+            break;
+    }
+    return bestEncoding;
+}
+
+bool decode(uint8_t encoding, const uint8_t *in, size_t inLength,
+            size_t rawLength, const uint8_t *previous,
+            std::vector<uint8_t> &out) {
+    bool usesPrevious = (encoding & ENCODING_XOR_PREVIOUS) != 0;
+    if (usesPrevious && previous == nullptr) return false;
+
+    out.assign(rawLength, 0);
+    bool ok = false;
+    switch (encoding & ENCODING_METHOD_MASK) {
+        case ENCODING_RAW:
+            ok = (inLength == rawLength);
+            if (ok && rawLength > 0) std::memcpy(out.data(), in, rawLength);
+            break;
+        case ENCODING_SPARSE:
+            ok = decodeSparse(in, inLength, out.data(), rawLength);
+            break;
+        case ENCODING_RLE:
+            ok = decodeRle(in, inLength, out.data(), rawLength);
+            break;
+        default:
+            break;
+    }
+    if (!ok) return false;
+
+    if (usesPrevious) {
+        for (size_t i = 0; i < rawLength; ++i) {
+            out[i] ^= previous[i];
+        }
+    }
+    return true;
+}
+
+} // namespace ConductionCodec
+} // namespace WhtsProtocol
@@ -0,0 +1,44 @@
+#ifndef WHTS_PROTOCOL_CONDUCTION_CODEC_H
+#define WHTS_PROTOCOL_CONDUCTION_CODEC_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace WhtsProtocol {
+
+// 导通矩阵无损编码
+// 输入为 ContinuityCollector::GetDataVector 的按位打包数据（每字节高位在前），
+// 位序号 i 对应第 i / 8 字节的第 7 - i % 8 位。导通矩阵绝大多数位为0，
+// 因此提供按位置编码的稀疏列表和游程编码，并可先与上一周期数据异或（只编码变化的位）。
+// 编码标志随消息发送，主机按标志解码任意一种编码
+// 均为纯函数，不依赖协议对象，可在主机上直接测试和评估性能
+namespace ConductionCodec {
+
+// 编码标志
+constexpr uint8_t ENCODING_RAW = 0x00;          // 原始按位打包数据
+constexpr uint8_t ENCODING_SPARSE = 0x01;       // 置位位置列表：相邻位置差值的变长整数
+constexpr uint8_t ENCODING_RLE = 0x02;          // 游程：从0开始交替的0/1游程长度的变长整数
+constexpr uint8_t ENCODING_METHOD_MASK = 0x0F;
+constexpr uint8_t ENCODING_XOR_PREVIOUS = 0x80; // 先与上一周期数据异或
+
+// 选择编码后长度最小的方式写入out，返回编码标志
+// previous为上一周期的原始数据（与data等长），为nullptr时不尝试异或
+// scratch用于异或结果，调用方复用以避免每周期分配
+uint8_t encode(const uint8_t *data, size_t length, const uint8_t *previous,
+               std::vector<uint8_t> &scratch, std::vector<uint8_t> &out);
+
+// 按编码标志还原rawLength字节的原始数据，带异或标志时需要previous
+bool decode(uint8_t encoding, const uint8_t *in, size_t inLength,
+            size_t rawLength, const uint8_t *previous,
+            std::vector<uint8_t> &out);
+
+// 各编码方式的长度（不写数据），用于选择编码和评估压缩率
+size_t sparseSize(const uint8_t *data, size_t length);
+size_t rleSize(const uint8_t *data, size_t length);
+
+} // namespace ConductionCodec
+
+} // namespace WhtsProtocol
+
+#endif // WHTS_PROTOCOL_CONDUCTION_CODEC_H
@@ -0,0 +1,75 @@
+#include "FragmentParity.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace WhtsProtocol {
+namespace FragmentParity {
+
+namespace {
+
+// 将数据块 index 异或到 out（最后一块只异或实际长度，其余视为0）
+void xorChunk(const uint8_t *data, size_t dataLength, size_t chunkSize,
+              size_t index, uint8_t *out) {
+    size_t start = index * chunkSize;
+    size_t length = std::min(chunkSize, dataLength - start);
+    for (size_t i = 0; i < length; ++i) {
+        out[i] ^= data[start + i];
+    }
+}
+
+} // namespace
+
+size_t chunkCount(size_t dataLength, size_t chunkSize) {
+    if (chunkSize == 0) return 0;
+    return (dataLength + chunkSize - 1) / chunkSize;
+}
+
+void encode(const uint8_t *data, size_t dataLength, size_t chunkSize,
+            uint8_t parityCount, uint8_t parityIndex, uint8_t *out) {
+    std::memset(out, 0, chunkSize);
+    if (parityCount == 0 || parityIndex >= parityCount) return;
+
+    size_t chunks = chunkCount(dataLength, chunkSize);
+    for (size_t i = parityIndex; i < chunks; i += parityCount) {
+        xorChunk(data, dataLength, chunkSize, i, out);
+    }
+}
+
+bool recover(uint8_t *data, size_t dataLength, size_t chunkSize,
+             std::vector<bool> &received, uint8_t parityCount,
+             uint8_t parityIndex, const uint8_t *parity) {
+    if (parityCount == 0 || parityIndex >= parityCount) return false;
+
+    size_t chunks = chunkCount(dataLength, chunkSize);
+    if (received.size() < chunks) return false;
+
+    // 组内只能恢复一个丢失的数据块
+    size_t missing = chunks;
+    for (size_t i = parityIndex; i < chunks; i += parityCount) {
+        if (!received[i]) {
+            if (missing != chunks) return false;
+            missing = i;
+        }
+    }
+    if (missing == chunks) return false;
+
+    // 丢失块 = 校验块 ^ 组内其余数据块，直接在data中的目标位置累积
+    size_t start = missing * chunkSize;
+    size_t length = std::min(chunkSize, dataLength - start);
+    std::memcpy(data + start, parity, length);
+    for (size_t i = parityIndex; i < chunks; i += parityCount) {
+        if (i != missing) {
+            const uint8_t *chunk = data + i * chunkSize;
+            size_t chunkLength = std::min(chunkSize, dataLength - i * chunkSize);
+            for (size_t j = 0; j < std::min(length, chunkLength); ++j) {
+                data[start + j] ^= chunk[j];
+            }
+        }
+    }
+    received[missing] = true;
+    return true;
+}
+
+} // namespace FragmentParity
+} // namespace WhtsProtocol
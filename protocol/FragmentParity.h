@@ -0,0 +1,35 @@
+#ifndef WHTS_PROTOCOL_FRAGMENT_PARITY_H
+#define WHTS_PROTOCOL_FRAGMENT_PARITY_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace WhtsProtocol {
+
+// 导通数据分片的前向纠错（交织XOR校验）
+// 导通数据按chunkSize切成k个等长数据块（最后一块不足部分按0填充），
+// 数据块 i 属于第 i % parityCount 组，每组生成一个XOR校验块，
+// 每组丢失一个数据块时可由校验块恢复，无需主机请求重传
+// 均为纯函数，不依赖协议对象，可在主机上直接测试和评估性能
+namespace FragmentParity {
+
+// 数据块个数
+size_t chunkCount(size_t dataLength, size_t chunkSize);
+
+// 计算第parityIndex组的校验块，out长度为chunkSize
+void encode(const uint8_t *data, size_t dataLength, size_t chunkSize,
+            uint8_t parityCount, uint8_t parityIndex, uint8_t *out);
+
+// 用第parityIndex组的校验块恢复该组中丢失的数据块
+// data为按chunkSize划分的完整数据缓冲区（dataLength字节），received[i]标记数据块i是否已收到
+// 组内恰好缺一个数据块时写回data并置位received，返回true
+bool recover(uint8_t *data, size_t dataLength, size_t chunkSize,
+             std::vector<bool> &received, uint8_t parityCount,
+             uint8_t parityIndex, const uint8_t *parity);
+
+} // namespace FragmentParity
+
+} // namespace WhtsProtocol
+
+#endif // WHTS_PROTOCOL_FRAGMENT_PARITY_H
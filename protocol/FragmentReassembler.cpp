@@ -0,0 +1,384 @@
+#include "FragmentReassembler.h"
+
+#include <algorithm>
+#include <cstring>
+#include "elog.h"
+
+namespace WhtsProtocol {
+
+FragmentReassembler::FragmentReassembler()
+    : activityCounter_(0), bufferedBytes_(0),
+      byteBudget_(MAX_ENTRIES * MAX_PAYLOAD_SIZE),
+      timeoutMs_(DEFAULT_TIMEOUT_MS), stats_() {
+    for (size_t i = 0; i < MAX_ENTRIES; ++i) {
+        entries_[i] = Entry();
+        entries_[i].data = slab_ + i * MAX_PAYLOAD_SIZE;
+    }
+}
+
+void FragmentReassembler::setByteBudget(size_t bytes) {
+    byteBudget_ = std::min(bytes, MAX_ENTRIES * MAX_PAYLOAD_SIZE);
+    while (bufferedBytes_ > byteBudget_ && evictLeastRecent(nullptr)) {
+    }
+}
+
+bool FragmentReassembler::addFragment(const Frame &fragment,
+                                      ReassembledFrame &completeFrame) {
+    FragmentKey key = {};
+    key.valid = readKey(fragment, key.messageId, key.sourceId);
+    return addFragment(fragment.packetId, key, fragment.fragmentsSequence,
+                       (fragment.moreFragmentsFlag & FRAME_FLAG_MORE_FRAGMENTS) != 0,
+                       fragment.payload.data(),
+                       fragment.payload.size(), completeFrame);
+}
+
+bool FragmentReassembler::addFragment(uint8_t packetId, uint8_t messageId,
+                                      uint32_t sourceId, uint8_t sequence,
+                                      bool moreFragments, const uint8_t *data,
+                                      size_t length,
+                                      ReassembledFrame &completeFrame) {
+    FragmentKey key = {};
+    key.valid = true;
+    key.exact = true;
+    key.messageId = messageId;
+    key.sourceId = sourceId;
+    return addFragment(packetId, key, sequence, moreFragments, data, length,
+                       completeFrame);
+}
+
+bool FragmentReassembler::addFragment(uint8_t packetId, const FragmentKey &key,
+                                      uint8_t sequence, bool moreFragments,
+                                      const uint8_t *data, size_t length,
+                                      ReassembledFrame &completeFrame) {
+    if (sequence >= MAX_FRAGMENTS) {
+        elog_w("FragmentReassembler",
+               "Fragment sequence %d exceeds limit %d, dropping", sequence,
+               MAX_FRAGMENTS);
+        return false;
+    }
+
+    Entry *entry = lookupEntry(packetId, key, sequence);
+    if (entry == nullptr) {
+        elog_e("FragmentReassembler",
+               "First fragment payload too small to extract source ID, "
+               "payload size: %d",
+               length);
+        return false;
+    }
+
+    // 新分片需要占用字节预算，不足时按LRU替换其他分片流
+    bool isNewFragment = !(entry->receivedBitmap & (1UL << sequence));
+    if (isNewFragment && !reserveBytes(*entry, length)) {
+        elog_w("FragmentReassembler",
+               "Byte budget %d exceeded, dropping stream MessageId: 0x%02X, "
+               "SourceId: 0x%08X",
+               byteBudget_, entry->messageId, entry->sourceId);
+        stats_.evicted++;
+        resetEntry(*entry);
+        return false;
+    }
+
+    if (!storeFragment(*entry, sequence, moreFragments, data, length)) {
+        elog_w("FragmentReassembler",
+               "Inconsistent fragment, sequence: %d, payload size: %d, "
+               "discarding stream",
+               sequence, length);
+        resetEntry(*entry);
+        return false;
+    }
+
+    elog_v("FragmentReassembler",
+           "Stored fragment, sequence: %d, payload size: %d, bitmap: 0x%08X",
+           sequence, length, entry->receivedBitmap);
+
+    if (!entry->isComplete()) {
+        return false;    // Haven't collected all fragments yet
+    }
+
+    // 所有分片已在最终位置，直接交出条目区域，不拷贝载荷
+    // 复位条目只清除记录，区域内容要到下一个分片写入时才会被覆盖
+    size_t payloadLength =
+        (entry->totalFragments - 1) * entry->stride + entry->lastLength;
+    completeFrame.packetId = entry->packetId;
+    completeFrame.data = entry->data;
+    completeFrame.length = payloadLength;
+
+    elog_v("FragmentReassembler",
+           "Reassembly completed, MessageId: 0x%02X, SourceId: 0x%08X, "
+           "fragments: %d, payload size: %d",
+           entry->messageId, entry->sourceId, entry->totalFragments,
+           payloadLength);
+
+    stats_.completed++;
+    resetEntry(*entry);
+    return true;
+}
+
+void FragmentReassembler::cleanupExpired() {
+    if (!clock_) {
+        return;
+    }
+
+    uint32_t currentMs = now();
+    for (auto &entry : entries_) {
+        if (entry.inUse && currentMs - entry.lastUpdateMs > timeoutMs_) {
+            elog_w("FragmentReassembler",
+                   "Fragment stream expired, MessageId: 0x%02X, SourceId: "
+                   "0x%08X, bitmap: 0x%08X",
+                   entry.messageId, entry.sourceId, entry.receivedBitmap);
+            stats_.expired++;
+            resetEntry(entry);
+        }
+    }
+}
+
+void FragmentReassembler::clear() {
+    for (auto &entry : entries_) {
+        resetEntry(entry);
+    }
+}
+
+size_t FragmentReassembler::activeEntries() const {
+    size_t count = 0;
+    for (const auto &entry : entries_) {
+        if (entry.inUse) {
+            ++count;
+        }
+    }
+    return count;
+}
+
+FragmentReassembler::Entry *
+FragmentReassembler::lookupEntry(uint8_t packetId, const FragmentKey &key,
+                                 uint8_t sequence) {
+    const bool hasKey = key.valid;
+    const uint8_t messageId = key.messageId;
+    const uint32_t sourceId = key.sourceId;
+    uint32_t bit = 1UL << sequence;
+    Entry *found = nullptr;
+
+    if (sequence == 0) {
+        // 首个分片载荷格式为: MessageId + SourceId + ...
+        if (!hasKey) {
+            return nullptr;
+        }
+
+        for (auto &entry : entries_) {
+            if (entry.inUse && entry.keyed &&
+                entry.packetId == packetId &&
+                entry.messageId == messageId && entry.sourceId == sourceId) {
+                found = &entry;
+                break;
+            }
+        }
+        if (found != nullptr && (found->receivedBitmap & bit)) {
+            // 同一分片流又收到首个分片，说明上一条消息未完成，重新开始
+            elog_w("FragmentReassembler",
+                   "Restarting incomplete stream, MessageId: 0x%02X, "
+                   "SourceId: 0x%08X",
+                   messageId, sourceId);
+            resetEntry(*found);
+            found->inUse = true;
+            found->packetId = packetId;
+        }
+
+        // 续传分片先于首个分片到达时创建的条目，在此补全键值
+        if (found == nullptr && !key.exact) {
+            for (auto &entry : entries_) {
+                if (entry.inUse && !entry.keyed &&
+                    entry.packetId == packetId &&
+                    !(entry.receivedBitmap & bit)) {
+                    found = &entry;
+                    break;
+                }
+            }
+        }
+
+        if (found == nullptr) {
+            found = allocateEntry(packetId);
+        }
+        found->keyed = true;
+        found->messageId = messageId;
+        found->sourceId = sourceId;
+    } else {
+        // 每个分片都携带相同前缀的分片流（如COND_DATA_MSG）按键值精确匹配
+        if (hasKey) {
+            for (auto &entry : entries_) {
+                if (entry.inUse && entry.keyed &&
+                    entry.packetId == packetId &&
+                    entry.messageId == messageId &&
+                    entry.sourceId == sourceId &&
+                    !(entry.receivedBitmap & bit)) {
+                    found = &entry;
+                    break;
+                }
+            }
+        }
+
+        // 普通续传分片不携带前缀，归入同packetId中最近活动且缺少该分片的条目
+        if (found == nullptr && !key.exact) {
+            for (auto &entry : entries_) {
+                if (entry.inUse && entry.packetId == packetId &&
+                    !(entry.receivedBitmap & bit) &&
+                    (found == nullptr ||
+                     entry.lastActivity > found->lastActivity)) {
+                    found = &entry;
+                }
+            }
+        }
+
+        if (found == nullptr) {
+            found = allocateEntry(packetId);
+            if (key.exact) {
+                // 键值可靠时首个分片之前到达的分片也直接建立键值
+                found->keyed = true;
+                found->messageId = messageId;
+                found->sourceId = sourceId;
+            }
+        }
+    }
+
+    found->lastActivity = ++activityCounter_;
+    found->lastUpdateMs = now();
+    return found;
+}
+
+FragmentReassembler::Entry *
+FragmentReassembler::allocateEntry(uint8_t packetId) {
+    Entry *target = nullptr;
+    for (auto &entry : entries_) {
+        if (!entry.inUse) {
+            target = &entry;
+            break;
+        }
+        if (target == nullptr || entry.lastActivity < target->lastActivity) {
+            target = &entry;
+        }
+    }
+
+    if (target->inUse) {
+        elog_w("FragmentReassembler",
+               "Reassembly table full, replacing stream MessageId: 0x%02X, "
+               "SourceId: 0x%08X",
+               target->messageId, target->sourceId);
+        stats_.evicted++;
+    }
+
+    resetEntry(*target);
+    target->inUse = true;
+    target->packetId = packetId;
+    return target;
+}
+
+bool FragmentReassembler::storeFragment(Entry &entry, uint8_t sequence,
+                                        bool moreFragments,
+                                        const uint8_t *data, size_t length) {
+    if (moreFragments) {
+        // 除最后一个分片外，所有分片载荷长度相同，据此计算最终偏移
+        if (length == 0) {
+            return false;
+        }
+        if (entry.stride == 0) {
+            entry.stride = static_cast<uint16_t>(length);
+
+            // 最后一个分片先到达时暂存在区域末尾，现在移到最终偏移
+            if (entry.totalFragments > 0) {
+                size_t finalOffset = (entry.totalFragments - 1) * entry.stride;
+                if (finalOffset + entry.lastLength > MAX_PAYLOAD_SIZE) {
+                    return false;
+                }
+                std::memmove(entry.data + finalOffset,
+                             entry.data + MAX_PAYLOAD_SIZE - entry.lastLength,
+                             entry.lastLength);
+            }
+        } else if (length != entry.stride) {
+            return false;
+        }
+        if (entry.totalFragments > 0 && sequence >= entry.totalFragments - 1) {
+            return false;
+        }
+    } else {
+        if (entry.totalFragments > 0 && entry.totalFragments != sequence + 1) {
+            return false;
+        }
+        entry.totalFragments = sequence + 1;
+        entry.lastLength = static_cast<uint16_t>(length);
+        if (entry.receivedBitmap >> entry.totalFragments) {
+            return false;    // 已收到序号超过最后分片的分片
+        }
+    }
+
+    size_t offset = (entry.stride != 0) ? sequence * entry.stride
+                                        : MAX_PAYLOAD_SIZE - length;
+    if (length > MAX_PAYLOAD_SIZE || offset + length > MAX_PAYLOAD_SIZE) {
+        return false;
+    }
+
+    std::memcpy(entry.data + offset, data, length);
+    uint32_t bit = 1UL << sequence;
+    if (!(entry.receivedBitmap & bit)) {
+        entry.receivedBitmap |= bit;
+        entry.storedBytes += static_cast<uint16_t>(length);
+        bufferedBytes_ += length;
+    }
+    return true;
+}
+
+bool FragmentReassembler::reserveBytes(const Entry &entry, size_t length) {
+    while (bufferedBytes_ + length > byteBudget_) {
+        if (!evictLeastRecent(&entry)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool FragmentReassembler::evictLeastRecent(const Entry *keep) {
+    Entry *target = nullptr;
+    for (auto &entry : entries_) {
+        if (entry.inUse && &entry != keep &&
+            (target == nullptr || entry.lastActivity < target->lastActivity)) {
+            target = &entry;
+        }
+    }
+    if (target == nullptr) {
+        return false;
+    }
+
+    elog_w("FragmentReassembler",
+           "Evicting stream MessageId: 0x%02X, SourceId: 0x%08X, %d bytes",
+           target->messageId, target->sourceId, target->storedBytes);
+    stats_.evicted++;
+    resetEntry(*target);
+    return true;
+}
+
+void FragmentReassembler::resetEntry(Entry &entry) {
+    bufferedBytes_ -= entry.storedBytes;
+    entry.inUse = false;
+    entry.keyed = false;
+    entry.packetId = 0;
+    entry.messageId = 0;
+    entry.sourceId = 0;
+    entry.receivedBitmap = 0;
+    entry.totalFragments = 0;
+    entry.stride = 0;
+    entry.lastLength = 0;
+    entry.storedBytes = 0;
+    entry.lastActivity = 0;
+    entry.lastUpdateMs = 0;
+}
+
+bool FragmentReassembler::readKey(const Frame &fragment, uint8_t &messageId,
+                                  uint32_t &sourceId) {
+    if (fragment.payload.size() < 5) {
+        return false;
+    }
+    const uint8_t *p = fragment.payload.data();
+    messageId = p[0];
+    sourceId = p[1] | (p[2] << 8) | (p[3] << 16) |
+               (static_cast<uint32_t>(p[4]) << 24);
+    return true;
+}
+
+} // namespace WhtsProtocol
@@ -0,0 +1,144 @@
+#ifndef WHTS_PROTOCOL_FRAGMENT_REASSEMBLER_H
+#define WHTS_PROTOCOL_FRAGMENT_REASSEMBLER_H
+
+#include "Frame.h"
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+
+namespace WhtsProtocol {
+
+// 毫秒时钟，由平台注入（协议层不依赖具体定时器）
+using FragmentClockFunc = std::function<uint32_t()>;
+
+// 分片重组统计，用于评估字节预算和超时设置
+struct ReassemblyStats {
+    uint32_t completed; // 重组完成的帧数
+    uint32_t expired;   // 超时丢弃的分片流数
+    uint32_t evicted;   // 因条目或字节预算不足被替换的分片流数
+};
+
+// 重组完成的帧，载荷直接指向重组表内存而不拷贝
+// data在下一次调用addFragment之前有效，调用方需在此之前取走载荷
+struct ReassembledFrame {
+    uint8_t packetId;
+    const uint8_t *data;
+    size_t length;
+};
+
+// 分片重组表
+// 固定数量的重组条目，按 (packetId, sourceId, messageId) 区分不同的分片流，
+// 每个条目用位图记录已收到的分片，分片数据直接写入预分配连续内存中的最终偏移处
+class FragmentReassembler {
+  public:
+    static constexpr size_t MAX_ENTRIES = 4;         // 同时重组的分片流数量
+    static constexpr size_t MAX_PAYLOAD_SIZE = 2048; // 单个重组帧的最大载荷
+    static constexpr uint8_t MAX_FRAGMENTS = 32;     // 单个帧最大分片数（位图宽度）
+    static constexpr uint32_t DEFAULT_TIMEOUT_MS = 5000; // 默认分片超时时间
+
+    FragmentReassembler();
+
+    // 设置时钟，未设置时不做超时清理
+    void setClock(FragmentClockFunc clock) { clock_ = std::move(clock); }
+
+    // 设置分片流超时时间（毫秒）
+    void setTimeout(uint32_t timeoutMs) { timeoutMs_ = timeoutMs; }
+
+    // 设置所有条目已缓存分片的总字节预算，超出时按LRU替换其他分片流
+    void setByteBudget(size_t bytes);
+    size_t getByteBudget() const { return byteBudget_; }
+
+    // 处理一个分片帧，重组完成时写入completeFrame并返回true
+    // 分片流键值 (messageId, sourceId) 从载荷前5字节读取
+    bool addFragment(const Frame &fragment, ReassembledFrame &completeFrame);
+
+    // 处理一个键值由调用方给出的分片（如紧凑短ID分片），data只包含分片数据
+    bool addFragment(uint8_t packetId, uint8_t messageId, uint32_t sourceId,
+                     uint8_t sequence, bool moreFragments, const uint8_t *data,
+                     size_t length, ReassembledFrame &completeFrame);
+
+    // 丢弃超过超时时间未更新的分片流
+    void cleanupExpired();
+
+    // 清空所有重组条目（不清除统计）
+    void clear();
+
+    // 当前正在重组的条目数量
+    size_t activeEntries() const;
+
+    // 当前已缓存的分片字节数
+    size_t bufferedBytes() const { return bufferedBytes_; }
+
+    const ReassemblyStats &getStats() const { return stats_; }
+    void resetStats() { stats_ = {}; }
+
+  private:
+    struct FragmentKey {
+        bool valid;          // 分片是否携带键值
+        bool exact;          // 每个分片的键值都可靠（由调用方给出），只按键值精确匹配
+        uint8_t messageId;
+        uint32_t sourceId;
+    };
+
+    struct Entry {
+        bool inUse;
+        bool keyed;              // 是否已收到首个分片（确定了sourceId/messageId）
+        uint8_t packetId;
+        uint8_t messageId;
+        uint32_t sourceId;
+        uint32_t receivedBitmap; // 已收到的分片位图
+        uint8_t totalFragments;  // 总分片数，0表示尚未收到最后一个分片
+        uint16_t stride;         // 非最后分片的载荷长度，0表示未知
+        uint16_t lastLength;     // 最后一个分片的载荷长度
+        uint16_t storedBytes;    // 已缓存的分片字节数
+        uint32_t lastActivity;   // 最近一次更新的序号，用于LRU替换
+        uint32_t lastUpdateMs;   // 最近一次更新的时间，用于超时清理
+        uint8_t *data;           // 指向slab_中该条目的区域
+
+        bool isComplete() const {
+            return totalFragments > 0 &&
+                   receivedBitmap == ((1ULL << totalFragments) - 1);
+        }
+    };
+
+    bool addFragment(uint8_t packetId, const FragmentKey &key,
+                     uint8_t sequence, bool moreFragments, const uint8_t *data,
+                     size_t length, ReassembledFrame &completeFrame);
+
+    // 查找分片所属条目，找不到时分配新条目
+    Entry *lookupEntry(uint8_t packetId, const FragmentKey &key,
+                       uint8_t sequence);
+
+    // 分配条目（无空闲条目时替换最久未更新的条目）
+    Entry *allocateEntry(uint8_t packetId);
+
+    // 将分片写入条目的最终偏移处
+    bool storeFragment(Entry &entry, uint8_t sequence, bool moreFragments,
+                       const uint8_t *data, size_t length);
+
+    // 为entry腾出length字节的预算，必要时按LRU替换其他分片流
+    bool reserveBytes(const Entry &entry, size_t length);
+
+    // 替换最久未更新的分片流（不包括keep），没有可替换条目时返回false
+    bool evictLeastRecent(const Entry *keep);
+
+    uint32_t now() const { return clock_ ? clock_() : 0; }
+
+    void resetEntry(Entry &entry);
+
+    static bool readKey(const Frame &fragment, uint8_t &messageId,
+                        uint32_t &sourceId);
+
+    Entry entries_[MAX_ENTRIES];
+    uint8_t slab_[MAX_ENTRIES * MAX_PAYLOAD_SIZE]; // 所有条目共享的连续内存
+    uint32_t activityCounter_;
+    size_t bufferedBytes_;
+    size_t byteBudget_;
+    uint32_t timeoutMs_;
+    FragmentClockFunc clock_;
+    ReassemblyStats stats_;
+};
+
+} // namespace WhtsProtocol
+
+#endif // WHTS_PROTOCOL_FRAGMENT_REASSEMBLER_H
@@ -0,0 +1,104 @@
+#include "LinkPlanner.h"
+
+#include <algorithm>
+
+namespace WhtsProtocol {
+
+void LinkTimingEstimator::addSample(size_t frameSize, uint32_t elapsedUs) {
+    if (count_ >= WINDOW) {
+        count_ /= 2;
+        sumX_ /= 2;
+        sumY_ /= 2;
+        sumXX_ /= 2;
+        sumXY_ /= 2;
+    }
+    uint64_t x = frameSize;
+    count_++;
+    sumX_ += x;
+    sumY_ += elapsedUs;
+    sumXX_ += x * x;
+    sumXY_ += x * elapsedUs;
+    total_++;
+}
+
+bool LinkTimingEstimator::estimate(LinkTiming &timing,
+                                   uint32_t defaultPerByteNs) const {
+    if (count_ < MIN_SAMPLES) {
+        return false;
+    }
+
+    int64_t n = count_;
+    int64_t varX = n * static_cast<int64_t>(sumXX_) -
+                   static_cast<int64_t>(sumX_) * static_cast<int64_t>(sumX_);
+    int64_t perByteNs = defaultPerByteNs;
+    if (varX >= n * n * MIN_SPREAD * MIN_SPREAD) {
+        int64_t covXY = n * static_cast<int64_t>(sumXY_) -
+                        static_cast<int64_t>(sumX_) * static_cast<int64_t>(sumY_);
+        perByteNs = std::max<int64_t>(0, covXY * 1000 / varX);
+    }
+
+    // 截距 = 平均耗时 - 每字节开销 * 平均帧长
+    int64_t perFrameUs = (static_cast<int64_t>(sumY_) * 1000 -
+                          perByteNs * static_cast<int64_t>(sumX_)) /
+                         (n * 1000);
+    timing.perFrameUs = static_cast<uint32_t>(std::max<int64_t>(0, perFrameUs));
+    timing.perByteNs = static_cast<uint32_t>(std::min<int64_t>(perByteNs, UINT32_MAX));
+    return true;
+}
+
+namespace LinkPlanner {
+
+bool plan(const LinkTiming &timing, uint32_t budgetUs, size_t overhead,
+          size_t minFrame, size_t maxFrame, size_t maxFrames, LinkPlan &result) {
+    minFrame = std::max(minFrame, overhead + 1);
+    maxFrame = std::min<size_t>(maxFrame, 0xFFFF);
+    if (minFrame > maxFrame || timing.frameCostUs(minFrame) > budgetUs) {
+        return false;
+    }
+
+    LinkPlan best;
+    size_t bestPayload = 0;
+    maxFrames = std::min<size_t>(maxFrames, 0xFF);
+    for (size_t frames = 1; frames <= maxFrames; ++frames) {
+        uint64_t perFrameBudgetUs = budgetUs / frames;
+        if (perFrameBudgetUs < timing.perFrameUs) {
+            break;
+        }
+
+        size_t frameSize = maxFrame;
+        if (timing.perByteNs != 0) {
+            uint64_t bytes = (perFrameBudgetUs - timing.perFrameUs) * 1000 /
+                             timing.perByteNs;
+            frameSize = static_cast<size_t>(std::min<uint64_t>(bytes, maxFrame));
+        }
+        // 向上取整的耗时可能比按字节数估计的多1us
+        while (frameSize >= minFrame &&
+               static_cast<uint64_t>(timing.frameCostUs(frameSize)) * frames > budgetUs) {
+            frameSize--;
+        }
+        if (frameSize < minFrame) {
+            break;
+        }
+
+        size_t payload = frames * (frameSize - overhead);
+        if (payload > bestPayload) {
+            bestPayload = payload;
+            best.frameSize = static_cast<uint16_t>(frameSize);
+            best.framesPerSlot = static_cast<uint8_t>(frames);
+            best.slotPayload = static_cast<uint16_t>(std::min<size_t>(payload, 0xFFFF));
+        }
+    }
+
+    result = best;
+    return best.isValid();
+}
+
+bool fits(const LinkTiming &timing, uint32_t budgetUs, const LinkPlan &plan) {
+    return plan.isValid() &&
+           static_cast<uint64_t>(timing.frameCostUs(plan.frameSize)) *
+                   plan.framesPerSlot <= budgetUs;
+}
+
+} // namespace LinkPlanner
+
+} // namespace WhtsProtocol
@@ -0,0 +1,77 @@
+#ifndef WHTS_PROTOCOL_LINK_PLANNER_H
+#define WHTS_PROTOCOL_LINK_PLANNER_H
+
+#include <cstddef>
+#include <cstdint>
+
+namespace WhtsProtocol {
+
+// 链路发送耗时模型：发送一帧的耗时 = perFrameUs + perByteNs * 帧长 / 1000
+struct LinkTiming {
+    uint32_t perFrameUs = 0; // 每帧固定开销（命令往返、芯片状态切换）
+    uint32_t perByteNs = 0;  // 每字节开销（SPI传输、空口）
+
+    uint32_t frameCostUs(size_t frameSize) const {
+        return perFrameUs +
+               static_cast<uint32_t>((static_cast<uint64_t>(perByteNs) * frameSize + 999) / 1000);
+    }
+};
+
+// 按链路耗时得到的分片计划
+struct LinkPlan {
+    uint16_t frameSize = 0;    // 分片帧长（即MTU）
+    uint8_t framesPerSlot = 0; // 每个激活时隙可发送的分片数
+    uint16_t slotPayload = 0;  // 每个激活时隙可发送的导通数据字节数
+
+    bool isValid() const { return frameSize != 0 && framesPerSlot != 0; }
+    size_t slotBytes() const { return static_cast<size_t>(frameSize) * framesPerSlot; }
+};
+
+// 由实测的 (帧长, 耗时) 样本最小二乘拟合 LinkTiming
+// 样本数达到窗口大小后所有累加量减半，较早的样本权重逐渐降低，跟随数据速率等配置变化
+// 不加锁，由调用方保证样本写入与读取互斥
+class LinkTimingEstimator {
+  public:
+    static constexpr uint32_t WINDOW = 64;      // 累加量减半前的样本数
+    static constexpr uint32_t MIN_SAMPLES = 8;  // 可以给出估计的最少样本数
+    static constexpr uint32_t MIN_SPREAD = 32;  // 拟合每字节开销所需的帧长标准差（字节）
+
+    void addSample(size_t frameSize, uint32_t elapsedUs);
+
+    // 样本不足时返回false；帧长过于集中无法区分两项开销时，
+    // 每字节开销取defaultPerByteNs，只拟合每帧开销
+    bool estimate(LinkTiming &timing, uint32_t defaultPerByteNs) const;
+
+    // 累计样本数（不随窗口减半），用于判断是否需要重新规划
+    uint32_t totalSamples() const { return total_; }
+
+    void reset() { *this = LinkTimingEstimator(); }
+
+  private:
+    uint32_t count_ = 0;
+    uint64_t sumX_ = 0;
+    uint64_t sumY_ = 0;
+    uint64_t sumXX_ = 0;
+    uint64_t sumXY_ = 0;
+    uint32_t total_ = 0;
+};
+
+// 分片规划：在时隙预算内选择帧长和每时隙帧数，使每时隙的有效载荷最大
+// 帧数为 n 时可用的最大帧长为 (budgetUs / n - perFrameUs) / perByte，
+// 逐个 n 计算载荷 n * (帧长 - overhead) 取最大值，载荷相同时取帧数少（帧长大）的方案
+namespace LinkPlanner {
+
+// overhead 为每个分片中非导通数据的字节数（帧头、前缀、CRC），
+// 帧长限制在 [minFrame, maxFrame]，每时隙帧数不超过 maxFrames（发送缓冲区的帧数），
+// 最短帧也放不进时隙时返回false
+bool plan(const LinkTiming &timing, uint32_t budgetUs, size_t overhead,
+          size_t minFrame, size_t maxFrame, size_t maxFrames, LinkPlan &result);
+
+// 在新的耗时模型下当前计划是否仍能在时隙内发完
+bool fits(const LinkTiming &timing, uint32_t budgetUs, const LinkPlan &plan);
+
+} // namespace LinkPlanner
+
+} // namespace WhtsProtocol
+
+#endif // WHTS_PROTOCOL_LINK_PLANNER_H
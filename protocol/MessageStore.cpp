@@ -0,0 +1,101 @@
+#include "MessageStore.h"
+
+namespace WhtsProtocol {
+
+MessageStore::MessageStore()
+    : master2Slave_(), slave2Master_(), backend2Master_(), master2Backend_() {
+    // 同步消息每个周期都会收到，提前预留从机配置容量
+    master2Slave_.sync.slaveConfigs.reserve(
+        Master2Slave::SyncMessage::RESERVED_SLAVE_CONFIGS);
+    master2Slave_.compactSync.entries.reserve(
+        Master2Slave::CompactSyncMessage::RESERVED_ENTRIES *
+        Master2Slave::CompactSyncMessage::ENTRY_SIZE);
+}
+
+Message *MessageStore::get(PacketId packetId, uint8_t messageId) {
+    switch (packetId) {
+        case PacketId::MASTER_TO_SLAVE:
+            switch (static_cast<Master2SlaveMessageId>(messageId)) {
+                case Master2SlaveMessageId::SYNC_MSG:
+                    return &master2Slave_.sync;
+                case Master2SlaveMessageId::COMPACT_SYNC_MSG:
+                    return &master2Slave_.compactSync;
+                case Master2SlaveMessageId::PING_REQ_MSG:
+                    return &master2Slave_.pingReq;
+                case Master2SlaveMessageId::SHORT_ID_ASSIGN_MSG:
+                    return &master2Slave_.shortIdAssign;
+                case Master2SlaveMessageId::FRAGMENT_NACK_MSG:
+                    return &master2Slave_.fragmentNack;
+                case Master2SlaveMessageId::SETTLE_CALIBRATE_MSG:
+                    return &master2Slave_.settleCalibrate;
+            }
+            break;
+
+        case PacketId::SLAVE_TO_MASTER:
+            switch (static_cast<Slave2MasterMessageId>(messageId)) {
+                case Slave2MasterMessageId::RST_RSP_MSG:
+                    return &slave2Master_.rstResponse;
+                case Slave2MasterMessageId::PING_RSP_MSG:
+                    return &slave2Master_.pingRsp;
+                case Slave2MasterMessageId::JOIN_REQUEST_MSG:
+                    return &slave2Master_.joinRequest;
+                case Slave2MasterMessageId::SHORT_ID_CONFIRM_MSG:
+                    return &slave2Master_.shortIdConfirm;
+                case Slave2MasterMessageId::HEARTBEAT_MSG:
+                    return &slave2Master_.heartbeat;
+                case Slave2MasterMessageId::COND_DATA_MSG:
+                    return &slave2Master_.conductionData;
+                case Slave2MasterMessageId::COND_DATA_ENC_MSG:
+                    return &slave2Master_.encodedConductionData;
+                case Slave2MasterMessageId::LINK_PLAN_MSG:
+                    return &slave2Master_.linkPlan;
+                case Slave2MasterMessageId::COND_PARITY_MSG:
+                    return &slave2Master_.conductionParity;
+            }
+            break;
+
+        case PacketId::BACKEND_TO_MASTER:
+            switch (static_cast<Backend2MasterMessageId>(messageId)) {
+                case Backend2MasterMessageId::SLAVE_CFG_MSG:
+                    return &backend2Master_.slaveConfig;
+                case Backend2MasterMessageId::MODE_CFG_MSG:
+                    return &backend2Master_.modeConfig;
+                case Backend2MasterMessageId::SLAVE_RST_MSG:
+                    return &backend2Master_.rst;
+                case Backend2MasterMessageId::CTRL_MSG:
+                    return &backend2Master_.ctrl;
+                case Backend2MasterMessageId::PING_CTRL_MSG:
+                    return &backend2Master_.pingCtrl;
+                case Backend2MasterMessageId::DEVICE_LIST_REQ_MSG:
+                    return &backend2Master_.deviceListReq;
+                case Backend2MasterMessageId::INTERVAL_CFG_MSG:
+                    return &backend2Master_.intervalConfig;
+            }
+            break;
+
+        case PacketId::MASTER_TO_BACKEND:
+            switch (static_cast<Master2BackendMessageId>(messageId)) {
+                case Master2BackendMessageId::SLAVE_CFG_RSP_MSG:
+                    return &master2Backend_.slaveConfigResponse;
+                case Master2BackendMessageId::MODE_CFG_RSP_MSG:
+                    return &master2Backend_.modeConfigResponse;
+                case Master2BackendMessageId::RST_RSP_MSG:
+                    return &master2Backend_.rstResponse;
+                case Master2BackendMessageId::CTRL_RSP_MSG:
+                    return &master2Backend_.ctrlResponse;
+                case Master2BackendMessageId::PING_RES_MSG:
+                    return &master2Backend_.pingResponse;
+                case Master2BackendMessageId::DEVICE_LIST_RSP_MSG:
+                    return &master2Backend_.deviceListResponse;
+                case Master2BackendMessageId::INTERVAL_CFG_RSP_MSG:
+                    return &master2Backend_.intervalConfigResponse;
+            }
+            break;
+
+        default:
+            break;
+    }
+    return nullptr;
+}
+
+} // namespace WhtsProtocol
@@ -0,0 +1,74 @@
+#ifndef WHTS_PROTOCOL_MESSAGE_STORE_H
+#define WHTS_PROTOCOL_MESSAGE_STORE_H
+
+#include "Common.h"
+#include "messages/Backend2Master.h"
+#include "messages/Master2Backend.h"
+#include "messages/Master2Slave.h"
+#include "messages/Slave2Master.h"
+#include <cstdint>
+
+namespace WhtsProtocol {
+
+// 接收消息的就地存储
+// 每种消息类型只构造一个实例，解析时按 (packetId, messageId) 取出复用，
+// 数组类字段保留上次的容量，稳定运行时解析不再做堆分配
+// 注意：返回的消息在下一次获取同类型消息之前有效，调用方不能长期持有
+class MessageStore {
+  public:
+    MessageStore();
+
+    // 获取对应类型的消息实例，未知类型返回nullptr
+    Message *get(PacketId packetId, uint8_t messageId);
+
+  private:
+    struct Master2SlaveMessages {
+        Master2Slave::SyncMessage sync;
+        Master2Slave::CompactSyncMessage compactSync;
+        Master2Slave::PingReqMessage pingReq;
+        Master2Slave::ShortIdAssignMessage shortIdAssign;
+        Master2Slave::FragmentNackMessage fragmentNack;
+        Master2Slave::SettleCalibrateMessage settleCalibrate;
+    };
+
+    struct Slave2MasterMessages {
+        Slave2Master::RstResponseMessage rstResponse;
+        Slave2Master::PingRspMessage pingRsp;
+        Slave2Master::JoinRequestMessage joinRequest;
+        Slave2Master::ShortIdConfirmMessage shortIdConfirm;
+        Slave2Master::HeartbeatMessage heartbeat;
+        Slave2Master::ConductionDataMessage conductionData;
+        Slave2Master::EncodedConductionDataMessage encodedConductionData;
+        Slave2Master::ConductionParityMessage conductionParity;
+        Slave2Master::LinkPlanMessage linkPlan;
+    };
+
+    struct Backend2MasterMessages {
+        Backend2Master::SlaveConfigMessage slaveConfig;
+        Backend2Master::ModeConfigMessage modeConfig;
+        Backend2Master::RstMessage rst;
+        Backend2Master::CtrlMessage ctrl;
+        Backend2Master::PingCtrlMessage pingCtrl;
+        Backend2Master::DeviceListReqMessage deviceListReq;
+        Backend2Master::IntervalConfigMessage intervalConfig;
+    };
+
+    struct Master2BackendMessages {
+        Master2Backend::SlaveConfigResponseMessage slaveConfigResponse;
+        Master2Backend::ModeConfigResponseMessage modeConfigResponse;
+        Master2Backend::RstResponseMessage rstResponse;
+        Master2Backend::CtrlResponseMessage ctrlResponse;
+        Master2Backend::PingResponseMessage pingResponse;
+        Master2Backend::DeviceListResponseMessage deviceListResponse;
+        Master2Backend::IntervalConfigResponseMessage intervalConfigResponse;
+    };
+
+    Master2SlaveMessages master2Slave_;
+    Slave2MasterMessages slave2Master_;
+    Backend2MasterMessages backend2Master_;
+    Master2BackendMessages master2Backend_;
+};
+
+} // namespace WhtsProtocol
+
+#endif // WHTS_PROTOCOL_MESSAGE_STORE_H
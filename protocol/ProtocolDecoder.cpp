@@ -0,0 +1,642 @@
+#include "ProtocolDecoder.h"
+
+#include <algorithm>
+#include <cstring>
+#include "elog.h"
+
+#include "messages/Backend2Master.h"
+#include "messages/Master2Backend.h"
+#include "messages/Master2Slave.h"
+#include "messages/Slave2Master.h"
+#include "utils/Crc32.h"
+
+namespace WhtsProtocol {
+
+ProtocolDecoder::ProtocolDecoder()
+    : crcErrorCount_(0), crcPeer_(nullptr), completeFramesHead_(0),
+      completeFramesCount_(0) {
+    reassembler_.setTimeout(FRAGMENT_TIMEOUT_MS);
+}
+
+uint16_t ProtocolDecoder::readUint16LE(const std::vector<uint8_t> &buffer,
+                                       size_t offset) {
+    if (offset + 1 >= buffer.size()) return 0;
+    return buffer[offset] | (buffer[offset + 1] << 8);
+}
+
+uint32_t ProtocolDecoder::readUint32LE(const std::vector<uint8_t> &buffer,
+                                       size_t offset) {
+    if (offset + 3 >= buffer.size()) return 0;
+    return buffer[offset] | (buffer[offset + 1] << 8) |
+           (buffer[offset + 2] << 16) | (buffer[offset + 3] << 24);
+}
+
+// 校验并去掉帧尾CRC，frameData为包含帧头的原始帧数据
+bool ProtocolDecoder::verifyFrameCrc(const std::vector<uint8_t> &frameData,
+                                     Frame &frame) {
+    if (!(frame.moreFragmentsFlag & FRAME_FLAG_CRC32)) {
+        return true;
+    }
+
+    if (frame.payload.size() < FRAME_CRC_SIZE) {
+        return false;
+    }
+    size_t checkedLength = frameData.size() - FRAME_CRC_SIZE;
+    uint32_t expected = frameData[checkedLength] |
+                        (frameData[checkedLength + 1] << 8) |
+                        (frameData[checkedLength + 2] << 16) |
+                        (static_cast<uint32_t>(frameData[checkedLength + 3]) << 24);
+    if (Crc32::compute(frameData.data(), checkedLength) != expected) {
+        return false;
+    }
+
+    // 对端发送了带CRC的帧，说明支持CRC，此后发送也附加CRC
+    if (crcPeer_ != nullptr && !crcPeer_->isCrcEnabled()) {
+        elog_i("ProtocolProcessor", "Peer supports CRC trailer, enabling");
+        crcPeer_->SetCrcEnabled(true);
+    }
+
+    frame.payload.resize(frame.payload.size() - FRAME_CRC_SIZE);
+    frame.packetLength = static_cast<uint16_t>(frame.payload.size());
+    frame.moreFragmentsFlag &= ~FRAME_FLAG_CRC32;
+    return true;
+}
+
+bool ProtocolDecoder::parseFrame(const std::vector<uint8_t> &data,
+                                 Frame &frame) {
+    return Frame::deserialize(data, frame);
+}
+
+std::unique_ptr<Message> ProtocolDecoder::createMessage(PacketId packetId,
+                                                        uint8_t messageId) {
+    switch (packetId) {
+        case PacketId::MASTER_TO_SLAVE:
+            switch (static_cast<Master2SlaveMessageId>(messageId)) {
+                case Master2SlaveMessageId::SYNC_MSG:
+                    return std::make_unique<Master2Slave::SyncMessage>();
+                case Master2SlaveMessageId::COMPACT_SYNC_MSG:
+                    return std::make_unique<Master2Slave::CompactSyncMessage>();
+                case Master2SlaveMessageId::PING_REQ_MSG:
+                    return std::make_unique<Master2Slave::PingReqMessage>();
+                case Master2SlaveMessageId::SHORT_ID_ASSIGN_MSG:
+                    return std::make_unique<
+                        Master2Slave::ShortIdAssignMessage>();
+                case Master2SlaveMessageId::FRAGMENT_NACK_MSG:
+                    return std::make_unique<
+                        Master2Slave::FragmentNackMessage>();
+                case Master2SlaveMessageId::SETTLE_CALIBRATE_MSG:
+                    return std::make_unique<
+                        Master2Slave::SettleCalibrateMessage>();
+            }
+            break;
+
+        case PacketId::SLAVE_TO_MASTER:
+            switch (static_cast<Slave2MasterMessageId>(messageId)) {
+
+                case Slave2MasterMessageId::RST_RSP_MSG:
+                    return std::make_unique<Slave2Master::RstResponseMessage>();
+                case Slave2MasterMessageId::PING_RSP_MSG:
+                    return std::make_unique<Slave2Master::PingRspMessage>();
+                case Slave2MasterMessageId::JOIN_REQUEST_MSG:
+                    return std::make_unique<Slave2Master::JoinRequestMessage>();
+                case Slave2MasterMessageId::SHORT_ID_CONFIRM_MSG:
+                    return std::make_unique<
+                        Slave2Master::ShortIdConfirmMessage>();
+                case Slave2MasterMessageId::HEARTBEAT_MSG:
+                    return std::make_unique<Slave2Master::HeartbeatMessage>();
+                case Slave2MasterMessageId::COND_DATA_MSG:
+                    return std::make_unique<Slave2Master::ConductionDataMessage>();
+                case Slave2MasterMessageId::COND_DATA_ENC_MSG:
+                    return std::make_unique<Slave2Master::EncodedConductionDataMessage>();
+                case Slave2MasterMessageId::COND_PARITY_MSG:
+                    return std::make_unique<Slave2Master::ConductionParityMessage>();
+                case Slave2MasterMessageId::LINK_PLAN_MSG:
+                    return std::make_unique<Slave2Master::LinkPlanMessage>();
+            }
+            break;
+
+        case PacketId::BACKEND_TO_MASTER:
+            switch (static_cast<Backend2MasterMessageId>(messageId)) {
+                case Backend2MasterMessageId::SLAVE_CFG_MSG:
+                    return std::make_unique<
+                        Backend2Master::SlaveConfigMessage>();
+                case Backend2MasterMessageId::MODE_CFG_MSG:
+                    return std::make_unique<
+                        Backend2Master::ModeConfigMessage>();
+                case Backend2MasterMessageId::SLAVE_RST_MSG:
+                    return std::make_unique<Backend2Master::RstMessage>();
+                case Backend2MasterMessageId::CTRL_MSG:
+                    return std::make_unique<Backend2Master::CtrlMessage>();
+                case Backend2MasterMessageId::PING_CTRL_MSG:
+                    return std::make_unique<Backend2Master::PingCtrlMessage>();
+                case Backend2MasterMessageId::DEVICE_LIST_REQ_MSG:
+                    return std::make_unique<
+                        Backend2Master::DeviceListReqMessage>();
+                case Backend2MasterMessageId::INTERVAL_CFG_MSG:
+                    return std::make_unique<
+                        Backend2Master::IntervalConfigMessage>();
+            }
+            break;
+
+        case PacketId::MASTER_TO_BACKEND:
+            switch (static_cast<Master2BackendMessageId>(messageId)) {
+                case Master2BackendMessageId::SLAVE_CFG_RSP_MSG:
+                    return std::make_unique<
+                        Master2Backend::SlaveConfigResponseMessage>();
+                case Master2BackendMessageId::MODE_CFG_RSP_MSG:
+                    return std::make_unique<
+                        Master2Backend::ModeConfigResponseMessage>();
+                case Master2BackendMessageId::RST_RSP_MSG:
+                    return std::make_unique<
+                        Master2Backend::RstResponseMessage>();
+                case Master2BackendMessageId::CTRL_RSP_MSG:
+                    return std::make_unique<
+                        Master2Backend::CtrlResponseMessage>();
+                case Master2BackendMessageId::PING_RES_MSG:
+                    return std::make_unique<
+                        Master2Backend::PingResponseMessage>();
+                case Master2BackendMessageId::DEVICE_LIST_RSP_MSG:
+                    return std::make_unique<
+                        Master2Backend::DeviceListResponseMessage>();
+                case Master2BackendMessageId::INTERVAL_CFG_RSP_MSG:
+                    return std::make_unique<
+                        Master2Backend::IntervalConfigResponseMessage>();
+            }
+            break;
+
+        default:
+            break;
+    }
+    return nullptr;
+}
+
+bool ProtocolDecoder::parseMaster2SlavePacket(
+    const std::vector<uint8_t> &payload, uint32_t &destinationId,
+    std::unique_ptr<Message> &message) {
+    if (payload.size() < 5) return false;
+
+    uint8_t messageId = payload[0];
+    destinationId = readUint32LE(payload, 1);
+
+    message = createMessage(PacketId::MASTER_TO_SLAVE, messageId);
+    if (!message) return false;
+
+    // 消息体直接从载荷中解码，不再复制
+    return message->deserializeFrom(payload.data() + ADDRESSED_PREFIX_SIZE,
+                                    payload.size() - ADDRESSED_PREFIX_SIZE);
+}
+
+bool ProtocolDecoder::parseSlave2MasterPacket(
+    const std::vector<uint8_t> &payload, uint32_t &slaveId,
+    std::unique_ptr<Message> &message) {
+    if (payload.size() < 5) return false;
+
+    uint8_t messageId = payload[0];
+    slaveId = readUint32LE(payload, 1);
+
+    message = createMessage(PacketId::SLAVE_TO_MASTER, messageId);
+    if (!message) return false;
+
+    // 消息体直接从载荷中解码，不再复制
+    return message->deserializeFrom(payload.data() + ADDRESSED_PREFIX_SIZE,
+                                    payload.size() - ADDRESSED_PREFIX_SIZE);
+}
+
+bool ProtocolDecoder::parseSlave2MasterPacket(
+    const std::vector<uint8_t> &payload, uint32_t &slaveId,
+    DeviceStatus &deviceStatus, std::unique_ptr<Message> &message) {
+    if (payload.size() < 7) return false;
+
+    uint8_t messageId = payload[0];
+    slaveId = readUint32LE(payload, 1);
+    deviceStatus.fromUint16(readUint16LE(payload, 5));
+
+    message = createMessage(PacketId::SLAVE_TO_MASTER, messageId);
+    if (!message) return false;
+
+    // 消息体直接从载荷中解码，不再复制
+    return message->deserializeFrom(payload.data() + STATUS_PREFIX_SIZE,
+                                    payload.size() - STATUS_PREFIX_SIZE);
+}
+
+
+bool ProtocolDecoder::parseBackend2MasterPacket(
+    const std::vector<uint8_t> &payload, std::unique_ptr<Message> &message) {
+    if (payload.size() < 1) return false;
+
+    uint8_t messageId = payload[0];
+    elog_v("ProtocolProcessor", "Backend2Master messageId: 0x%02X", messageId);
+
+    message = createMessage(PacketId::BACKEND_TO_MASTER, messageId);
+    if (!message) return false;
+
+    // 消息体直接从载荷中解码，不再复制
+    return message->deserializeFrom(payload.data() + MESSAGE_ID_PREFIX_SIZE,
+                                    payload.size() - MESSAGE_ID_PREFIX_SIZE);
+}
+
+bool ProtocolDecoder::parseMaster2BackendPacket(
+    const std::vector<uint8_t> &payload, std::unique_ptr<Message> &message) {
+    if (payload.size() < 1) return false;
+
+    uint8_t messageId = payload[0];
+
+    message = createMessage(PacketId::MASTER_TO_BACKEND, messageId);
+    if (!message) return false;
+
+    // 消息体直接从载荷中解码，不再复制
+    return message->deserializeFrom(payload.data() + MESSAGE_ID_PREFIX_SIZE,
+                                    payload.size() - MESSAGE_ID_PREFIX_SIZE);
+}
+
+bool ProtocolDecoder::decodeMessageBody(Message *message,
+                                        const std::vector<uint8_t> &payload,
+                                        size_t prefixLength) {
+    if (message == nullptr) return false;
+
+    // 消息体直接从载荷中解码，不再复制
+    return message->deserializeFrom(payload.data() + prefixLength,
+                                    payload.size() - prefixLength);
+}
+
+bool ProtocolDecoder::parseMaster2SlavePacket(
+    const std::vector<uint8_t> &payload, uint32_t &destinationId,
+    Message *&message) {
+    if (payload.size() < ADDRESSED_PREFIX_SIZE) return false;
+
+    destinationId = readUint32LE(payload, 1);
+    message = messageStore_.get(PacketId::MASTER_TO_SLAVE, payload[0]);
+    return decodeMessageBody(message, payload, ADDRESSED_PREFIX_SIZE);
+}
+
+bool ProtocolDecoder::parseSlave2MasterPacket(
+    const std::vector<uint8_t> &payload, uint32_t &slaveId,
+    Message *&message) {
+    if (payload.size() < ADDRESSED_PREFIX_SIZE) return false;
+
+    slaveId = readUint32LE(payload, 1);
+    message = messageStore_.get(PacketId::SLAVE_TO_MASTER, payload[0]);
+    return decodeMessageBody(message, payload, ADDRESSED_PREFIX_SIZE);
+}
+
+bool ProtocolDecoder::parseSlave2MasterPacket(
+    const std::vector<uint8_t> &payload, uint32_t &slaveId,
+    DeviceStatus &deviceStatus, Message *&message) {
+    if (payload.size() < STATUS_PREFIX_SIZE) return false;
+
+    slaveId = readUint32LE(payload, 1);
+    deviceStatus.fromUint16(readUint16LE(payload, 5));
+    message = messageStore_.get(PacketId::SLAVE_TO_MASTER, payload[0]);
+    return decodeMessageBody(message, payload, STATUS_PREFIX_SIZE);
+}
+
+bool ProtocolDecoder::parseBackend2MasterPacket(
+    const std::vector<uint8_t> &payload, Message *&message) {
+    if (payload.size() < MESSAGE_ID_PREFIX_SIZE) return false;
+
+    message = messageStore_.get(PacketId::BACKEND_TO_MASTER, payload[0]);
+    return decodeMessageBody(message, payload, MESSAGE_ID_PREFIX_SIZE);
+}
+
+bool ProtocolDecoder::parseMaster2BackendPacket(
+    const std::vector<uint8_t> &payload, Message *&message) {
+    if (payload.size() < MESSAGE_ID_PREFIX_SIZE) return false;
+
+    message = messageStore_.get(PacketId::MASTER_TO_BACKEND, payload[0]);
+    return decodeMessageBody(message, payload, MESSAGE_ID_PREFIX_SIZE);
+}
+
+// Process received raw data (supports packet concatenation handling)
+void ProtocolDecoder::processReceivedData(const std::vector<uint8_t> &data) {
+    processReceivedData(data.data(), data.size());
+}
+
+void ProtocolDecoder::processReceivedData(const uint8_t *data,
+                                          size_t length) {
+    size_t offset = 0;
+    while (offset < length) {
+        // 写入环形缓冲区，空间不足时先提取已完整的帧腾出空间
+        offset += receiveBuffer_.push(data + offset, length - offset);
+        extractCompleteFrames();
+
+        if (offset < length && receiveBuffer_.freeSpace() == 0) {
+            // 缓冲区已满且没有完整帧可提取: 只丢弃最旧的未完成帧
+            dropOldestIncompleteFrame();
+        }
+    }
+    elog_v("ProtocolProcessor", "Current receive buffer size: %d bytes",
+           receiveBuffer_.size());
+
+    // Clean up expired fragments
+    cleanupExpiredFragments();
+}
+
+// 丢弃接收缓冲区头部的未完成帧，保留其后的数据
+void ProtocolDecoder::dropOldestIncompleteFrame() {
+    size_t nextFrame = findFrameHeader(1);
+    size_t dropSize =
+        (nextFrame == SIZE_MAX) ? receiveBuffer_.size() : nextFrame;
+    elog_w("ProtocolProcessor",
+           "Receive buffer full, dropping oldest incomplete frame: %d bytes, "
+           "max limit: %d",
+           dropSize, MAX_RECEIVE_BUFFER_SIZE);
+    receiveBuffer_.consume(dropSize);
+}
+
+// Extract complete frames from receive buffer
+bool ProtocolDecoder::extractCompleteFrames() {
+    bool foundFrames = false;
+
+    elog_v(
+        "ProtocolProcessor",
+        "Starting frame extraction from receive buffer, buffer size: %d bytes",
+        receiveBuffer_.size());
+
+    while (!receiveBuffer_.empty()) {
+        // Find frame header
+        size_t frameStart = findFrameHeader(0);
+        if (frameStart == SIZE_MAX) {
+            elog_v("ProtocolProcessor",
+                   "No frame header found, skipping current data");
+            // 保留末尾可能是帧头第一个字节的数据
+            size_t keep =
+                (receiveBuffer_.peek(receiveBuffer_.size() - 1) ==
+                 FRAME_DELIMITER_1)
+                    ? 1
+                    : 0;
+            receiveBuffer_.consume(receiveBuffer_.size() - keep);
+            break;    // No frame header found
+        }
+
+        // 丢弃帧头之前的无效数据
+        receiveBuffer_.consume(frameStart);
+
+        // Check if there's enough data to read frame length
+        if (receiveBuffer_.size() < FRAME_HEADER_SIZE) {
+            elog_v("ProtocolProcessor",
+                   "Insufficient data to read frame "
+                   "length, waiting for more data");
+            break;    // Not enough data, wait for more
+        }
+
+        // 读取帧长度
+        uint16_t frameLength = receiveBuffer_.peekUint16LE(5);
+        size_t totalFrameSize = FRAME_HEADER_SIZE + frameLength;
+
+        elog_v("ProtocolProcessor",
+               "Frame payload length: %d, total frame size: %d", frameLength,
+               totalFrameSize);
+
+        // 检查是否有完整的帧
+        if (totalFrameSize > receiveBuffer_.size()) {
+            elog_v(
+                "ProtocolProcessor",
+                "Incomplete frame, waiting for more data. Need: %d, have: %d",
+                totalFrameSize, receiveBuffer_.size());
+            break;    // 帧不完整，等待更多数据
+        }
+
+        // 提取完整帧数据，使用可复用的buffer
+        extractFrameBuffer_.resize(totalFrameSize);
+        receiveBuffer_.copyOut(0, extractFrameBuffer_.data(), totalFrameSize);
+        receiveBuffer_.consume(totalFrameSize);
+
+        // 解析帧，复用rxFrame_的载荷容量
+        Frame &frame = rxFrame_;
+        if (!Frame::deserialize(extractFrameBuffer_, frame)) {
+            elog_e("ProtocolProcessor", "Frame parsing failed");
+        } else if (!verifyFrameCrc(extractFrameBuffer_, frame)) {
+            crcErrorCount_++;
+            elog_w("ProtocolProcessor",
+                   "Frame CRC mismatch, dropping frame, PacketId: 0x%02X, "
+                   "length: %d",
+                   frame.packetId, frame.packetLength);
+        } else {
+            elog_v(
+                "ProtocolProcessor",
+                "Frame parsed successfully, PacketId: 0x%02X, "
+                "fragment_sequence: %d, more_fragments: %d, payload_length: %d",
+                frame.packetId, frame.fragmentsSequence,
+                frame.moreFragmentsFlag, frame.packetLength);
+
+            // 检查是否是紧凑短ID帧或分片
+            if (frame.moreFragmentsFlag & FRAME_FLAG_SHORT_ID) {
+                if (processCompactFrame(frame)) {
+                    foundFrames = true;
+                }
+            } else if ((frame.moreFragmentsFlag & FRAME_FLAG_MORE_FRAGMENTS) ||
+                       frame.fragmentsSequence > 0) {
+                elog_v("ProtocolProcessor",
+                       "Fragment frame detected, starting fragment reassembly");
+                // 分片直接写入重组表，重组完成时从重组表内存写入队列槽位
+                ReassembledFrame reassembled;
+                if (reassembler_.addFragment(frame, reassembled)) {
+                    elog_v("ProtocolProcessor",
+                           "Fragment reassembly completed, PacketId: 0x%02X, "
+                           "payload_length: %d",
+                           reassembled.packetId, reassembled.length);
+                    pushReassembledFrame(reassembled);
+                    foundFrames = true;
+                } else {
+                    elog_v("ProtocolProcessor",
+                           "Fragment reassembly not complete, waiting for more "
+                           "fragments");
+                }
+            } else {
+                elog_v("ProtocolProcessor",
+                       "Single complete frame, adding to complete frame queue");
+                // 单个完整帧
+                pushCompleteFrame(frame);
+                foundFrames = true;
+            }
+        }
+    }
+
+    return foundFrames;
+}
+
+// 紧凑短ID帧：跳过短ID前缀后交给重组表，完成后还原为标准Slave2Master载荷
+// 载荷不做erase/insert搬移，只按偏移引用数据
+bool ProtocolDecoder::processCompactFrame(Frame &frame) {
+    auto &payload = frame.payload;
+    uint8_t sequence = frame.fragmentsSequence;
+    bool moreFragments =
+        (frame.moreFragmentsFlag & FRAME_FLAG_MORE_FRAGMENTS) != 0;
+    uint8_t shortId = 0;
+    const uint8_t *data = nullptr;
+    size_t length = 0;
+
+    if (sequence == 0) {
+        if (payload.size() < COMPACT_FIRST_PREFIX_SIZE) {
+            elog_w("ProtocolProcessor", "Compact frame too short: %d bytes",
+                   payload.size());
+            return false;
+        }
+        // messageId + shortId + status -> messageId + status
+        // 把messageId移到短ID的位置，从第1字节开始即为去掉短ID的数据
+        shortId = payload[1];
+        payload[1] = payload[0];
+        data = payload.data() + 1;
+        length = payload.size() - 1;
+    } else {
+        if (payload.size() < COMPACT_NEXT_PREFIX_SIZE) {
+            elog_w("ProtocolProcessor", "Compact fragment too short: %d bytes",
+                   payload.size());
+            return false;
+        }
+        shortId = payload[0];
+        uint8_t fragmentOffset = payload[1];
+        data = payload.data() + COMPACT_NEXT_PREFIX_SIZE;
+        length = payload.size() - COMPACT_NEXT_PREFIX_SIZE;
+
+        // 非最后分片的数据长度即步长，偏移不一致说明混入了其他分片流
+        if (moreFragments &&
+            ((sequence * length) >> COMPACT_OFFSET_SHIFT) != fragmentOffset) {
+            elog_w("ProtocolProcessor",
+                   "Compact fragment offset mismatch, ShortId: %d, "
+                   "sequence: %d, offset: %d",
+                   shortId, sequence, fragmentOffset);
+            return false;
+        }
+    }
+
+    uint8_t packetId = frame.packetId;
+    if (sequence != 0 || moreFragments) {
+        ReassembledFrame reassembled;
+        if (!reassembler_.addFragment(packetId, COMPACT_STREAM_KEY, shortId,
+                                      sequence, moreFragments, data, length,
+                                      reassembled)) {
+            return false;
+        }
+        data = reassembled.data;
+        length = reassembled.length;
+    }
+
+    elog_v("ProtocolProcessor",
+           "Compact frame completed, ShortId: %d, data_length: %d", shortId,
+           length);
+    pushCompactFrame(packetId, shortId, data, length);
+    return true;
+}
+
+// messageId + status + 消息体 -> messageId + slaveId + status + 消息体
+// 展开后的前缀先在临时头部中构建，再与数据一起直接写入队列槽位
+void ProtocolDecoder::pushCompactFrame(uint8_t packetId, uint8_t shortId,
+                                       const uint8_t *data, size_t length) {
+    uint32_t slaveId = shortIdResolver_ ? shortIdResolver_(shortId) : shortId;
+    uint8_t header[ADDRESSED_PREFIX_SIZE] = {
+        data[0], static_cast<uint8_t>(slaveId & 0xFF),
+        static_cast<uint8_t>((slaveId >> 8) & 0xFF),
+        static_cast<uint8_t>((slaveId >> 16) & 0xFF),
+        static_cast<uint8_t>((slaveId >> 24) & 0xFF)};
+
+    Frame &slot = acquireCompleteSlot();
+    slot.delimiter1 = FRAME_DELIMITER_1;
+    slot.delimiter2 = FRAME_DELIMITER_2;
+    slot.packetId = packetId;
+    slot.fragmentsSequence = 0;
+    slot.moreFragmentsFlag = 0;
+    slot.payload.resize(ADDRESSED_PREFIX_SIZE + length -
+                        MESSAGE_ID_PREFIX_SIZE);
+    std::memcpy(slot.payload.data(), header, sizeof(header));
+    std::memcpy(slot.payload.data() + ADDRESSED_PREFIX_SIZE,
+                data + MESSAGE_ID_PREFIX_SIZE,
+                length - MESSAGE_ID_PREFIX_SIZE);
+    slot.packetLength = static_cast<uint16_t>(slot.payload.size());
+}
+
+// 查找帧头，返回相对接收缓冲区读指针的偏移
+// 用memchr定位分隔符候选，并用长度字段排除明显无效的伪帧头
+size_t ProtocolDecoder::findFrameHeader(size_t startPos) const {
+    size_t pos = startPos;
+    while ((pos = receiveBuffer_.find(FRAME_DELIMITER_1, FRAME_DELIMITER_2,
+                                      pos)) != receiveBuffer_.NPOS) {
+        if (pos + FRAME_HEADER_SIZE > receiveBuffer_.size()) {
+            return pos;    // 长度字段尚未收到，先作为候选
+        }
+        size_t totalFrameSize =
+            FRAME_HEADER_SIZE + receiveBuffer_.peekUint16LE(pos + 5);
+        if (totalFrameSize <= MAX_RECEIVE_BUFFER_SIZE) {
+            return pos;
+        }
+        // 长度超出接收缓冲区容量，跳过分隔符继续查找
+        pos += 2;
+    }
+    return SIZE_MAX;
+}
+
+// Get next complete frame
+// 与调用方交换载荷vector，调用方的旧载荷留在槽位中供下一帧复用
+bool ProtocolDecoder::getNextCompleteFrame(Frame &frame) {
+    if (completeFramesCount_ == 0) {
+        return false;
+    }
+
+    Frame &slot = completeFrames_[completeFramesHead_];
+    frame.delimiter1 = slot.delimiter1;
+    frame.delimiter2 = slot.delimiter2;
+    frame.packetId = slot.packetId;
+    frame.fragmentsSequence = slot.fragmentsSequence;
+    frame.moreFragmentsFlag = slot.moreFragmentsFlag;
+    frame.packetLength = slot.packetLength;
+    frame.payload.swap(slot.payload);
+
+    completeFramesHead_ = (completeFramesHead_ + 1) % MAX_COMPLETE_FRAMES;
+    completeFramesCount_--;
+    return true;
+}
+
+Frame &ProtocolDecoder::acquireCompleteSlot() {
+    if (completeFramesCount_ == MAX_COMPLETE_FRAMES) {
+        elog_w("ProtocolProcessor",
+               "Complete frame queue full, dropping oldest frame");
+        completeFramesHead_ = (completeFramesHead_ + 1) % MAX_COMPLETE_FRAMES;
+        completeFramesCount_--;
+    }
+
+    Frame &slot = completeFrames_[(completeFramesHead_ + completeFramesCount_) %
+                                  MAX_COMPLETE_FRAMES];
+    completeFramesCount_++;
+    return slot;
+}
+
+void ProtocolDecoder::pushCompleteFrame(Frame &frame) {
+    Frame &slot = acquireCompleteSlot();
+    slot.delimiter1 = frame.delimiter1;
+    slot.delimiter2 = frame.delimiter2;
+    slot.packetId = frame.packetId;
+    slot.fragmentsSequence = frame.fragmentsSequence;
+    slot.moreFragmentsFlag = frame.moreFragmentsFlag;
+    slot.packetLength = frame.packetLength;
+    slot.payload.swap(frame.payload);
+}
+
+// 重组完成的载荷只在这里拷贝一次，写入的槽位载荷随后交换给调用方
+Frame &ProtocolDecoder::pushReassembledFrame(
+    const ReassembledFrame &reassembled) {
+    Frame &slot = acquireCompleteSlot();
+    slot.delimiter1 = FRAME_DELIMITER_1;
+    slot.delimiter2 = FRAME_DELIMITER_2;
+    slot.packetId = reassembled.packetId;
+    slot.fragmentsSequence = 0;
+    slot.moreFragmentsFlag = 0;
+    slot.packetLength = static_cast<uint16_t>(reassembled.length);
+    slot.payload.assign(reassembled.data,
+                        reassembled.data + reassembled.length);
+    return slot;
+}
+
+// Clear receive buffer
+void ProtocolDecoder::clearReceiveBuffer() {
+    receiveBuffer_.clear();
+    completeFramesHead_ = 0;
+    completeFramesCount_ = 0;
+    reassembler_.clear();
+}
+
+// Clean up expired fragments
+void ProtocolDecoder::cleanupExpiredFragments() {
+    reassembler_.cleanupExpired();
+}
+
+}    // namespace WhtsProtocol
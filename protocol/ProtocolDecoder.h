@@ -0,0 +1,190 @@
+#ifndef WHTS_PROTOCOL_DECODER_H
+#define WHTS_PROTOCOL_DECODER_H
+
+#include "Common.h"
+#include "DeviceStatus.h"
+#include "FragmentReassembler.h"
+#include "Frame.h"
+#include "MessageStore.h"
+#include "ProtocolEncoder.h"
+#include "messages/Message.h"
+#include "utils/RingBuffer.h"
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace WhtsProtocol {
+
+// 短ID到完整从机ID的映射，由主机根据入网分配记录提供
+using ShortIdResolver = std::function<uint32_t(uint8_t shortId)>;
+
+// 协议解码器（接收路径）
+// 拥有接收环形缓冲区、分片重组表、完整帧队列、消息存储以及解析用的临时buffer，
+// 所有接收状态只在此对象内，由单个接收任务使用
+class ProtocolDecoder {
+  public:
+    ProtocolDecoder();
+
+    // 收到对端带CRC的帧时启用该编码器的发送CRC（为nullptr时不自动启用）
+    void SetCrcPeer(ProtocolEncoder *encoder) { crcPeer_ = encoder; }
+
+    // 设置紧凑短ID帧的从机ID映射，未设置时以短ID作为从机ID
+    void SetShortIdResolver(ShortIdResolver resolver) {
+        shortIdResolver_ = std::move(resolver);
+    }
+
+    // CRC校验失败而丢弃的帧数
+    uint32_t getCrcErrorCount() const { return crcErrorCount_; }
+
+    // 设置分片超时使用的毫秒时钟，未设置时不做超时清理
+    void SetFragmentClock(FragmentClockFunc clock) {
+        reassembler_.setClock(std::move(clock));
+    }
+
+    // 设置分片重组的总字节预算
+    void SetFragmentByteBudget(size_t bytes) {
+        reassembler_.setByteBudget(bytes);
+    }
+
+    // 获取分片重组统计（完成/超时/替换次数）
+    const ReassemblyStats &getReassemblyStats() const {
+        return reassembler_.getStats();
+    }
+
+    // 处理接收到的原始数据 (支持粘包处理)
+    void processReceivedData(const std::vector<uint8_t> &data);
+    void processReceivedData(const uint8_t *data, size_t length);
+
+    // 获取完整的已解析帧
+    bool getNextCompleteFrame(Frame &frame);
+
+    // 清空接收缓冲区
+    void clearReceiveBuffer();
+
+    // 解析单个帧
+    bool parseFrame(const std::vector<uint8_t> &data, Frame &frame);
+
+    // 根据Packet ID和Message ID创建对应的消息对象（堆分配，调用方持有）
+    std::unique_ptr<Message> createMessage(PacketId packetId,
+                                           uint8_t messageId);
+
+    // 从就地消息存储中获取对应的消息对象（不做堆分配）
+    // 返回的消息在下一次解析同类型消息之前有效
+    Message *acquireMessage(PacketId packetId, uint8_t messageId) {
+        return messageStore_.get(packetId, messageId);
+    }
+
+    // 解析Master2Slave包
+    bool parseMaster2SlavePacket(const std::vector<uint8_t> &payload,
+                                 uint32_t &destinationId,
+                                 std::unique_ptr<Message> &message);
+
+    // 解析Slave2Master包
+    bool parseSlave2MasterPacket(const std::vector<uint8_t> &payload,
+                                 uint32_t &slaveId,
+                                 std::unique_ptr<Message> &message);
+
+    // 解析Slave2Master包（带DeviceStatus，用于COND_DATA_MSG）
+    bool parseSlave2MasterPacket(const std::vector<uint8_t> &payload,
+                                 uint32_t &slaveId, DeviceStatus &deviceStatus,
+                                 std::unique_ptr<Message> &message);
+
+    // 解析Backend2Master包
+    bool parseBackend2MasterPacket(const std::vector<uint8_t> &payload,
+                                   std::unique_ptr<Message> &message);
+
+    // 解析Master2Backend包
+    bool parseMaster2BackendPacket(const std::vector<uint8_t> &payload,
+                                   std::unique_ptr<Message> &message);
+
+    // 就地解析接口 - 消息解码到消息存储中复用的对象，接收路径不做堆分配
+    // message指向的对象在下一次解析同类型消息之前有效
+    bool parseMaster2SlavePacket(const std::vector<uint8_t> &payload,
+                                 uint32_t &destinationId, Message *&message);
+
+    bool parseSlave2MasterPacket(const std::vector<uint8_t> &payload,
+                                 uint32_t &slaveId, Message *&message);
+
+    bool parseSlave2MasterPacket(const std::vector<uint8_t> &payload,
+                                 uint32_t &slaveId, DeviceStatus &deviceStatus,
+                                 Message *&message);
+
+    bool parseBackend2MasterPacket(const std::vector<uint8_t> &payload,
+                                   Message *&message);
+
+    bool parseMaster2BackendPacket(const std::vector<uint8_t> &payload,
+                                   Message *&message);
+
+  private:
+    // 校验带CRC标志的帧并去掉帧尾CRC，校验失败返回false
+    bool verifyFrameCrc(const std::vector<uint8_t> &frameData, Frame &frame);
+
+    // 从接收缓冲区中提取完整帧
+    bool extractCompleteFrames();
+
+    // 处理紧凑短ID帧（单帧或分片），得到完整帧时返回true
+    bool processCompactFrame(Frame &frame);
+
+    // 将紧凑数据（不含短ID）还原为标准Slave2Master载荷写入完整帧队列
+    void pushCompactFrame(uint8_t packetId, uint8_t shortId,
+                          const uint8_t *data, size_t length);
+
+    // 将帧放入完整帧队列（交换载荷，不复制），队列满时丢弃最旧的帧
+    void pushCompleteFrame(Frame &frame);
+
+    // 将重组表交出的载荷直接写入完整帧队列槽位，返回该槽位
+    Frame &pushReassembledFrame(const ReassembledFrame &reassembled);
+
+    // 占用完整帧队列的下一个槽位，队列满时丢弃最旧的帧
+    Frame &acquireCompleteSlot();
+
+    // 从载荷prefixLength之后解码消息体
+    static bool decodeMessageBody(Message *message,
+                                  const std::vector<uint8_t> &payload,
+                                  size_t prefixLength);
+
+    // 接收缓冲区满时丢弃最旧的未完成帧
+    void dropOldestIncompleteFrame();
+
+    // 查找帧头（偏移相对接收缓冲区读指针）
+    size_t findFrameHeader(size_t startPos) const;
+
+    // 工具函数
+    static uint16_t readUint16LE(const std::vector<uint8_t> &buffer,
+                                 size_t offset);
+    static uint32_t readUint32LE(const std::vector<uint8_t> &buffer,
+                                 size_t offset);
+
+    // 清理超时的分片
+    void cleanupExpiredFragments();
+
+  private:
+    static constexpr size_t MAX_RECEIVE_BUFFER_SIZE =
+        4096; // 最大接收缓冲区大小（必须为2的幂）
+    static constexpr size_t MAX_COMPLETE_FRAMES = 8; // 完整帧队列容量
+    static constexpr uint32_t FRAGMENT_TIMEOUT_MS =
+        5000; // 分片超时时间（毫秒）
+    // 紧凑分片流在重组表中的messageId键值（后续分片不携带messageId）
+    static constexpr uint8_t COMPACT_STREAM_KEY = 0xFF;
+
+    uint32_t crcErrorCount_;    // CRC校验失败计数
+    ProtocolEncoder *crcPeer_;  // 收到带CRC帧时启用CRC的编码器
+    ShortIdResolver shortIdResolver_; // 紧凑短ID帧的从机ID映射
+    ByteRingBuffer<MAX_RECEIVE_BUFFER_SIZE> receiveBuffer_; // 接收环形缓冲区
+    FragmentReassembler reassembler_;       // 分片重组表
+    MessageStore messageStore_;             // 就地解析的消息对象
+
+    // 完整帧队列，固定槽位，入队/出队交换载荷vector以复用其容量
+    Frame completeFrames_[MAX_COMPLETE_FRAMES];
+    size_t completeFramesHead_;
+    size_t completeFramesCount_;
+
+    // 解码器独占的临时buffer，不与编码器共享
+    std::vector<uint8_t> extractFrameBuffer_; // 用于提取帧时的buffer
+    Frame rxFrame_;                           // 用于解析帧的Frame
+};
+
+} // namespace WhtsProtocol
+
+#endif // WHTS_PROTOCOL_DECODER_H
@@ -0,0 +1,792 @@
+#include "ProtocolEncoder.h"
+
+#include <algorithm>
+#include <cstring>
+#include "elog.h"
+
+#include "FragmentParity.h"
+#include "messages/Slave2Master.h"
+#include "utils/Crc32.h"
+
+namespace WhtsProtocol {
+
+ProtocolEncoder::ProtocolEncoder() : mtu_(DEFAULT_MTU), crcEnabled_(false) {}
+
+
+void ProtocolEncoder::writeUint16LE(uint8_t *buffer, uint16_t value) {
+    buffer[0] = value & 0xFF;
+    buffer[1] = (value >> 8) & 0xFF;
+}
+
+void ProtocolEncoder::writeUint32LE(uint8_t *buffer, uint32_t value) {
+    buffer[0] = value & 0xFF;
+    buffer[1] = (value >> 8) & 0xFF;
+    buffer[2] = (value >> 16) & 0xFF;
+    buffer[3] = (value >> 24) & 0xFF;
+}
+
+void ProtocolEncoder::writeFrameHeader(uint8_t *buffer, uint8_t packetId,
+                                       uint8_t fragmentsSequence,
+                                       uint8_t moreFragmentsFlag,
+                                       uint16_t packetLength) {
+    buffer[0] = FRAME_DELIMITER_1;
+    buffer[1] = FRAME_DELIMITER_2;
+    buffer[2] = packetId;
+    buffer[3] = fragmentsSequence;
+    buffer[4] = moreFragmentsFlag;
+    writeUint16LE(buffer + 5, packetLength);
+}
+
+// 零拷贝打包核心：帧头、地址前缀和消息体依次直接写入调用方缓冲区
+size_t ProtocolEncoder::packFrameInto(uint8_t packetId, const uint8_t *prefix,
+                                      size_t prefixLength,
+                                      const Message &message, uint8_t *buffer,
+                                      size_t capacity,
+                                      uint8_t fragmentsSequence,
+                                      uint8_t moreFragmentsFlag) const {
+    size_t overhead = FRAME_HEADER_SIZE + prefixLength + crcTrailerSize();
+    if (buffer == nullptr || capacity < overhead) {
+        return 0;
+    }
+
+    size_t bodyLength = 0;
+    uint8_t *body = buffer + FRAME_HEADER_SIZE + prefixLength;
+    if (!message.serializeTo(body, capacity - overhead, bodyLength)) {
+        elog_w("ProtocolProcessor",
+               "Buffer too small for message 0x%02X, capacity: %d",
+               message.getMessageId(), capacity);
+        return 0;
+    }
+
+    size_t payloadLength = prefixLength + bodyLength;
+    if (payloadLength + crcTrailerSize() > 0xFFFF) {
+        elog_e("ProtocolProcessor", "Payload too large: %d bytes",
+               payloadLength);
+        return 0;
+    }
+
+    // 帧头、前缀和消息体按帧内顺序写入并累加CRC，不再回读整帧
+    bool crc = isCrcEnabled();
+    uint32_t state = beginFrame(buffer, packetId, fragmentsSequence,
+                                moreFragmentsFlag, payloadLength, crc);
+    std::memcpy(buffer + FRAME_HEADER_SIZE, prefix, prefixLength);
+    state = updateFrameCrc(state, prefix, prefixLength, crc);
+    state = updateFrameCrc(state, body, bodyLength, crc);
+    return finishFrame(buffer, FRAME_HEADER_SIZE + payloadLength, state, crc);
+}
+
+uint32_t ProtocolEncoder::beginFrame(uint8_t *buffer, uint8_t packetId,
+                                     uint8_t fragmentsSequence,
+                                     uint8_t moreFragmentsFlag,
+                                     size_t payloadLength, bool crc) {
+    if (crc) {
+        moreFragmentsFlag |= FRAME_FLAG_CRC32;
+        payloadLength += FRAME_CRC_SIZE;
+    }
+    writeFrameHeader(buffer, packetId, fragmentsSequence, moreFragmentsFlag,
+                     static_cast<uint16_t>(payloadLength));
+    return updateFrameCrc(Crc32::INITIAL, buffer, FRAME_HEADER_SIZE, crc);
+}
+
+uint32_t ProtocolEncoder::updateFrameCrc(uint32_t state, const uint8_t *data,
+                                         size_t length, bool crc) {
+    return crc ? Crc32::update(state, data, length) : state;
+}
+
+// 调用方需保证buffer在frameLength之后还有FRAME_CRC_SIZE字节空间
+size_t ProtocolEncoder::finishFrame(uint8_t *buffer, size_t frameLength,
+                                    uint32_t state, bool crc) {
+    if (!crc) {
+        return frameLength;
+    }
+    writeUint32LE(buffer + frameLength, Crc32::finalize(state));
+    return frameLength + FRAME_CRC_SIZE;
+}
+
+size_t ProtocolEncoder::packMaster2SlaveMessageInto(
+    uint32_t destinationId, const Message &message, uint8_t *buffer,
+    size_t capacity, uint8_t fragmentsSequence, uint8_t moreFragmentsFlag) const {
+    // 载荷前缀: messageId(1) + destinationId(4)
+    uint8_t prefix[ADDRESSED_PREFIX_SIZE];
+    prefix[0] = message.getMessageId();
+    writeUint32LE(prefix + 1, destinationId);
+
+    return packFrameInto(static_cast<uint8_t>(PacketId::MASTER_TO_SLAVE),
+                         prefix, sizeof(prefix), message, buffer, capacity,
+                         fragmentsSequence, moreFragmentsFlag);
+}
+
+size_t ProtocolEncoder::packSlave2MasterMessageInto(
+    uint32_t slaveId, const Message &message, uint8_t *buffer, size_t capacity,
+    uint8_t fragmentsSequence, uint8_t moreFragmentsFlag) const {
+    // 载荷前缀: messageId(1) + slaveId(4)
+    uint8_t prefix[ADDRESSED_PREFIX_SIZE];
+    prefix[0] = message.getMessageId();
+    writeUint32LE(prefix + 1, slaveId);
+
+    size_t length =
+        packFrameInto(static_cast<uint8_t>(PacketId::SLAVE_TO_MASTER), prefix,
+                      sizeof(prefix), message, buffer, capacity,
+                      fragmentsSequence, moreFragmentsFlag);
+
+    // 验证完整帧的关键字段（仅对COND_DATA_MSG）
+    if (message.getMessageId() == static_cast<uint8_t>(Slave2MasterMessageId::COND_DATA_MSG) && length >= 15) {
+        elog_i("ProtocolProcessor", "Complete COND_DATA_MSG frame - Payload[0-6]: [0x%02X 0x%02X 0x%02X 0x%02X 0x%02X 0x%02X 0x%02X]",
+               buffer[7], buffer[8], buffer[9], buffer[10],
+               buffer[11], buffer[12], buffer[13]);
+    }
+
+    return length;
+}
+
+size_t ProtocolEncoder::packSlave2MasterMessageInto(
+    uint32_t slaveId, const DeviceStatus &deviceStatus, const Message &message,
+    uint8_t *buffer, size_t capacity, uint8_t fragmentsSequence,
+    uint8_t moreFragmentsFlag) const {
+    // 载荷前缀: messageId(1) + slaveId(4) + deviceStatus(2)
+    uint8_t prefix[STATUS_PREFIX_SIZE];
+    prefix[0] = message.getMessageId();
+    writeUint32LE(prefix + 1, slaveId);
+    writeUint16LE(prefix + 5, deviceStatus.toUint16());
+
+    return packFrameInto(static_cast<uint8_t>(PacketId::SLAVE_TO_MASTER),
+                         prefix, sizeof(prefix), message, buffer, capacity,
+                         fragmentsSequence, moreFragmentsFlag);
+}
+
+size_t ProtocolEncoder::packSlave2MasterBatchInto(
+    uint32_t slaveId, const Message *const *messages, size_t count,
+    uint8_t *buffer, size_t capacity, size_t &packedCount) const {
+    size_t offset = 0;
+    packedCount = 0;
+    while (packedCount < count) {
+        size_t length = packSlave2MasterMessageInto(
+            slaveId, *messages[packedCount], buffer + offset, capacity - offset);
+        if (length == 0) break;    // 剩余空间放不下下一帧
+        offset += length;
+        ++packedCount;
+    }
+    return offset;
+}
+
+size_t ProtocolEncoder::packBackend2MasterMessageInto(
+    const Message &message, uint8_t *buffer, size_t capacity,
+    uint8_t fragmentsSequence, uint8_t moreFragmentsFlag) const {
+    uint8_t prefix[MESSAGE_ID_PREFIX_SIZE] = {message.getMessageId()};
+
+    return packFrameInto(static_cast<uint8_t>(PacketId::BACKEND_TO_MASTER),
+                         prefix, sizeof(prefix), message, buffer, capacity,
+                         fragmentsSequence, moreFragmentsFlag);
+}
+
+size_t ProtocolEncoder::packMaster2BackendMessageInto(
+    const Message &message, uint8_t *buffer, size_t capacity,
+    uint8_t fragmentsSequence, uint8_t moreFragmentsFlag) const {
+    uint8_t prefix[MESSAGE_ID_PREFIX_SIZE] = {message.getMessageId()};
+
+    return packFrameInto(static_cast<uint8_t>(PacketId::MASTER_TO_BACKEND),
+                         prefix, sizeof(prefix), message, buffer, capacity,
+                         fragmentsSequence, moreFragmentsFlag);
+}
+
+// 兼容旧接口：按消息长度一次性分配结果vector，再调用零拷贝打包
+std::vector<uint8_t> ProtocolEncoder::packMaster2SlaveMessageSingle(
+    uint32_t destinationId, const Message &message, uint8_t fragmentsSequence,
+    uint8_t moreFragmentsFlag) const {
+    std::vector<uint8_t> frame(FRAME_HEADER_SIZE + ADDRESSED_PREFIX_SIZE +
+                               message.getSerializedSize() + crcTrailerSize());
+    frame.resize(packMaster2SlaveMessageInto(destinationId, message,
+                                             frame.data(), frame.size(),
+                                             fragmentsSequence,
+                                             moreFragmentsFlag));
+    return frame;
+}
+
+std::vector<uint8_t> ProtocolEncoder::packSlave2MasterMessageSingle(
+    uint32_t slaveId, const Message &message, uint8_t fragmentsSequence,
+    uint8_t moreFragmentsFlag) const {
+    std::vector<uint8_t> frame(FRAME_HEADER_SIZE + ADDRESSED_PREFIX_SIZE +
+                               message.getSerializedSize() + crcTrailerSize());
+    frame.resize(packSlave2MasterMessageInto(slaveId, message, frame.data(),
+                                             frame.size(), fragmentsSequence,
+                                             moreFragmentsFlag));
+    return frame;
+}
+
+std::vector<uint8_t> ProtocolEncoder::packSlave2MasterMessageSingle(
+    uint32_t slaveId, const DeviceStatus &deviceStatus, const Message &message,
+    uint8_t fragmentsSequence, uint8_t moreFragmentsFlag) const {
+    std::vector<uint8_t> frame(FRAME_HEADER_SIZE + STATUS_PREFIX_SIZE +
+                               message.getSerializedSize() + crcTrailerSize());
+    frame.resize(packSlave2MasterMessageInto(slaveId, deviceStatus, message,
+                                             frame.data(), frame.size(),
+                                             fragmentsSequence,
+                                             moreFragmentsFlag));
+    return frame;
+}
+
+std::vector<uint8_t> ProtocolEncoder::packBackend2MasterMessageSingle(
+    const Message &message, uint8_t fragmentsSequence,
+    uint8_t moreFragmentsFlag) const {
+    std::vector<uint8_t> frame(FRAME_HEADER_SIZE + MESSAGE_ID_PREFIX_SIZE +
+                               message.getSerializedSize() + crcTrailerSize());
+    frame.resize(packBackend2MasterMessageInto(message, frame.data(),
+                                               frame.size(), fragmentsSequence,
+                                               moreFragmentsFlag));
+    return frame;
+}
+
+std::vector<uint8_t> ProtocolEncoder::packMaster2BackendMessageSingle(
+    const Message &message, uint8_t fragmentsSequence,
+    uint8_t moreFragmentsFlag) const {
+    std::vector<uint8_t> frame(FRAME_HEADER_SIZE + MESSAGE_ID_PREFIX_SIZE +
+                               message.getSerializedSize() + crcTrailerSize());
+    frame.resize(packMaster2BackendMessageInto(message, frame.data(),
+                                               frame.size(), fragmentsSequence,
+                                               moreFragmentsFlag));
+    return frame;
+}
+
+// 支持自动分片的打包函数
+std::vector<std::vector<uint8_t>> ProtocolEncoder::packMaster2SlaveMessage(
+    uint32_t destinationId, const Message &message) const {
+    // 首先生成单个完整帧
+    auto completeFrame =
+        packMaster2SlaveMessageSingle(destinationId, message, 0, 0);
+
+    // 检查是否需要分片
+    if (completeFrame.size() <= mtu_) {
+        // 不需要分片，直接返回
+        return wrapSingleFrame(std::move(completeFrame));
+    }
+
+    // 需要分片
+    return fragmentFrame(completeFrame);
+}
+
+std::vector<std::vector<uint8_t>> ProtocolEncoder::packSlave2MasterMessage(
+    uint32_t slaveId, const Message &message) const {
+    // 首先生成单个完整帧
+    auto completeFrame = packSlave2MasterMessageSingle(slaveId, message, 0, 0);
+
+    // 检查是否需要分片
+    if (completeFrame.size() <= mtu_) {
+        // 不需要分片，直接返回
+        return wrapSingleFrame(std::move(completeFrame));
+    }
+
+    // 需要分片
+    return fragmentFrame(completeFrame);
+}
+
+std::vector<std::vector<uint8_t>> ProtocolEncoder::packSlave2MasterMessage(
+    uint32_t slaveId, const DeviceStatus &deviceStatus, const Message &message) const {
+    // 首先生成单个完整帧（带DeviceStatus）
+    auto completeFrame = packSlave2MasterMessageSingle(slaveId, deviceStatus, message, 0, 0);
+
+    // 检查是否需要分片
+    if (completeFrame.size() <= mtu_) {
+        // 不需要分片，直接返回
+        return wrapSingleFrame(std::move(completeFrame));
+    }
+
+    // 需要分片，对于COND_DATA_MSG，需要特殊处理以确保每包都包含ID+DeviceStatus
+    return fragmentFrameWithStatus(completeFrame);
+}
+
+// 校验打包：数据分片按 (MTU - 校验字段) 切分，使每个校验帧与最长的数据分片等长
+std::vector<std::vector<uint8_t>> ProtocolEncoder::packSlave2MasterMessageWithParity(
+    uint32_t slaveId, const DeviceStatus &deviceStatus, const Message &message,
+    uint8_t parityCount) const {
+    if (parityCount == 0) {
+        return packSlave2MasterMessage(slaveId, deviceStatus, message);
+    }
+
+    auto completeFrame = packSlave2MasterMessageSingle(slaveId, deviceStatus, message, 0, 0);
+    constexpr size_t parityFields = Slave2Master::ConductionParityMessage::Schema::FIXED_SIZE;
+    auto fragments = fragmentFrameWithStatus(completeFrame, parityFields);
+
+    size_t overhead = FRAME_HEADER_SIZE + STATUS_PREFIX_SIZE + crcTrailerSize();
+    size_t dataLength = completeFrame.size() - overhead;
+    if (mtu_ <= overhead + parityFields || dataLength == 0 || dataLength > 0xFFFF) {
+        return fragments;
+    }
+    size_t chunkSize = std::min(mtu_ - overhead - parityFields, dataLength);
+    const uint8_t *data = completeFrame.data() + FRAME_HEADER_SIZE + STATUS_PREFIX_SIZE;
+
+    // 校验组数不超过数据块数，多余的组没有数据可保护
+    size_t chunks = FragmentParity::chunkCount(dataLength, chunkSize);
+    uint8_t groups = static_cast<uint8_t>(std::min<size_t>(parityCount, chunks));
+
+    Slave2Master::ConductionParityMessage parityMsg;
+    parityMsg.parityCount = groups;
+    parityMsg.dataLength = static_cast<uint16_t>(dataLength);
+    parityMsg.parity.resize(chunkSize);
+    fragments.reserve(fragments.size() + groups);
+    for (uint8_t i = 0; i < groups; ++i) {
+        parityMsg.parityIndex = i;
+        FragmentParity::encode(data, dataLength, chunkSize, groups, i,
+                               parityMsg.parity.data());
+        fragments.push_back(
+            packSlave2MasterMessageSingle(slaveId, deviceStatus, parityMsg, 0, 0));
+    }
+
+    elog_v("ProtocolProcessor", "Parity packing: %d data fragments + %d parity",
+           fragments.size() - groups, groups);
+    return fragments;
+}
+
+// 紧凑分片步长：后续分片前缀比首个分片多一个字节，按后续分片计算
+// fragmentOffset字节以8字节为单位，最后一个分片的偏移必须能放进一个字节
+bool ProtocolEncoder::planCompactFragments(size_t streamLength,
+                                           size_t maxPayloadSize,
+                                           size_t &stride,
+                                           size_t &totalFragments) {
+    stride = maxPayloadSize - COMPACT_NEXT_PREFIX_SIZE;
+    if (streamLength + 1 <= maxPayloadSize) {
+        stride = streamLength;    // 单帧即可容纳
+    }
+    totalFragments = (streamLength + stride - 1) / stride;
+    size_t lastOffset = (totalFragments - 1) * stride;
+    if (totalFragments > 0xFF ||
+        (lastOffset >> COMPACT_OFFSET_SHIFT) > COMPACT_MAX_FRAGMENT_OFFSET) {
+        elog_w("ProtocolProcessor",
+               "Stream too large for compact fragments: %d bytes, last "
+               "offset: %d",
+               streamLength, lastOffset);
+        return false;
+    }
+    return true;
+}
+
+// 紧凑短ID打包：分片数据在 [messageId + status + 消息体] 流中按固定步长划分，
+// 首个分片在messageId后插入shortId，后续分片以shortId + fragmentOffset开头
+std::vector<std::vector<uint8_t>> ProtocolEncoder::packSlave2MasterMessageCompact(
+    uint8_t shortId, const DeviceStatus &deviceStatus,
+    const Message &message) const {
+    std::vector<uint8_t> stream(COMPACT_STREAM_HEADER_SIZE +
+                                message.getSerializedSize());
+    stream[0] = message.getMessageId();
+    writeUint16LE(stream.data() + 1, deviceStatus.toUint16());
+    size_t bodyLength = 0;
+    if (!message.serializeTo(stream.data() + COMPACT_STREAM_HEADER_SIZE,
+                             stream.size() - COMPACT_STREAM_HEADER_SIZE,
+                             bodyLength)) {
+        return {};
+    }
+    stream.resize(COMPACT_STREAM_HEADER_SIZE + bodyLength);
+
+    bool crc = isCrcEnabled();
+    size_t overhead = FRAME_HEADER_SIZE + crcTrailerSize();
+    if (mtu_ <= overhead + COMPACT_NEXT_PREFIX_SIZE) {
+        elog_e("ProtocolProcessor", "MTU too small for compact frame: %d",
+               mtu_);
+        return {};
+    }
+    size_t stride = 0;
+    size_t totalFragments = 0;
+    if (!planCompactFragments(stream.size(), mtu_ - overhead, stride,
+                              totalFragments)) {
+        return {};
+    }
+
+    std::vector<std::vector<uint8_t>> fragments;
+    fragments.reserve(totalFragments);
+
+    for (size_t i = 0; i < totalFragments; ++i) {
+        size_t startPos = i * stride;
+        size_t dataSize = std::min(stride, stream.size() - startPos);
+        size_t prefixSize = (i == 0) ? 1 : COMPACT_NEXT_PREFIX_SIZE;
+        size_t payloadLength = prefixSize + dataSize;
+        uint8_t flags = FRAME_FLAG_SHORT_ID;
+        if (i != totalFragments - 1) {
+            flags |= 1;
+        }
+
+        auto &fragment = fragments.emplace_back(FRAME_HEADER_SIZE +
+                                                payloadLength + crcTrailerSize());
+        uint8_t *payload = fragment.data() + FRAME_HEADER_SIZE;
+        uint32_t state = beginFrame(fragment.data(),
+                                    static_cast<uint8_t>(PacketId::SLAVE_TO_MASTER),
+                                    static_cast<uint8_t>(i), flags,
+                                    payloadLength, crc);
+        if (i == 0) {
+            // messageId + shortId + status + 数据
+            payload[0] = stream[0];
+            payload[1] = shortId;
+            std::memcpy(payload + 2, stream.data() + 1, dataSize - 1);
+        } else {
+            payload[0] = shortId;
+            payload[1] = static_cast<uint8_t>(startPos >> COMPACT_OFFSET_SHIFT);
+            std::memcpy(payload + 2, stream.data() + startPos, dataSize);
+        }
+        state = updateFrameCrc(state, payload, payloadLength, crc);
+        finishFrame(fragment.data(), FRAME_HEADER_SIZE + payloadLength, state,
+                    crc);
+    }
+
+    elog_v("ProtocolProcessor",
+           "Compact packing completed, ShortId: %d, generated %d fragments",
+           shortId, fragments.size());
+    return fragments;
+}
+
+// 分片游标：只计算划分方式，分片在packConductionFragmentInto中按需生成
+bool ProtocolEncoder::beginConductionFragments(
+    ConductionFragmentCursor &cursor, uint32_t slaveId,
+    const DeviceStatus &deviceStatus, const uint8_t *data, size_t length,
+    uint8_t parityCount, Slave2MasterMessageId messageId) const {
+    cursor = ConductionFragmentCursor();
+    cursor.crc = isCrcEnabled();
+    size_t overhead = FRAME_HEADER_SIZE + STATUS_PREFIX_SIZE + crcTrailerSize();
+    size_t reserved = (parityCount > 0)
+        ? Slave2Master::ConductionParityMessage::Schema::FIXED_SIZE
+        : 0;
+    if (data == nullptr || length == 0 || length > 0xFFFF ||
+        mtu_ <= overhead + reserved) {
+        return false;
+    }
+
+    // 与fragmentFrameWithStatus相同的划分：能单帧发送时只有一个分片
+    size_t chunkSize = mtu_ - overhead - reserved;
+    if (parityCount == 0 && overhead + length <= mtu_) {
+        chunkSize = length;
+    }
+    size_t chunks = (length + chunkSize - 1) / chunkSize;
+    if (chunks > 0xFF) {
+        elog_w("ProtocolProcessor", "Too many fragments for cursor: %d",
+               chunks);
+        return false;
+    }
+
+    cursor.data = data;
+    cursor.dataLength = length;
+    cursor.messageId = static_cast<uint8_t>(messageId);
+    cursor.slaveId = slaveId;
+    cursor.status = deviceStatus.toUint16();
+    cursor.chunkSize = std::min(chunkSize, length);
+    cursor.dataFragments = static_cast<uint8_t>(chunks);
+    cursor.parityFragments =
+        static_cast<uint8_t>(std::min<size_t>(parityCount, chunks));
+    return true;
+}
+
+bool ProtocolEncoder::beginCompactConductionFragments(
+    ConductionFragmentCursor &cursor, uint8_t shortId,
+    const DeviceStatus &deviceStatus, const uint8_t *data, size_t length,
+    Slave2MasterMessageId messageId) const {
+    cursor = ConductionFragmentCursor();
+    cursor.crc = isCrcEnabled();
+    size_t overhead = FRAME_HEADER_SIZE + crcTrailerSize();
+    if (data == nullptr || length == 0 || shortId == 0 ||
+        mtu_ <= overhead + COMPACT_NEXT_PREFIX_SIZE) {
+        return false;
+    }
+    // 与packSlave2MasterMessageCompact相同的步长
+    size_t stride = 0;
+    size_t totalFragments = 0;
+    if (!planCompactFragments(COMPACT_STREAM_HEADER_SIZE + length,
+                              mtu_ - overhead, stride, totalFragments)) {
+        return false;
+    }
+
+    cursor.data = data;
+    cursor.dataLength = length;
+    cursor.messageId = static_cast<uint8_t>(messageId);
+    cursor.shortId = shortId;
+    cursor.status = deviceStatus.toUint16();
+    cursor.chunkSize = stride;
+    cursor.dataFragments = static_cast<uint8_t>(totalFragments);
+    return true;
+}
+
+size_t ProtocolEncoder::conductionFragmentDataEnd(
+    const ConductionFragmentCursor &cursor, size_t index) {
+    if (index >= cursor.dataFragments) {
+        return cursor.dataLength;
+    }
+    size_t end = (index + 1) * cursor.chunkSize;
+    if (cursor.shortId != 0) {
+        // 紧凑分片按流 [messageId + status + 导通数据] 划分
+        end = end > COMPACT_STREAM_HEADER_SIZE ? end - COMPACT_STREAM_HEADER_SIZE : 0;
+    }
+    return std::min(end, cursor.dataLength);
+}
+
+void ProtocolEncoder::copyCompactStream(const ConductionFragmentCursor &cursor,
+                                        size_t start, size_t length,
+                                        uint8_t *out) {
+    // 流头部 messageId + status 不在导通数据中，逐字节生成
+    uint8_t header[COMPACT_STREAM_HEADER_SIZE] = {
+        cursor.messageId,
+        static_cast<uint8_t>(cursor.status & 0xFF),
+        static_cast<uint8_t>(cursor.status >> 8)};
+    while (length > 0 && start < COMPACT_STREAM_HEADER_SIZE) {
+        *out++ = header[start++];
+        --length;
+    }
+    if (length > 0) {
+        std::memcpy(out, cursor.data + (start - COMPACT_STREAM_HEADER_SIZE),
+                    length);
+    }
+}
+
+size_t ProtocolEncoder::packConductionFragmentInto(
+    const ConductionFragmentCursor &cursor, size_t index, uint8_t *buffer,
+    size_t capacity) const {
+    if (buffer == nullptr || index >= cursor.fragmentCount()) {
+        return 0;
+    }
+    const bool crc = cursor.crc;
+    size_t trailer = crc ? FRAME_CRC_SIZE : 0;
+    uint8_t *payload = buffer + FRAME_HEADER_SIZE;
+    size_t payloadLength = 0;
+    uint8_t flags = (index + 1 < cursor.dataFragments) ? FRAME_FLAG_MORE_FRAGMENTS : 0;
+    flags |= static_cast<uint8_t>(cursor.cycle << FRAME_CYCLE_SHIFT) & FRAME_CYCLE_MASK;
+    uint32_t state = 0;
+
+    // 各分支先确定载荷长度写入帧头，再依次写入载荷各段并累加CRC
+    if (cursor.shortId != 0) {
+        // 紧凑短ID帧
+        size_t streamLength = COMPACT_STREAM_HEADER_SIZE + cursor.dataLength;
+        size_t startPos = index * cursor.chunkSize;
+        size_t dataSize = std::min(cursor.chunkSize, streamLength - startPos);
+        payloadLength = ((index == 0) ? 1 : COMPACT_NEXT_PREFIX_SIZE) + dataSize;
+        if (capacity < FRAME_HEADER_SIZE + payloadLength + trailer) return 0;
+
+        state = beginFrame(buffer, static_cast<uint8_t>(PacketId::SLAVE_TO_MASTER),
+                           static_cast<uint8_t>(index), flags | FRAME_FLAG_SHORT_ID,
+                           payloadLength, crc);
+        if (index == 0) {
+            payload[0] = cursor.messageId;
+            payload[1] = cursor.shortId;
+            copyCompactStream(cursor, 1, dataSize - 1, payload + 2);
+        } else {
+            payload[0] = cursor.shortId;
+            payload[1] = static_cast<uint8_t>(startPos >> COMPACT_OFFSET_SHIFT);
+            copyCompactStream(cursor, startPos, dataSize, payload + 2);
+        }
+        state = updateFrameCrc(state, payload, payloadLength, crc);
+    } else if (index < cursor.dataFragments) {
+        // 数据分片: messageId + slaveId + deviceStatus + 部分导通数据
+        size_t startPos = index * cursor.chunkSize;
+        size_t dataSize = std::min(cursor.chunkSize, cursor.dataLength - startPos);
+        payloadLength = STATUS_PREFIX_SIZE + dataSize;
+        if (capacity < FRAME_HEADER_SIZE + payloadLength + trailer) return 0;
+
+        state = beginFrame(buffer, static_cast<uint8_t>(PacketId::SLAVE_TO_MASTER),
+                           static_cast<uint8_t>(index), flags, payloadLength, crc);
+        payload[0] = cursor.messageId;
+        writeUint32LE(payload + 1, cursor.slaveId);
+        writeUint16LE(payload + 5, cursor.status);
+        state = updateFrameCrc(state, payload, STATUS_PREFIX_SIZE, crc);
+        // 导通数据直接从源数据累加CRC，与拷贝一起完成
+        const uint8_t *source = cursor.data + startPos;
+        std::memcpy(payload + STATUS_PREFIX_SIZE, source, dataSize);
+        state = updateFrameCrc(state, source, dataSize, crc);
+    } else {
+        // 校验分片: 与ConductionParityMessage的单帧打包一致
+        constexpr size_t parityFields =
+            Slave2Master::ConductionParityMessage::Schema::FIXED_SIZE;
+        uint8_t parityIndex = static_cast<uint8_t>(index - cursor.dataFragments);
+        payloadLength = STATUS_PREFIX_SIZE + parityFields + cursor.chunkSize;
+        if (capacity < FRAME_HEADER_SIZE + payloadLength + trailer) return 0;
+
+        state = beginFrame(buffer, static_cast<uint8_t>(PacketId::SLAVE_TO_MASTER),
+                           0, flags, payloadLength, crc);
+        payload[0] = static_cast<uint8_t>(Slave2MasterMessageId::COND_PARITY_MSG);
+        writeUint32LE(payload + 1, cursor.slaveId);
+        writeUint16LE(payload + 5, cursor.status);
+        payload[7] = parityIndex;
+        payload[8] = cursor.parityFragments;
+        writeUint16LE(payload + 9, static_cast<uint16_t>(cursor.dataLength));
+        FragmentParity::encode(cursor.data, cursor.dataLength, cursor.chunkSize,
+                               cursor.parityFragments, parityIndex,
+                               payload + STATUS_PREFIX_SIZE + parityFields);
+        state = updateFrameCrc(state, payload, payloadLength, crc);
+    }
+
+    return finishFrame(buffer, FRAME_HEADER_SIZE + payloadLength, state, crc);
+}
+
+std::vector<std::vector<uint8_t>> ProtocolEncoder::packBackend2MasterMessage(
+    const Message &message) const {
+    // 首先生成单个完整帧
+    auto completeFrame = packBackend2MasterMessageSingle(message, 0, 0);
+
+    // 检查是否需要分片
+    if (completeFrame.size() <= mtu_) {
+        // 不需要分片，直接返回
+        return wrapSingleFrame(std::move(completeFrame));
+    }
+
+    // 需要分片
+    return fragmentFrame(completeFrame);
+}
+
+std::vector<std::vector<uint8_t>> ProtocolEncoder::packMaster2BackendMessage(
+    const Message &message) const {
+    // 首先生成单个完整帧
+    auto completeFrame = packMaster2BackendMessageSingle(message, 0, 0);
+
+    // 检查是否需要分片
+    if (completeFrame.size() <= mtu_) {
+        // 不需要分片，直接返回
+        return wrapSingleFrame(std::move(completeFrame));
+    }
+
+    // 需要分片
+    return fragmentFrame(completeFrame);
+}
+
+std::vector<std::vector<uint8_t>>
+ProtocolEncoder::wrapSingleFrame(std::vector<uint8_t> &&frameData) {
+    std::vector<std::vector<uint8_t>> frames;
+    frames.push_back(std::move(frameData));
+    return frames;
+}
+
+// 分片功能实现
+std::vector<std::vector<uint8_t>> ProtocolEncoder::fragmentFrame(
+    const std::vector<uint8_t> &frameData) const {
+    elog_v("ProtocolProcessor",
+           "Starting frame fragmentation, original frame size: %d bytes, MTU: "
+           "%d",
+           frameData.size(), mtu_);
+
+    if (frameData.size() < FRAME_HEADER_SIZE + frameTrailerSize(frameData) ||
+        mtu_ <= FRAME_HEADER_SIZE + crcTrailerSize()) {
+        elog_w("ProtocolProcessor",
+               "Cannot fragment frame: %d bytes, MTU: %d", frameData.size(),
+               mtu_);
+        return {frameData};
+    }
+
+    // Parse original frame header
+    uint8_t packetId = frameData[2];
+    elog_v("ProtocolProcessor", "Original frame PacketId: 0x%02X", packetId);
+
+    // Calculate effective payload size per fragment (MTU - 7 bytes frame
+    // header - CRC trailer)
+    bool crc = isCrcEnabled();
+    size_t fragmentPayloadSize = mtu_ - FRAME_HEADER_SIZE - crcTrailerSize();
+    elog_v("ProtocolProcessor", "Maximum payload size per fragment: %d bytes",
+           fragmentPayloadSize);
+
+    // 原始payload直接按偏移读取，不再复制到中间buffer
+    const uint8_t *payload = frameData.data() + FRAME_HEADER_SIZE;
+    size_t payloadSize =
+        frameData.size() - FRAME_HEADER_SIZE - frameTrailerSize(frameData);
+    elog_v("ProtocolProcessor", "Original payload size: %d bytes",
+           payloadSize);
+
+    // Calculate how many fragments are needed
+    uint8_t totalFragments = static_cast<uint8_t>(
+        (payloadSize + fragmentPayloadSize - 1) / fragmentPayloadSize);
+    elog_v("ProtocolProcessor", "Total fragments needed: %d", totalFragments);
+
+    std::vector<std::vector<uint8_t>> fragments;
+    fragments.reserve(totalFragments);
+
+    // Generate each fragment
+    for (uint8_t i = 0; i < totalFragments; ++i) {
+        size_t startPos = i * fragmentPayloadSize;
+        size_t fragmentSize =
+            std::min(fragmentPayloadSize, payloadSize - startPos);
+        uint8_t moreFragments = (i == totalFragments - 1) ? 0 : 1;
+
+        // 分片直接在结果中构建，不经过中间buffer
+        auto &fragment = fragments.emplace_back(
+            FRAME_HEADER_SIZE + fragmentSize + crcTrailerSize());
+        uint32_t state = beginFrame(fragment.data(), packetId, i, moreFragments,
+                                    fragmentSize, crc);
+        std::memcpy(fragment.data() + FRAME_HEADER_SIZE, payload + startPos,
+                    fragmentSize);
+        state = updateFrameCrc(state, payload + startPos, fragmentSize, crc);
+        finishFrame(fragment.data(), FRAME_HEADER_SIZE + fragmentSize, state,
+                    crc);
+
+        elog_v("ProtocolProcessor",
+               "Fragment #%d/%d, sequence=%d, more_fragments=%d, "
+               "fragment_size=%d, payload_size=%d",
+               i, totalFragments - 1, i, moreFragments, fragment.size(),
+               fragmentSize);
+    }
+
+    elog_v("ProtocolProcessor",
+           "Fragmentation completed, generated %d fragments", fragments.size());
+    return fragments;
+}
+
+// 分片功能实现（带DeviceStatus，用于COND_DATA_MSG）
+std::vector<std::vector<uint8_t>> ProtocolEncoder::fragmentFrameWithStatus(
+    const std::vector<uint8_t> &frameData, size_t reservedBytes) const {
+    elog_v("ProtocolProcessor",
+           "Starting frame fragmentation with status, original frame size: %d bytes, MTU: %d",
+           frameData.size(), mtu_);
+
+    // 对于COND_DATA_MSG，payload结构是: messageId(1) + slaveId(4) + deviceStatus(2) + conductionData(variable)
+    if (frameData.size() < FRAME_HEADER_SIZE + STATUS_PREFIX_SIZE + frameTrailerSize(frameData)) {
+        elog_e("ProtocolProcessor", "Payload too small for COND_DATA_MSG");
+        return {frameData};
+    }
+
+    // 每个分片的payload需要包含: messageId(1) + slaveId(4) + deviceStatus(2) + 部分conductionData
+    if (mtu_ <= FRAME_HEADER_SIZE + STATUS_PREFIX_SIZE + crcTrailerSize() + reservedBytes) {
+        elog_e("ProtocolProcessor", "MTU too small for COND_DATA_MSG fragmentation");
+        return {frameData};
+    }
+    bool crc = isCrcEnabled();
+    size_t conductionDataPerFragment =
+        mtu_ - FRAME_HEADER_SIZE - STATUS_PREFIX_SIZE - crcTrailerSize() - reservedBytes;
+
+    // 从原始帧中直接引用 messageId + slaveId + deviceStatus 前缀和导通数据，确保每包使用相同的值
+    uint8_t packetId = frameData[2];
+    const uint8_t *prefix = frameData.data() + FRAME_HEADER_SIZE;
+    const uint8_t *conductionData = prefix + STATUS_PREFIX_SIZE;
+    size_t conductionDataSize = frameData.size() - FRAME_HEADER_SIZE - STATUS_PREFIX_SIZE -
+                                frameTrailerSize(frameData);
+
+    elog_v("ProtocolProcessor", "Conduction data size: %d bytes", conductionDataSize);
+
+    // Calculate how many fragments are needed
+    uint8_t totalFragments = static_cast<uint8_t>(
+        (conductionDataSize + conductionDataPerFragment - 1) / conductionDataPerFragment);
+    elog_v("ProtocolProcessor", "Total fragments needed: %d", totalFragments);
+
+    elog_i("ProtocolProcessor", "Fragment #0 - Writing: messageId=0x%02X, extractedSlaveId=0x%08X, deviceStatus=0x%04X",
+           prefix[0], prefix[1] | (prefix[2] << 8) | (prefix[3] << 16) | (prefix[4] << 24),
+           prefix[5] | (prefix[6] << 8));
+
+    std::vector<std::vector<uint8_t>> fragments;
+    fragments.reserve(totalFragments);
+
+    // Generate each fragment
+    for (uint8_t i = 0; i < totalFragments; ++i) {
+        size_t startPos = i * conductionDataPerFragment;
+        size_t fragmentConductionSize =
+            std::min(conductionDataPerFragment, conductionDataSize - startPos);
+        size_t payloadLength = STATUS_PREFIX_SIZE + fragmentConductionSize;
+
+        // 分片直接在结果中构建: 帧头 + 前缀 + 部分导通数据
+        auto &fragment =
+            fragments.emplace_back(FRAME_HEADER_SIZE + payloadLength + crcTrailerSize());
+        uint32_t state = beginFrame(fragment.data(), packetId, i,
+                                    (i == totalFragments - 1) ? 0 : 1,
+                                    payloadLength, crc);
+        std::memcpy(fragment.data() + FRAME_HEADER_SIZE, prefix, STATUS_PREFIX_SIZE);
+        std::memcpy(fragment.data() + FRAME_HEADER_SIZE + STATUS_PREFIX_SIZE,
+                    conductionData + startPos, fragmentConductionSize);
+        state = updateFrameCrc(state, prefix, STATUS_PREFIX_SIZE, crc);
+        state = updateFrameCrc(state, conductionData + startPos,
+                               fragmentConductionSize, crc);
+        finishFrame(fragment.data(), FRAME_HEADER_SIZE + payloadLength, state,
+                    crc);
+    }
+
+    elog_v("ProtocolProcessor",
+           "Fragmentation with status completed, generated %d fragments", fragments.size());
+    return fragments;
+}
+
+}    // namespace WhtsProtocol
@@ -0,0 +1,264 @@
+#ifndef WHTS_PROTOCOL_ENCODER_H
+#define WHTS_PROTOCOL_ENCODER_H
+
+#include "Common.h"
+#include "DeviceStatus.h"
+#include "messages/Message.h"
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+namespace WhtsProtocol {
+
+// 导通数据分片游标
+// 只描述一次分片发送的划分方式（不持有数据），分片由ProtocolEncoder按序号生成，
+// 发送时直接写入调用方缓冲区，内存占用与分片数无关
+struct ConductionFragmentCursor {
+    const uint8_t *data = nullptr; // 导通数据（不复制，发送期间必须保持有效）
+    size_t dataLength = 0;
+    uint8_t messageId = 0;         // 数据分片的消息ID（COND_DATA_MSG 或 COND_DATA_ENC_MSG）
+    uint32_t slaveId = 0;
+    uint8_t shortId = 0;           // 非0时生成紧凑短ID帧
+    uint16_t status = 0;           // DeviceStatus
+    bool crc = false;              // 创建游标时的CRC设置，保证分片大小一致
+    size_t chunkSize = 0;          // 每个数据分片的导通数据字节数（紧凑帧为流步长）
+    uint8_t dataFragments = 0;     // 数据分片数
+    uint8_t parityFragments = 0;   // 数据分片之后的校验分片数
+    uint8_t cycle = 0;             // 写入各分片帧头的周期号（0~31，见FRAME_CYCLE_MASK），由调用方设置
+
+    size_t fragmentCount() const { return dataFragments + parityFragments; }
+};
+
+// 协议编码器（发送路径）
+// 打包只读取配置（MTU、CRC开关），帧直接写入调用方缓冲区或返回的vector，
+// 不使用共享的中间buffer，因此可以与ProtocolDecoder在不同任务中并发使用
+class ProtocolEncoder {
+  public:
+    ProtocolEncoder();
+
+    // 设置最大传输单元大小 (MTU)
+    void SetMTU(size_t mtu) { mtu_ = mtu; }
+    size_t getMTU() const { return mtu_; }
+
+    // 启用/禁用发送帧尾CRC-32（可由解码器在收到对端带CRC的帧时启用）
+    void SetCrcEnabled(bool enabled) {
+        crcEnabled_.store(enabled, std::memory_order_relaxed);
+    }
+    bool isCrcEnabled() const {
+        return crcEnabled_.load(std::memory_order_relaxed);
+    }
+
+    // 打包Master2Slave消息 (支持自动分片)
+    std::vector<std::vector<uint8_t>>
+    packMaster2SlaveMessage(uint32_t destinationId,
+                            const Message &message) const;
+
+    // 打包Slave2Master消息 (支持自动分片)
+    std::vector<std::vector<uint8_t>>
+    packSlave2MasterMessage(uint32_t slaveId, const Message &message) const;
+
+    // 打包Slave2Master消息 (支持自动分片，带DeviceStatus，用于COND_DATA_MSG)
+    std::vector<std::vector<uint8_t>>
+    packSlave2MasterMessage(uint32_t slaveId, const DeviceStatus &deviceStatus,
+                            const Message &message) const;
+
+    // 打包Slave2Master消息 (紧凑短ID头，带DeviceStatus，用于COND_DATA_MSG)
+    // 用1字节短ID代替4字节从机ID，后续分片不再重复messageId和DeviceStatus
+    // 数据超过紧凑分片偏移可表示的范围或MTU过小时返回空列表
+    std::vector<std::vector<uint8_t>>
+    packSlave2MasterMessageCompact(uint8_t shortId,
+                                   const DeviceStatus &deviceStatus,
+                                   const Message &message) const;
+
+    // 打包Slave2Master消息并追加校验分片（带DeviceStatus，用于COND_DATA_MSG）
+    // 数据分片之后追加parityCount个COND_PARITY_MSG帧（见FragmentParity），
+    // 数据分片为校验字段让出空间，使校验帧不超过MTU；parityCount为0时等同于普通打包
+    std::vector<std::vector<uint8_t>>
+    packSlave2MasterMessageWithParity(uint32_t slaveId,
+                                      const DeviceStatus &deviceStatus,
+                                      const Message &message,
+                                      uint8_t parityCount) const;
+
+    // 导通数据分片游标 - 不预先生成全部分片，发送时按序号生成分片N
+    // 生成的分片与 packSlave2MasterMessage / ...WithParity / ...Compact 打包
+    // 消息体为data的导通数据消息的结果逐字节一致（cycle为0时），无法分片时返回false
+    bool beginConductionFragments(
+        ConductionFragmentCursor &cursor, uint32_t slaveId,
+        const DeviceStatus &deviceStatus, const uint8_t *data, size_t length,
+        uint8_t parityCount = 0,
+        Slave2MasterMessageId messageId = Slave2MasterMessageId::COND_DATA_MSG) const;
+
+    // 紧凑短ID分片；数据超出紧凑分片偏移范围时返回false，调用方应改用标准帧
+    bool beginCompactConductionFragments(
+        ConductionFragmentCursor &cursor, uint8_t shortId,
+        const DeviceStatus &deviceStatus, const uint8_t *data, size_t length,
+        Slave2MasterMessageId messageId = Slave2MasterMessageId::COND_DATA_MSG) const;
+
+    // 导通数据分片中非导通数据的字节数（帧头、前缀、CRC），用于按帧长规划分片
+    size_t conductionFragmentOverhead(bool compact) const {
+        return FRAME_HEADER_SIZE + crcTrailerSize() +
+               (compact ? COMPACT_NEXT_PREFIX_SIZE : STATUS_PREFIX_SIZE);
+    }
+
+    // 生成游标的第index个分片需要的导通数据长度（从cursor.data起），校验分片需要全部数据
+    // 数据逐步写入（边采集边发送）时据此判断分片是否就绪
+    static size_t conductionFragmentDataEnd(const ConductionFragmentCursor &cursor,
+                                            size_t index);
+
+    // 将游标的第index个分片写入buffer，返回帧长度，序号无效或缓冲区不足时返回0
+    size_t packConductionFragmentInto(const ConductionFragmentCursor &cursor,
+                                      size_t index, uint8_t *buffer,
+                                      size_t capacity) const;
+
+    // 打包Backend2Master消息 (支持自动分片)
+    std::vector<std::vector<uint8_t>>
+    packBackend2MasterMessage(const Message &message) const;
+
+    // 打包Master2Backend消息 (支持自动分片)
+    std::vector<std::vector<uint8_t>>
+    packMaster2BackendMessage(const Message &message) const;
+
+    // 零拷贝单帧打包 - 帧头和消息体直接写入调用方提供的缓冲区
+    // （例如MasterComm的发送缓冲区），返回写入的帧长度，缓冲区不足时返回0
+    size_t packMaster2SlaveMessageInto(uint32_t destinationId,
+                                       const Message &message, uint8_t *buffer,
+                                       size_t capacity,
+                                       uint8_t fragmentsSequence = 0,
+                                       uint8_t moreFragmentsFlag = 0) const;
+
+    size_t packSlave2MasterMessageInto(uint32_t slaveId, const Message &message,
+                                       uint8_t *buffer, size_t capacity,
+                                       uint8_t fragmentsSequence = 0,
+                                       uint8_t moreFragmentsFlag = 0) const;
+
+    // 批量打包 - 多个单帧消息首尾相接写入同一缓冲区，每帧保留自己的帧头分隔符，
+    // 接收端processReceivedData逐帧提取，无需额外处理
+    // 按顺序打包到第一个放不下的消息为止，packedCount返回已打包的消息数，返回写入的总长度
+    size_t packSlave2MasterBatchInto(uint32_t slaveId,
+                                     const Message *const *messages,
+                                     size_t count, uint8_t *buffer,
+                                     size_t capacity,
+                                     size_t &packedCount) const;
+
+    // 零拷贝单帧打包（带DeviceStatus，用于COND_DATA_MSG）
+    size_t packSlave2MasterMessageInto(uint32_t slaveId,
+                                       const DeviceStatus &deviceStatus,
+                                       const Message &message, uint8_t *buffer,
+                                       size_t capacity,
+                                       uint8_t fragmentsSequence = 0,
+                                       uint8_t moreFragmentsFlag = 0) const;
+
+    size_t packBackend2MasterMessageInto(const Message &message,
+                                         uint8_t *buffer, size_t capacity,
+                                         uint8_t fragmentsSequence = 0,
+                                         uint8_t moreFragmentsFlag = 0) const;
+
+    size_t packMaster2BackendMessageInto(const Message &message,
+                                         uint8_t *buffer, size_t capacity,
+                                         uint8_t fragmentsSequence = 0,
+                                         uint8_t moreFragmentsFlag = 0) const;
+
+    // 兼容旧接口 - 单帧打包（基于零拷贝打包接口的封装）
+    std::vector<uint8_t> packMaster2SlaveMessageSingle(
+        uint32_t destinationId, const Message &message,
+        uint8_t fragmentsSequence = 0, uint8_t moreFragmentsFlag = 0) const;
+
+    std::vector<uint8_t>
+    packSlave2MasterMessageSingle(uint32_t slaveId, const Message &message,
+                                  uint8_t fragmentsSequence = 0,
+                                  uint8_t moreFragmentsFlag = 0) const;
+
+    // 打包Slave2Master消息单帧（带DeviceStatus，用于COND_DATA_MSG）
+    std::vector<uint8_t>
+    packSlave2MasterMessageSingle(uint32_t slaveId, const DeviceStatus &deviceStatus,
+                                  const Message &message,
+                                  uint8_t fragmentsSequence = 0,
+                                  uint8_t moreFragmentsFlag = 0) const;
+
+    std::vector<uint8_t>
+    packBackend2MasterMessageSingle(const Message &message,
+                                    uint8_t fragmentsSequence = 0,
+                                    uint8_t moreFragmentsFlag = 0) const;
+
+    std::vector<uint8_t>
+    packMaster2BackendMessageSingle(const Message &message,
+                                    uint8_t fragmentsSequence = 0,
+                                    uint8_t moreFragmentsFlag = 0) const;
+
+  private:
+    // 写入帧头、载荷前缀并将消息体直接序列化到buffer
+    size_t packFrameInto(uint8_t packetId, const uint8_t *prefix,
+                         size_t prefixLength, const Message &message,
+                         uint8_t *buffer, size_t capacity,
+                         uint8_t fragmentsSequence,
+                         uint8_t moreFragmentsFlag) const;
+
+    // 计算紧凑分片流的步长和分片数
+    // 分片偏移超出fragmentOffset字节范围（流长度约2KB以上）时返回false，调用方改用标准帧
+    static bool planCompactFragments(size_t streamLength, size_t maxPayloadSize,
+                                     size_t &stride, size_t &totalFragments);
+
+    // 写入帧头并开始累加CRC，返回累加值；启用CRC时设置CRC标志，长度字段计入帧尾
+    // 之后按写入顺序对载荷各段调用updateFrameCrc，最后finishFrame写入帧尾
+    static uint32_t beginFrame(uint8_t *buffer, uint8_t packetId,
+                               uint8_t fragmentsSequence,
+                               uint8_t moreFragmentsFlag, size_t payloadLength,
+                               bool crc);
+    static uint32_t updateFrameCrc(uint32_t state, const uint8_t *data,
+                                   size_t length, bool crc);
+
+    // 启用CRC时在frameLength处写入CRC-32，返回帧总长度
+    static size_t finishFrame(uint8_t *buffer, size_t frameLength,
+                              uint32_t state, bool crc);
+
+    // 复制紧凑分片流 [messageId + status + 导通数据] 中 [start, start + length) 的字节
+    static void copyCompactStream(const ConductionFragmentCursor &cursor,
+                                  size_t start, size_t length, uint8_t *out);
+
+    size_t crcTrailerSize() const {
+        return isCrcEnabled() ? FRAME_CRC_SIZE : 0;
+    }
+
+    // 已打包帧（含帧头）的帧尾CRC长度
+    static size_t frameTrailerSize(const std::vector<uint8_t> &frameData) {
+        return (frameData.size() > 4 && (frameData[4] & FRAME_FLAG_CRC32))
+                   ? FRAME_CRC_SIZE
+                   : 0;
+    }
+
+    // 写入7字节帧头
+    static void writeFrameHeader(uint8_t *buffer, uint8_t packetId,
+                                 uint8_t fragmentsSequence,
+                                 uint8_t moreFragmentsFlag,
+                                 uint16_t packetLength);
+
+    // 将单个完整帧移交为分片列表（不复制帧数据）
+    static std::vector<std::vector<uint8_t>>
+    wrapSingleFrame(std::vector<uint8_t> &&frameData);
+
+    // 帧分片
+    std::vector<std::vector<uint8_t>>
+    fragmentFrame(const std::vector<uint8_t> &frameData) const;
+
+    // 帧分片（带DeviceStatus，用于COND_DATA_MSG，确保每包都包含ID+DeviceStatus）
+    // reservedBytes为每个分片额外预留的字节数（校验帧的字段）
+    std::vector<std::vector<uint8_t>>
+    fragmentFrameWithStatus(const std::vector<uint8_t> &frameData,
+                            size_t reservedBytes = 0) const;
+
+    // 工具函数
+    static void writeUint16LE(uint8_t *buffer, uint16_t value);
+    static void writeUint32LE(uint8_t *buffer, uint32_t value);
+
+  private:
+    static constexpr size_t DEFAULT_MTU = 100; // 默认MTU大小
+    // 紧凑分片流头部: messageId(1) + status(2)
+    static constexpr size_t COMPACT_STREAM_HEADER_SIZE = 3;
+
+    size_t mtu_;                    // 最大传输单元大小，默认100字节
+    std::atomic<bool> crcEnabled_;  // 发送时是否附加CRC-32帧尾（接收任务可能修改）
+};
+
+} // namespace WhtsProtocol
+
+#endif // WHTS_PROTOCOL_ENCODER_H
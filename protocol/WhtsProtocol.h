@@ -3,8 +3,15 @@
 
 // 包含所有子模块
 #include "Common.h"
+#include "ConductionCodec.h"
 #include "DeviceStatus.h"
+#include "FragmentParity.h"
+#include "FragmentReassembler.h"
 #include "Frame.h"
+#include "LinkPlanner.h"
+#include "MessageStore.h"
+#include "ProtocolDecoder.h"
+#include "ProtocolEncoder.h"
 #include "ProtocolProcessor.h"
 
 // 消息模块
@@ -0,0 +1,129 @@
+/**
+ * @file conduction_codec_benchmark.cpp
+ * @brief 导通数据编码的压缩率与编码耗时评估
+ *
+ * 生成模拟线束的导通矩阵（每行只有少量导通点），以及只改变少数位的下一周期数据，
+ * 分别统计各编码方式的长度、ConductionCodec::encode 选出的编码和每周期编码耗时
+ *
+ * 主机编译运行：
+ *   g++ -std=c++17 -O2 -DCONDUCTION_CODEC_BENCHMARK_MAIN \
+ *       conduction_codec_benchmark.cpp ConductionCodec.cpp -o codec_benchmark
+ *   ./codec_benchmark
+ */
+
+#ifdef CONDUCTION_CODEC_BENCHMARK_MAIN
+
+#include "ConductionCodec.h"
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+using namespace WhtsProtocol;
+
+namespace {
+
+struct HarnessShape {
+    const char *name;
+    size_t rows;         // 本从机的导通检测引脚数
+    size_t columns;      // 系统总引脚数
+    size_t linksPerRow;  // 每行导通点数
+    size_t changedBits;  // 下一周期变化的位数
+};
+
+void setBit(std::vector<uint8_t> &data, size_t bit, bool value) {
+    uint8_t mask = static_cast<uint8_t>(0x80 >> (bit % 8));
+    if (value) {
+        data[bit / 8] |= mask;
+    } else {
+        data[bit / 8] &= static_cast<uint8_t>(~mask);
+    }
+}
+
+std::vector<uint8_t> makeMatrix(const HarnessShape &shape, std::mt19937 &rng) {
+    std::vector<uint8_t> data((shape.rows * shape.columns + 7) / 8, 0);
+    std::uniform_int_distribution<size_t> column(0, shape.columns - 1);
+    for (size_t row = 0; row < shape.rows; ++row) {
+        for (size_t i = 0; i < shape.linksPerRow; ++i) {
+            setBit(data, row * shape.columns + column(rng), true);
+        }
+    }
+    return data;
+}
+
+std::vector<uint8_t> makeNextCycle(const HarnessShape &shape,
+                                   const std::vector<uint8_t> &previous,
+                                   std::mt19937 &rng) {
+    std::vector<uint8_t> data = previous;
+    std::uniform_int_distribution<size_t> bit(0, shape.rows * shape.columns - 1);
+    for (size_t i = 0; i < shape.changedBits; ++i) {
+        size_t position = bit(rng);
+        setBit(data, position, !(data[position / 8] & (0x80 >> (position % 8))));
+    }
+    return data;
+}
+
+void runShape(const HarnessShape &shape) {
+    constexpr int ITERATIONS = 2000;
+    std::mt19937 rng(12345);
+    std::vector<uint8_t> previous = makeMatrix(shape, rng);
+    std::vector<uint8_t> current = makeNextCycle(shape, previous, rng);
+    std::vector<uint8_t> scratch;
+    std::vector<uint8_t> encoded;
+    std::vector<uint8_t> decoded;
+
+    // 关键帧（不参考上一周期）与差分帧
+    uint8_t keyEncoding = ConductionCodec::encode(
+        current.data(), current.size(), nullptr, scratch, encoded);
+    size_t keySize = encoded.size();
+    bool ok = ConductionCodec::decode(keyEncoding, encoded.data(),
+                                      encoded.size(), current.size(), nullptr,
+                                      decoded) &&
+              decoded == current;
+
+    uint8_t deltaEncoding = ConductionCodec::encode(
+        current.data(), current.size(), previous.data(), scratch, encoded);
+    size_t deltaSize = encoded.size();
+    ok = ok &&
+         ConductionCodec::decode(deltaEncoding, encoded.data(), encoded.size(),
+                                 current.size(), previous.data(), decoded) &&
+         decoded == current;
+
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < ITERATIONS; ++i) {
+        ConductionCodec::encode(current.data(), current.size(),
+                                previous.data(), scratch, encoded);
+    }
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    double usPerCycle =
+        std::chrono::duration<double, std::micro>(elapsed).count() /
+        ITERATIONS;
+
+    std::printf("%-10s %3zux%-4zu raw=%5zu sparse=%5zu rle=%5zu "
+                "key=%5zu(0x%02X, %5.1fx) delta=%5zu(0x%02X, %5.1fx) "
+                "encode=%7.2fus %s\n",
+                shape.name, shape.rows, shape.columns, current.size(),
+                ConductionCodec::sparseSize(current.data(), current.size()),
+                ConductionCodec::rleSize(current.data(), current.size()),
+                keySize, keyEncoding,
+                static_cast<double>(current.size()) / keySize, deltaSize,
+                deltaEncoding,
+                static_cast<double>(current.size()) / deltaSize, usPerCycle,
+                ok ? "ok" : "MISMATCH");
+}
+
+} // namespace
+
+int main() {
+    const HarnessShape shapes[] = {
+        {"small", 16, 64, 1, 2},
+        {"medium", 64, 256, 2, 4},
+        {"large", 128, 1024, 3, 8},
+        {"dense", 64, 256, 32, 64},
+    };
+    for (const auto &shape : shapes) {
+        runShape(shape);
+    }
+    return 0;
+}
+#endif // CONDUCTION_CODEC_BENCHMARK_MAIN
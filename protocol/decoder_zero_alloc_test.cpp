@@ -0,0 +1,179 @@
+/**
+ * @file decoder_zero_alloc_test.cpp
+ * @brief 从机接收路径（ProtocolDecoder + MessageStore）稳态零堆分配的主机测试
+ *
+ * 用计数的全局operator new替换默认实现，将SyncMessage和CompactSyncMessage
+ * 打包成单帧和分片帧，按从机接收循环反复执行 processReceivedData ->
+ * getNextCompleteFrame -> 就地解析；预热若干轮（各buffer和消息对象达到所需容量）后，
+ * 检查之后的所有轮次中没有任何堆分配，且每轮解析出的消息内容正确
+ *
+ * 主机编译运行（在本目录）：
+ *   g++ -std=c++17 -O2 -DDECODER_ZERO_ALLOC_TEST_MAIN -I. -Imessages -Iutils \
+ *       -I../easylogger/inc decoder_zero_alloc_test.cpp ConductionCodec.cpp \
+ *       DeviceStatus.cpp FragmentParity.cpp FragmentReassembler.cpp Frame.cpp \
+ *       LinkPlanner.cpp MessageStore.cpp ProtocolDecoder.cpp ProtocolEncoder.cpp \
+ *       ProtocolProcessor.cpp messages/Backend2Master.cpp \
+ *       messages/Master2Backend.cpp messages/Master2Slave.cpp \
+ *       messages/Slave2Master.cpp utils/ByteUtils.cpp utils/Crc32.cpp \
+ *       -o decoder_zero_alloc_test
+ *   ./decoder_zero_alloc_test
+ */
+
+#ifdef DECODER_ZERO_ALLOC_TEST_MAIN
+
+#include "ProtocolProcessor.h"
+#include "elog.h"
+#include "messages/Master2Slave.h"
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <vector>
+
+// 计数的全局分配函数，统计测试期间的所有堆分配
+static unsigned long g_allocations = 0;
+
+void *operator new(size_t size) {
+    g_allocations++;
+    void *p = std::malloc(size == 0 ? 1 : size);
+    if (p == nullptr) {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+
+void operator delete(void *p) noexcept { std::free(p); }
+void operator delete(void *p, size_t) noexcept { std::free(p); }
+
+// 主机上不接日志后端
+extern "C" void elog_output(uint8_t, const char *, const char *, const char *,
+                            const long, const char *, ...) {}
+
+using namespace WhtsProtocol;
+
+namespace {
+
+// 完整帧队列的8个槽位和调用方的载荷vector轮流交换，每个都要扩容一次，预热需覆盖一整轮
+constexpr int WARMUP_ROUNDS = 16;
+constexpr int MEASURED_ROUNDS = 200;
+constexpr size_t MTU = 120; // 配置多的同步消息需要分片
+
+int g_failures = 0;
+
+void report(const char *name, bool ok) {
+    std::printf("%-52s %s\n", name, ok ? "ok" : "MISMATCH");
+    if (!ok) {
+        g_failures++;
+    }
+}
+
+Master2Slave::SyncMessage makeSync(size_t slaves) {
+    Master2Slave::SyncMessage sync;
+    sync.mode = 0x20;
+    sync.interval = 10;
+    sync.currentTime = 0x0102030405060708ULL;
+    sync.startTime = 0x1112131415161718ULL;
+    for (size_t i = 0; i < slaves; ++i) {
+        sync.slaveConfigs.push_back({0x10000000u + static_cast<uint32_t>(i),
+                                     static_cast<uint8_t>(i), 0, 8});
+    }
+    return sync;
+}
+
+Master2Slave::CompactSyncMessage makeCompactSync(size_t slaves) {
+    Master2Slave::CompactSyncMessage sync;
+    sync.mode = 0x10;
+    sync.interval = 5;
+    sync.currentTime = 0x2122232425262728ULL;
+    sync.startTime = 0x3132333435363738ULL;
+    sync.epoch = 7;
+    sync.baseEpoch = 7;
+    sync.totalSlots = static_cast<uint16_t>(slaves * 8);
+    sync.firstShortId = 1;
+    for (size_t i = 0; i < slaves; ++i) {
+        sync.appendEntry({static_cast<uint8_t>(i), 0, 8,
+                          static_cast<uint16_t>(i * 8)});
+    }
+    return sync;
+}
+
+bool matches(const Message *message, const Master2Slave::SyncMessage &sync) {
+    const auto *parsed = dynamic_cast<const Master2Slave::SyncMessage *>(message);
+    if (parsed == nullptr || parsed->mode != sync.mode ||
+        parsed->currentTime != sync.currentTime ||
+        parsed->slaveConfigs.size() != sync.slaveConfigs.size()) {
+        return false;
+    }
+    for (size_t i = 0; i < sync.slaveConfigs.size(); ++i) {
+        if (parsed->slaveConfigs[i].slaveId != sync.slaveConfigs[i].slaveId ||
+            parsed->slaveConfigs[i].timeSlot != sync.slaveConfigs[i].timeSlot) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool matches(const Message *message,
+             const Master2Slave::CompactSyncMessage &sync) {
+    const auto *parsed =
+        dynamic_cast<const Master2Slave::CompactSyncMessage *>(message);
+    return parsed != nullptr && parsed->epoch == sync.epoch &&
+           parsed->currentTime == sync.currentTime &&
+           parsed->entries == sync.entries;
+}
+
+// 按从机接收循环反复处理同一组帧，检查解析结果和预热之后的堆分配次数
+template <typename SyncType>
+void run(const char *name, const SyncType &sync, size_t expectedFrames) {
+    ProtocolProcessor master;
+    master.SetMTU(MTU);
+    const auto frames = master.packMaster2SlaveMessage(BROADCAST_ID, sync);
+
+    ProtocolProcessor slave;
+    Frame received;
+    bool allParsed = true;
+    unsigned long before = 0;
+    for (int round = 0; round < WARMUP_ROUNDS + MEASURED_ROUNDS; ++round) {
+        if (round == WARMUP_ROUNDS) {
+            before = g_allocations;
+        }
+        for (const auto &frame : frames) {
+            slave.processReceivedData(frame.data(), frame.size());
+        }
+
+        size_t parsedCount = 0;
+        while (slave.getNextCompleteFrame(received)) {
+            uint32_t destinationId = 0;
+            Message *message = nullptr;
+            if (slave.parseMaster2SlavePacket(received.payload, destinationId,
+                                              message) &&
+                matches(message, sync)) {
+                parsedCount++;
+            }
+        }
+        allParsed = allParsed && parsedCount == 1;
+    }
+    const unsigned long allocations = g_allocations - before;
+
+    char label[64];
+    std::snprintf(label, sizeof(label), "%s frames=%zu", name, frames.size());
+    report(label, frames.size() == expectedFrames && allParsed);
+    std::snprintf(label, sizeof(label), "%s allocations=%lu", name,
+                  allocations);
+    report(label, allocations == 0);
+}
+
+} // namespace
+
+int main() {
+    // 单帧：只经过接收环形缓冲区和完整帧队列
+    run("sync single", makeSync(4), 1);
+    run("compact sync single", makeCompactSync(8), 1);
+
+    // 分片：经过重组表，完成时从重组表内存写入完整帧队列
+    run("sync fragmented", makeSync(40), 3);
+    run("compact sync fragmented", makeCompactSync(60), 3);
+
+    std::printf("%s\n", g_failures == 0 ? "all ok" : "FAILED");
+    return g_failures == 0 ? 0 : 1;
+}
+#endif // DECODER_ZERO_ALLOC_TEST_MAIN
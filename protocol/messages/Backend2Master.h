@@ -3,12 +3,12 @@
 
 #include "../Common.h"
 #include "../utils/ByteUtils.h"
-#include "Message.h"
+#include "MessageSchema.h"
 
 namespace WhtsProtocol {
 namespace Backend2Master {
 
-class SlaveConfigMessage : public Message {
+class SlaveConfigMessage : public SchemaMessage<SlaveConfigMessage> {
    public:
     struct SlaveInfo {
         uint32_t id;
@@ -16,13 +16,19 @@ class SlaveConfigMessage : public Message {
         uint8_t resistanceNum;
         uint8_t clipMode;
         uint16_t clipStatus;
+
+        using Schema = MessageSchema<Field<&SlaveInfo::id>, Field<&SlaveInfo::conductionNum>,
+                                     Field<&SlaveInfo::resistanceNum>, Field<&SlaveInfo::clipMode>,
+                                     Field<&SlaveInfo::clipStatus>>;
     };
 
     uint8_t slaveNum;
     std::vector<SlaveInfo> slaves;
 
-    std::vector<uint8_t> serialize() const override;
-    bool deserialize(const std::vector<uint8_t> &data) override;
+    using Schema = MessageSchema<Field<&SlaveConfigMessage::slaveNum>,
+                                 CountedField<&SlaveConfigMessage::slaveNum, &SlaveConfigMessage::slaves,
+                                              SlaveInfo::Schema>>;
+
     uint8_t getMessageId() const override {
         return static_cast<uint8_t>(Backend2MasterMessageId::SLAVE_CFG_MSG);
     }
@@ -31,12 +37,12 @@ class SlaveConfigMessage : public Message {
     }
 };
 
-class ModeConfigMessage : public Message {
+class ModeConfigMessage : public SchemaMessage<ModeConfigMessage> {
    public:
     uint8_t mode;
 
-    std::vector<uint8_t> serialize() const override;
-    bool deserialize(const std::vector<uint8_t> &data) override;
+    using Schema = MessageSchema<Field<&ModeConfigMessage::mode>>;
+
     uint8_t getMessageId() const override {
         return static_cast<uint8_t>(Backend2MasterMessageId::MODE_CFG_MSG);
     }
@@ -45,19 +51,23 @@ class ModeConfigMessage : public Message {
     }
 };
 
-class RstMessage : public Message {
+class RstMessage : public SchemaMessage<RstMessage> {
    public:
     struct SlaveRstInfo {
         uint32_t id;
         uint8_t lock;
         uint16_t clipStatus;
+
+        using Schema =
+            MessageSchema<Field<&SlaveRstInfo::id>, Field<&SlaveRstInfo::lock>, Field<&SlaveRstInfo::clipStatus>>;
     };
 
     uint8_t slaveNum;
     std::vector<SlaveRstInfo> slaves;
 
-    std::vector<uint8_t> serialize() const override;
-    bool deserialize(const std::vector<uint8_t> &data) override;
+    using Schema = MessageSchema<Field<&RstMessage::slaveNum>,
+                                 CountedField<&RstMessage::slaveNum, &RstMessage::slaves, SlaveRstInfo::Schema>>;
+
     uint8_t getMessageId() const override {
         return static_cast<uint8_t>(Backend2MasterMessageId::SLAVE_RST_MSG);
     }
@@ -66,12 +76,12 @@ class RstMessage : public Message {
     }
 };
 
-class CtrlMessage : public Message {
+class CtrlMessage : public SchemaMessage<CtrlMessage> {
    public:
     uint8_t runningStatus;
 
-    std::vector<uint8_t> serialize() const override;
-    bool deserialize(const std::vector<uint8_t> &data) override;
+    using Schema = MessageSchema<Field<&CtrlMessage::runningStatus>>;
+
     uint8_t getMessageId() const override {
         return static_cast<uint8_t>(Backend2MasterMessageId::CTRL_MSG);
     }
@@ -80,15 +90,16 @@ class CtrlMessage : public Message {
     }
 };
 
-class PingCtrlMessage : public Message {
+class PingCtrlMessage : public SchemaMessage<PingCtrlMessage> {
    public:
     uint8_t pingMode;
     uint16_t pingCount;
     uint16_t interval;
     uint32_t destinationId;
 
-    std::vector<uint8_t> serialize() const override;
-    bool deserialize(const std::vector<uint8_t> &data) override;
+    using Schema = MessageSchema<Field<&PingCtrlMessage::pingMode>, Field<&PingCtrlMessage::pingCount>,
+                                 Field<&PingCtrlMessage::interval>, Field<&PingCtrlMessage::destinationId>>;
+
     uint8_t getMessageId() const override {
         return static_cast<uint8_t>(Backend2MasterMessageId::PING_CTRL_MSG);
     }
@@ -97,12 +108,12 @@ class PingCtrlMessage : public Message {
     }
 };
 
-class IntervalConfigMessage : public Message {
+class IntervalConfigMessage : public SchemaMessage<IntervalConfigMessage> {
    public:
     uint8_t intervalMs;
 
-    std::vector<uint8_t> serialize() const override;
-    bool deserialize(const std::vector<uint8_t> &data) override;
+    using Schema = MessageSchema<Field<&IntervalConfigMessage::intervalMs>>;
+
     uint8_t getMessageId() const override {
         return static_cast<uint8_t>(Backend2MasterMessageId::INTERVAL_CFG_MSG);
     }
@@ -111,12 +122,12 @@ class IntervalConfigMessage : public Message {
     }
 };
 
-class DeviceListReqMessage : public Message {
+class DeviceListReqMessage : public SchemaMessage<DeviceListReqMessage> {
    public:
     uint8_t reserve;
 
-    std::vector<uint8_t> serialize() const override;
-    bool deserialize(const std::vector<uint8_t> &data) override;
+    using Schema = MessageSchema<Field<&DeviceListReqMessage::reserve>>;
+
     uint8_t getMessageId() const override {
         return static_cast<uint8_t>(
             Backend2MasterMessageId::DEVICE_LIST_REQ_MSG);
@@ -1,218 +1,28 @@
 #include "Master2Backend.h"
+#include "Backend2Master.h"
 
 namespace WhtsProtocol {
 namespace Master2Backend {
 
-// SlaveConfigResponseMessage 实现
-std::vector<uint8_t> SlaveConfigResponseMessage::serialize() const {
-    auto& result = getReusableVector();
-    result.push_back(status);
-    result.push_back(slaveNum);
-
-    for (const auto &slave : slaves) {
-        // Write slave ID (4 bytes, little endian)
-        ByteUtils::writeUint32LE(result, slave.id);
-        result.push_back(slave.conductionNum);
-        result.push_back(slave.resistanceNum);
-        result.push_back(slave.clipMode);
-        // Write clip status (2 bytes, little endian)
-        ByteUtils::writeUint16LE(result, slave.clipStatus);
-    }
-
-    return result; // 返回副本，可复用的 vector 会在下次调用时被清空
-}
-
-bool SlaveConfigResponseMessage::deserialize(const std::vector<uint8_t> &data) {
-    if (data.size() < 2)
-        return false;
-
-    status = data[0];
-    slaveNum = data[1];
-    slaves.clear();
-
-    size_t offset = 2;
-    for (uint8_t i = 0; i < slaveNum; ++i) {
-        if (offset + 9 > data.size())
-            return false; // Each slave info is 9 bytes
-
-        SlaveInfo slave;
-        slave.id = ByteUtils::readUint32LE(data, offset);
-        slave.conductionNum = data[offset + 4];
-        slave.resistanceNum = data[offset + 5];
-        slave.clipMode = data[offset + 6];
-        slave.clipStatus = ByteUtils::readUint16LE(data, offset + 7);
-
-        slaves.push_back(slave);
-        offset += 9;
-    }
-
-    return true;
-}
-
-// ModeConfigResponseMessage 实现
-std::vector<uint8_t> ModeConfigResponseMessage::serialize() const {
-    auto& result = getReusableVector();
-    result.push_back(status);
-    result.push_back(mode);
-    return result; // 返回副本，可复用的 vector 会在下次调用时被清空
-}
-
-bool ModeConfigResponseMessage::deserialize(const std::vector<uint8_t> &data) {
-    if (data.size() < 2)
-        return false;
-    status = data[0];
-    mode = data[1];
-    return true;
-}
-
-// RstResponseMessage 实现
-std::vector<uint8_t> RstResponseMessage::serialize() const {
-    auto& result = getReusableVector();
-    result.push_back(status);
-    result.push_back(slaveNum);
-
-    for (const auto &slave : slaves) {
-        // Write slave ID (4 bytes, little endian)
-        ByteUtils::writeUint32LE(result, slave.id);
-        result.push_back(slave.lock);
-        // Write clip status (2 bytes, little endian)
-        ByteUtils::writeUint16LE(result, slave.clipStatus);
-    }
-
-    return result; // 返回副本，可复用的 vector 会在下次调用时被清空
-}
-
-bool RstResponseMessage::deserialize(const std::vector<uint8_t> &data) {
-    if (data.size() < 2)
-        return false;
-
-    status = data[0];
-    slaveNum = data[1];
-    slaves.clear();
-
-    size_t offset = 2;
-    for (uint8_t i = 0; i < slaveNum; ++i) {
-        if (offset + 7 > data.size())
-            return false; // Each slave rst info is 7 bytes
-
-        SlaveRstInfo slave;
-        slave.id = ByteUtils::readUint32LE(data, offset);
-        slave.lock = data[offset + 4];
-        slave.clipStatus = ByteUtils::readUint16LE(data, offset + 5);
-
-        slaves.push_back(slave);
-        offset += 7;
-    }
-
-    return true;
-}
-
-// CtrlResponseMessage 实现
-std::vector<uint8_t> CtrlResponseMessage::serialize() const {
-    auto& result = getReusableVector();
-    result.push_back(status);
-    result.push_back(runningStatus);
-    return result; // 返回副本，可复用的 vector 会在下次调用时被清空
-}
-
-bool CtrlResponseMessage::deserialize(const std::vector<uint8_t> &data) {
-    if (data.size() < 2)
-        return false;
-    status = data[0];
-    runningStatus = data[1];
-    return true;
-}
-
-// PingResponseMessage 实现
-std::vector<uint8_t> PingResponseMessage::serialize() const {
-    auto& result = getReusableVector();
-    result.push_back(pingMode);
-
-    // Write total count (2 bytes, little endian)
-    ByteUtils::writeUint16LE(result, totalCount);
-
-    // Write success count (2 bytes, little endian)
-    ByteUtils::writeUint16LE(result, successCount);
-
-    // Write destination ID (4 bytes, little endian)
-    ByteUtils::writeUint32LE(result, destinationId);
-
-    return result; // 返回副本，可复用的 vector 会在下次调用时被清空
-}
-
-bool PingResponseMessage::deserialize(const std::vector<uint8_t> &data) {
-    if (data.size() < 9)
-        return false;
-
-    pingMode = data[0];
-    totalCount = ByteUtils::readUint16LE(data, 1);
-    successCount = ByteUtils::readUint16LE(data, 3);
-    destinationId = ByteUtils::readUint32LE(data, 5);
-
-    return true;
-}
-
-// IntervalConfigResponseMessage 实现
-std::vector<uint8_t> IntervalConfigResponseMessage::serialize() const {
-    auto& result = getReusableVector();
-    result.push_back(status);
-    result.push_back(intervalMs);
-    return result; // 返回副本，可复用的 vector 会在下次调用时被清空
-}
-
-bool IntervalConfigResponseMessage::deserialize(const std::vector<uint8_t> &data) {
-    if (data.size() < 2)
-        return false;
-    status = data[0];
-    intervalMs = data[1];
-    return true;
-}
-
-// DeviceListResponseMessage 实现
-std::vector<uint8_t> DeviceListResponseMessage::serialize() const {
-    auto& result = getReusableVector();
-    result.push_back(deviceCount);
-
-    for (const auto &device : devices) {
-        // Write device ID (4 bytes, little endian)
-        ByteUtils::writeUint32LE(result, device.deviceId);
-        result.push_back(device.shortId);
-        result.push_back(device.online);
-        result.push_back(device.versionMajor);
-        result.push_back(device.versionMinor);
-        // Write version patch (2 bytes, little endian)
-        ByteUtils::writeUint16LE(result, device.versionPatch);
-    }
-
-    return result; // 返回副本，可复用的 vector 会在下次调用时被清空
-}
-
-bool DeviceListResponseMessage::deserialize(const std::vector<uint8_t> &data) {
-    if (data.size() < 1)
-        return false;
-
-    deviceCount = data[0];
-    devices.clear();
-
-    size_t offset = 1;
-    for (uint8_t i = 0; i < deviceCount; ++i) {
-        if (offset + 10 > data.size())
-            return false; // Each device info is 10 bytes
-
-        DeviceInfo device;
-        device.deviceId = ByteUtils::readUint32LE(data, offset);
-        device.shortId = data[offset + 4];
-        device.online = data[offset + 5];
-        device.versionMajor = data[offset + 6];
-        device.versionMinor = data[offset + 7];
-        device.versionPatch = ByteUtils::readUint16LE(data, offset + 8);
-
-        devices.push_back(device);
-        offset += 10;
-    }
-
-    return true;
-}
+// 编解码由各消息的Schema生成，这里固定线上格式，字段变更时编译报错
+static_assert(SlaveConfigResponseMessage::SlaveInfo::Schema::FIXED_SIZE ==
+                  Backend2Master::SlaveConfigMessage::SlaveInfo::Schema::FIXED_SIZE,
+              "SlaveInfo must match the Backend2Master layout");
+static_assert(SlaveConfigResponseMessage::Schema::FIXED_SIZE == 2, "SlaveConfigResponse: status(1) + slaveNum(1)");
+static_assert(ModeConfigResponseMessage::Schema::FIXED_SIZE == 2, "ModeConfigResponse: status(1) + mode(1)");
+static_assert(RstResponseMessage::SlaveRstInfo::Schema::FIXED_SIZE ==
+                  Backend2Master::RstMessage::SlaveRstInfo::Schema::FIXED_SIZE,
+              "SlaveRstInfo must match the Backend2Master layout");
+static_assert(RstResponseMessage::Schema::FIXED_SIZE == 2, "RstResponse: status(1) + slaveNum(1)");
+static_assert(CtrlResponseMessage::Schema::FIXED_SIZE == 2, "CtrlResponse: status(1) + runningStatus(1)");
+static_assert(PingResponseMessage::Schema::FIXED_SIZE == 9,
+              "PingResponse: pingMode(1) + totalCount(2) + successCount(2) + destinationId(4)");
+static_assert(IntervalConfigResponseMessage::Schema::FIXED_SIZE == 2,
+              "IntervalConfigResponse: status(1) + intervalMs(1)");
+static_assert(DeviceListResponseMessage::DeviceInfo::Schema::FIXED_SIZE == 10,
+              "DeviceInfo: deviceId(4) + shortId(1) + online(1) + versionMajor(1) + versionMinor(1) + "
+              "versionPatch(2)");
+static_assert(DeviceListResponseMessage::Schema::FIXED_SIZE == 1, "DeviceListResponse: deviceCount(1) + devices");
 
 } // namespace Master2Backend
-} // namespace WhtsProtocol
\ No newline at end of file
+} // namespace WhtsProtocol
@@ -3,12 +3,12 @@
 
 #include "../Common.h"
 #include "../utils/ByteUtils.h"
-#include "Message.h"
+#include "MessageSchema.h"
 
 namespace WhtsProtocol {
 namespace Master2Backend {
 
-class SlaveConfigResponseMessage : public Message {
+class SlaveConfigResponseMessage : public SchemaMessage<SlaveConfigResponseMessage> {
   public:
     struct SlaveInfo {
         uint32_t id;
@@ -16,14 +16,21 @@ class SlaveConfigResponseMessage : public Message {
         uint8_t resistanceNum;
         uint8_t clipMode;
         uint16_t clipStatus;
+
+        using Schema = MessageSchema<Field<&SlaveInfo::id>, Field<&SlaveInfo::conductionNum>,
+                                     Field<&SlaveInfo::resistanceNum>, Field<&SlaveInfo::clipMode>,
+                                     Field<&SlaveInfo::clipStatus>>;
     };
 
     uint8_t status;
     uint8_t slaveNum;
     std::vector<SlaveInfo> slaves;
 
-    std::vector<uint8_t> serialize() const override;
-    bool deserialize(const std::vector<uint8_t> &data) override;
+    using Schema = MessageSchema<Field<&SlaveConfigResponseMessage::status>,
+                                 Field<&SlaveConfigResponseMessage::slaveNum>,
+                                 CountedField<&SlaveConfigResponseMessage::slaveNum,
+                                              &SlaveConfigResponseMessage::slaves, SlaveInfo::Schema>>;
+
     uint8_t getMessageId() const override {
         return static_cast<uint8_t>(Master2BackendMessageId::SLAVE_CFG_RSP_MSG);
     }
@@ -32,13 +39,13 @@ class SlaveConfigResponseMessage : public Message {
     }
 };
 
-class ModeConfigResponseMessage : public Message {
+class ModeConfigResponseMessage : public SchemaMessage<ModeConfigResponseMessage> {
   public:
     uint8_t status;
     uint8_t mode;
 
-    std::vector<uint8_t> serialize() const override;
-    bool deserialize(const std::vector<uint8_t> &data) override;
+    using Schema = MessageSchema<Field<&ModeConfigResponseMessage::status>, Field<&ModeConfigResponseMessage::mode>>;
+
     uint8_t getMessageId() const override {
         return static_cast<uint8_t>(Master2BackendMessageId::MODE_CFG_RSP_MSG);
     }
@@ -47,20 +54,25 @@ class ModeConfigResponseMessage : public Message {
     }
 };
 
-class RstResponseMessage : public Message {
+class RstResponseMessage : public SchemaMessage<RstResponseMessage> {
   public:
     struct SlaveRstInfo {
         uint32_t id;
         uint8_t lock;
         uint16_t clipStatus;
+
+        using Schema =
+            MessageSchema<Field<&SlaveRstInfo::id>, Field<&SlaveRstInfo::lock>, Field<&SlaveRstInfo::clipStatus>>;
     };
 
     uint8_t status;
     uint8_t slaveNum;
     std::vector<SlaveRstInfo> slaves;
 
-    std::vector<uint8_t> serialize() const override;
-    bool deserialize(const std::vector<uint8_t> &data) override;
+    using Schema = MessageSchema<Field<&RstResponseMessage::status>, Field<&RstResponseMessage::slaveNum>,
+                                 CountedField<&RstResponseMessage::slaveNum, &RstResponseMessage::slaves,
+                                              SlaveRstInfo::Schema>>;
+
     uint8_t getMessageId() const override {
         return static_cast<uint8_t>(Master2BackendMessageId::RST_RSP_MSG);
     }
@@ -69,13 +81,14 @@ class RstResponseMessage : public Message {
     }
 };
 
-class CtrlResponseMessage : public Message {
+class CtrlResponseMessage : public SchemaMessage<CtrlResponseMessage> {
   public:
     uint8_t status;
     uint8_t runningStatus;
 
-    std::vector<uint8_t> serialize() const override;
-    bool deserialize(const std::vector<uint8_t> &data) override;
+    using Schema =
+        MessageSchema<Field<&CtrlResponseMessage::status>, Field<&CtrlResponseMessage::runningStatus>>;
+
     uint8_t getMessageId() const override {
         return static_cast<uint8_t>(Master2BackendMessageId::CTRL_RSP_MSG);
     }
@@ -84,15 +97,17 @@ class CtrlResponseMessage : public Message {
     }
 };
 
-class PingResponseMessage : public Message {
+class PingResponseMessage : public SchemaMessage<PingResponseMessage> {
   public:
     uint8_t pingMode;
     uint16_t totalCount;
     uint16_t successCount;
     uint32_t destinationId;
 
-    std::vector<uint8_t> serialize() const override;
-    bool deserialize(const std::vector<uint8_t> &data) override;
+    using Schema = MessageSchema<Field<&PingResponseMessage::pingMode>, Field<&PingResponseMessage::totalCount>,
+                                 Field<&PingResponseMessage::successCount>,
+                                 Field<&PingResponseMessage::destinationId>>;
+
     uint8_t getMessageId() const override {
         return static_cast<uint8_t>(Master2BackendMessageId::PING_RES_MSG);
     }
@@ -101,13 +116,14 @@ class PingResponseMessage : public Message {
     }
 };
 
-class IntervalConfigResponseMessage : public Message {
+class IntervalConfigResponseMessage : public SchemaMessage<IntervalConfigResponseMessage> {
   public:
     uint8_t status;
     uint8_t intervalMs;
 
-    std::vector<uint8_t> serialize() const override;
-    bool deserialize(const std::vector<uint8_t> &data) override;
+    using Schema = MessageSchema<Field<&IntervalConfigResponseMessage::status>,
+                                 Field<&IntervalConfigResponseMessage::intervalMs>>;
+
     uint8_t getMessageId() const override {
         return static_cast<uint8_t>(Master2BackendMessageId::INTERVAL_CFG_RSP_MSG);
     }
@@ -116,7 +132,7 @@ class IntervalConfigResponseMessage : public Message {
     }
 };
 
-class DeviceListResponseMessage : public Message {
+class DeviceListResponseMessage : public SchemaMessage<DeviceListResponseMessage> {
   public:
     struct DeviceInfo {
         uint32_t deviceId;
@@ -125,13 +141,19 @@ class DeviceListResponseMessage : public Message {
         uint8_t versionMajor;
         uint8_t versionMinor;
         uint16_t versionPatch;
+
+        using Schema = MessageSchema<Field<&DeviceInfo::deviceId>, Field<&DeviceInfo::shortId>,
+                                     Field<&DeviceInfo::online>, Field<&DeviceInfo::versionMajor>,
+                                     Field<&DeviceInfo::versionMinor>, Field<&DeviceInfo::versionPatch>>;
     };
 
     uint8_t deviceCount;
     std::vector<DeviceInfo> devices;
 
-    std::vector<uint8_t> serialize() const override;
-    bool deserialize(const std::vector<uint8_t> &data) override;
+    using Schema = MessageSchema<Field<&DeviceListResponseMessage::deviceCount>,
+                                 CountedField<&DeviceListResponseMessage::deviceCount,
+                                              &DeviceListResponseMessage::devices, DeviceInfo::Schema>>;
+
     uint8_t getMessageId() const override {
         return static_cast<uint8_t>(
             Master2BackendMessageId::DEVICE_LIST_RSP_MSG);
@@ -3,154 +3,42 @@
 namespace WhtsProtocol {
 namespace Master2Slave {
 
-// SyncMessage 实现
-std::vector<uint8_t> SyncMessage::serialize() const {
-    auto& result = getReusableVector();
-    
-    // 序列化模式（1字节）
-    result.push_back(mode);
-    
-    // 序列化间隔（1字节）
-    result.push_back(interval);
-    
-    // 序列化当前时间戳（8字节，小端序）
-    result.push_back(currentTime & 0xFF);
-    result.push_back((currentTime >> 8) & 0xFF);
-    result.push_back((currentTime >> 16) & 0xFF);
-    result.push_back((currentTime >> 24) & 0xFF);
-    result.push_back((currentTime >> 32) & 0xFF);
-    result.push_back((currentTime >> 40) & 0xFF);
-    result.push_back((currentTime >> 48) & 0xFF);
-    result.push_back((currentTime >> 56) & 0xFF);
-    
-    // 序列化启动时间戳（8字节，小端序）
-    result.push_back(startTime & 0xFF);
-    result.push_back((startTime >> 8) & 0xFF);
-    result.push_back((startTime >> 16) & 0xFF);
-    result.push_back((startTime >> 24) & 0xFF);
-    result.push_back((startTime >> 32) & 0xFF);
-    result.push_back((startTime >> 40) & 0xFF);
-    result.push_back((startTime >> 48) & 0xFF);
-    result.push_back((startTime >> 56) & 0xFF);
-    
-    // 序列化从机配置
-    for (const auto& config : slaveConfigs) {
-        // 从机ID（4字节，小端序）
-        result.push_back(config.slaveId & 0xFF);
-        result.push_back((config.slaveId >> 8) & 0xFF);
-        result.push_back((config.slaveId >> 16) & 0xFF);
-        result.push_back((config.slaveId >> 24) & 0xFF);
-        
-        // 时隙（1字节）
-        result.push_back(config.timeSlot);
-        
-        // 复位标志（1字节）
-        result.push_back(config.reset);
-        
-        // 检测数量（1字节）
-        result.push_back(config.testCount);
-    }
-    
-    return result; // 返回副本，可复用的 vector 会在下次调用时被清空
-}
-
-bool SyncMessage::deserialize(const std::vector<uint8_t> &data) {
-    if (data.size() < 18) return false; // 最小长度：1+1+8+8=18字节
-    
-    size_t offset = 0;
-    
-    // 反序列化模式
-    mode = data[offset++];
-    
-    // 反序列化间隔
-    interval = data[offset++];
-    
-    // 反序列化当前时间戳（8字节，小端序）
-    currentTime = static_cast<uint64_t>(data[offset]) |
-                  (static_cast<uint64_t>(data[offset + 1]) << 8) |
-                  (static_cast<uint64_t>(data[offset + 2]) << 16) |
-                  (static_cast<uint64_t>(data[offset + 3]) << 24) |
-                  (static_cast<uint64_t>(data[offset + 4]) << 32) |
-                  (static_cast<uint64_t>(data[offset + 5]) << 40) |
-                  (static_cast<uint64_t>(data[offset + 6]) << 48) |
-                  (static_cast<uint64_t>(data[offset + 7]) << 56);
-    offset += 8;
-    
-    // 反序列化启动时间戳（8字节，小端序）
-    startTime = static_cast<uint64_t>(data[offset]) |
-                (static_cast<uint64_t>(data[offset + 1]) << 8) |
-                (static_cast<uint64_t>(data[offset + 2]) << 16) |
-                (static_cast<uint64_t>(data[offset + 3]) << 24) |
-                (static_cast<uint64_t>(data[offset + 4]) << 32) |
-                (static_cast<uint64_t>(data[offset + 5]) << 40) |
-                (static_cast<uint64_t>(data[offset + 6]) << 48) |
-                (static_cast<uint64_t>(data[offset + 7]) << 56);
-    offset += 8;
-    
-    // 反序列化从机配置（每个从机配置7字节：4字节ID + 1字节时隙 + 1字节复位标志 + 1字节检测数量）
-    slaveConfigs.clear();
-    while (offset + 7 <= data.size()) {
-        SlaveConfig config;
-        
-        // 从机ID（4字节，小端序）
-        config.slaveId = static_cast<uint32_t>(data[offset]) |
-                         (static_cast<uint32_t>(data[offset + 1]) << 8) |
-                         (static_cast<uint32_t>(data[offset + 2]) << 16) |
-                         (static_cast<uint32_t>(data[offset + 3]) << 24);
-        offset += 4;
-        
-        // 时隙
-        config.timeSlot = data[offset++];
-        
-        // 复位标志
-        config.reset = data[offset++];
-        
-        // 检测数量
-        config.testCount = data[offset++];
-        
-        slaveConfigs.push_back(config);
-    }
-    
-    return true;
-}
-
-
-
-
-
-
-// PingReqMessage 实现
-std::vector<uint8_t> PingReqMessage::serialize() const {
-    auto& result = getReusableVector();
-    result.push_back(sequenceNumber & 0xFF);
-    result.push_back((sequenceNumber >> 8) & 0xFF);
-    result.push_back(timestamp & 0xFF);
-    result.push_back((timestamp >> 8) & 0xFF);
-    result.push_back((timestamp >> 16) & 0xFF);
-    result.push_back((timestamp >> 24) & 0xFF);
-    return result; // 返回副本，可复用的 vector 会在下次调用时被清空
-}
-
-bool PingReqMessage::deserialize(const std::vector<uint8_t> &data) {
-    if (data.size() < 6) return false;
-    sequenceNumber = data[0] | (data[1] << 8);
-    timestamp = data[2] | (data[3] << 8) | (data[4] << 16) | (data[5] << 24);
+// 编解码由各消息的Schema生成，这里固定线上格式，字段变更时编译报错
+static_assert(SlaveConfig::Schema::FIXED_SIZE == 7,
+              "SlaveConfig: slaveId(4) + timeSlot(1) + reset(1) + testCount(1)");
+static_assert(SyncMessage::Schema::FIXED_SIZE == 18,
+              "Sync: mode(1) + interval(1) + currentTime(8) + startTime(8)");
+static_assert(CompactSlaveEntry::Schema::FIXED_SIZE ==
+                  CompactSyncMessage::ENTRY_SIZE,
+              "CompactSlaveEntry: timeSlot(1) + reset(1) + testCount(1) + "
+              "startSlot(2)");
+static_assert(CompactSyncMessage::Schema::FIXED_SIZE == 25,
+              "CompactSync: mode(1) + interval(1) + currentTime(8) + "
+              "startTime(8) + epoch(2) + baseEpoch(2) + totalSlots(2) + "
+              "firstShortId(1)");
+static_assert(PingReqMessage::Schema::FIXED_SIZE == 6,
+              "PingReq: sequenceNumber(2) + timestamp(4), optional echoSequence(2) + echoTimestamp(4)");
+static_assert(ShortIdAssignMessage::Schema::FIXED_SIZE == 1,
+              "ShortIdAssign: shortId(1)");
+static_assert(FragmentNackMessage::Schema::FIXED_SIZE == 6,
+              "FragmentNack: cycle(1) + fragmentCount(1) + missingBitmap(4)");
+static_assert(SettleCalibrateMessage::Schema::FIXED_SIZE == 1,
+              "SettleCalibrate: reserve(1)");
+
+bool CompactSyncMessage::getEntry(uint8_t shortId,
+                                  CompactSlaveEntry &entry) const {
+    if (shortId < firstShortId) return false;
+    size_t offset = static_cast<size_t>(shortId - firstShortId) * ENTRY_SIZE;
+    if (offset + ENTRY_SIZE > entries.size()) return false;
+    CompactSlaveEntry::Schema::decodeFixed(entry, entries.data() + offset);
     return true;
 }
 
-// ShortIdAssignMessage 实现
-std::vector<uint8_t> ShortIdAssignMessage::serialize() const {
-    auto& result = getReusableVector();
-    result.push_back(shortId);
-    return result; // 返回副本，可复用的 vector 会在下次调用时被清空
+void CompactSyncMessage::appendEntry(const CompactSlaveEntry &entry) {
+    size_t offset = entries.size();
+    entries.resize(offset + ENTRY_SIZE);
+    CompactSlaveEntry::Schema::encodeFixed(entry, entries.data() + offset);
 }
 
-bool ShortIdAssignMessage::deserialize(const std::vector<uint8_t> &data) {
-    if (data.size() < 1) return false;
-    shortId = data[0];
-    return true;
-}
-
-
 }    // namespace Master2Slave
-}    // namespace WhtsProtocol
\ No newline at end of file
+}    // namespace WhtsProtocol
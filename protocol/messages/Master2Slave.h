@@ -2,7 +2,7 @@
 #define WHTS_PROTOCOL_MASTER2SLAVE_H
 
 #include "../Common.h"
-#include "Message.h"
+#include "MessageSchema.h"
 
 namespace WhtsProtocol {
 namespace Master2Slave {
@@ -20,48 +20,121 @@ struct SlaveConfig {
     uint8_t timeSlot;       // 分配的时隙
     uint8_t reset;          // 复位标志：0-默认值，1-执行复位
     uint8_t testCount;      // 检测数量（导通/阻值/卡钉数量）
+
+    using Schema = MessageSchema<Field<&SlaveConfig::slaveId>, Field<&SlaveConfig::timeSlot>,
+                                 Field<&SlaveConfig::reset>, Field<&SlaveConfig::testCount>>;
 };
 
-class SyncMessage : public Message {
+class SyncMessage : public SchemaMessage<SyncMessage> {
    public:
-    uint8_t mode;               // 采集模式：0-导通检测，1-阻值检测，2-卡钉检测
+    // 接收端预留的从机配置容量，重复解析时不再扩容
+    static constexpr size_t RESERVED_SLAVE_CONFIGS = 64;
+    // mode 低4位为采集模式，高4位为每周期导通数据的校验分片数（0-不发送校验分片）
+    static constexpr uint8_t MODE_MASK = 0x0F;
+    static constexpr uint8_t PARITY_SHIFT = 4;
+
+    uint8_t mode;               // 采集模式：0-导通检测，1-阻值检测，2-卡钉检测（高4位见上）
     uint8_t interval;           // 采集间隔（ms）
     uint64_t currentTime;       // 当前时间戳（微秒）
     uint64_t startTime;         // 启动时间戳（微秒）
     std::vector<SlaveConfig> slaveConfigs;  // 所有从机配置
 
-    std::vector<uint8_t> serialize() const override;
-    bool deserialize(const std::vector<uint8_t>& data) override;
+    // 从机配置个数由剩余长度推算
+    using Schema = MessageSchema<Field<&SyncMessage::mode>, Field<&SyncMessage::interval>,
+                                 Field<&SyncMessage::currentTime>, Field<&SyncMessage::startTime>,
+                                 RepeatedField<&SyncMessage::slaveConfigs, SlaveConfig::Schema>>;
+
+    uint8_t collectionMode() const { return mode & MODE_MASK; }
+    uint8_t parityCount() const { return mode >> PARITY_SHIFT; }
+
     uint8_t getMessageId() const override {
         return static_cast<uint8_t>(Master2SlaveMessageId::SYNC_MSG);
     }
     const char* getMessageTypeName() const override { return "Sync"; }
 };
+// 紧凑同步消息中的从机条目，startSlot由主机预先计算（按短ID顺序累加testCount）
+struct CompactSlaveEntry {
+    uint8_t timeSlot;       // 分配的时隙
+    uint8_t reset;          // 复位标志：0-默认值，1-执行复位
+    uint8_t testCount;      // 检测数量（导通/阻值/卡钉数量）
+    uint16_t startSlot;     // 本从机的起始时隙
+
+    using Schema = MessageSchema<Field<&CompactSlaveEntry::timeSlot>, Field<&CompactSlaveEntry::reset>,
+                                 Field<&CompactSlaveEntry::testCount>, Field<&CompactSlaveEntry::startSlot>>;
+};
+
+// 紧凑同步消息（用于从机数量较多的网络）
+// 配置以epoch标识，任何条目变化（包括复位标志）时主机递增epoch。
+// entries 是短ID从 firstShortId 开始连续的条目，只需包含自 baseEpoch 以来变化的区间，
+// 区间外的条目在 baseEpoch 到 epoch 之间保持不变。
+// 条目按原始字节保存，从机按短ID直接定位自己的条目，epoch未变化时不再读取条目
+class CompactSyncMessage : public SchemaMessage<CompactSyncMessage> {
+   public:
+    static constexpr size_t ENTRY_SIZE = 5;
+    // 接收端预留的条目容量，重复解析时不再扩容
+    static constexpr size_t RESERVED_ENTRIES = 64;
+
+    uint8_t mode;               // 同 SyncMessage::mode（低4位采集模式，高4位校验分片数）
+    uint8_t interval;           // 采集间隔（ms）
+    uint64_t currentTime;       // 当前时间戳（微秒）
+    uint64_t startTime;         // 启动时间戳（微秒）
+    uint16_t epoch;             // 当前配置版本
+    uint16_t baseEpoch;         // entries 相对的配置版本（完整配置时可等于epoch）
+    uint16_t totalSlots;        // 所有从机的testCount之和
+    uint8_t firstShortId;       // entries 中第一个条目对应的短ID
+    std::vector<uint8_t> entries;  // 连续的 CompactSlaveEntry，个数由剩余长度推算
 
+    using Schema = MessageSchema<Field<&CompactSyncMessage::mode>, Field<&CompactSyncMessage::interval>,
+                                 Field<&CompactSyncMessage::currentTime>, Field<&CompactSyncMessage::startTime>,
+                                 Field<&CompactSyncMessage::epoch>, Field<&CompactSyncMessage::baseEpoch>,
+                                 Field<&CompactSyncMessage::totalSlots>, Field<&CompactSyncMessage::firstShortId>,
+                                 BytesField<&CompactSyncMessage::entries>>;
 
+    uint8_t collectionMode() const { return mode & SyncMessage::MODE_MASK; }
+    uint8_t parityCount() const { return mode >> SyncMessage::PARITY_SHIFT; }
 
+    size_t entryCount() const { return entries.size() / ENTRY_SIZE; }
 
+    // 按短ID直接读取条目（O(1)），短ID不在本次区间内时返回false
+    bool getEntry(uint8_t shortId, CompactSlaveEntry &entry) const;
 
+    // 追加下一个短ID的条目（主机端构造消息）
+    void appendEntry(const CompactSlaveEntry &entry);
 
-class PingReqMessage : public Message {
+    uint8_t getMessageId() const override {
+        return static_cast<uint8_t>(Master2SlaveMessageId::COMPACT_SYNC_MSG);
+    }
+    const char* getMessageTypeName() const override { return "Compact Sync"; }
+};
+
+// 四时间戳Ping（NTP方式）：T1主机发送、T2从机接收、T3从机发送、T4主机接收，均在驱动边界取时间
+// 主机在下一次请求中带回上一次响应的T4，从机据此计算往返时延和与主机的时间偏差
+// 旧版主机只发送前6字节（不带回T4），解码后extended为false，从机按旧格式响应
+class PingReqMessage : public SchemaMessage<PingReqMessage> {
    public:
     uint16_t sequenceNumber;
-    uint32_t timestamp;
+    uint32_t timestamp;          // T1：主机发送时间（主机时钟，us）
+    uint16_t echoSequence;       // 上一次Ping的序号
+    uint32_t echoTimestamp;      // 上一次Ping响应的T4（主机时钟，us），0表示无
+    bool extended = true;        // 是否携带echo字段（不在线上编码）
+
+    using Schema =
+        MessageSchema<Field<&PingReqMessage::sequenceNumber>, Field<&PingReqMessage::timestamp>,
+                      OptionalFields<&PingReqMessage::extended, Field<&PingReqMessage::echoSequence>,
+                                     Field<&PingReqMessage::echoTimestamp>>>;
 
-    std::vector<uint8_t> serialize() const override;
-    bool deserialize(const std::vector<uint8_t>& data) override;
     uint8_t getMessageId() const override {
         return static_cast<uint8_t>(Master2SlaveMessageId::PING_REQ_MSG);
     }
     const char* getMessageTypeName() const override { return "Ping Request"; }
 };
 
-class ShortIdAssignMessage : public Message {
+class ShortIdAssignMessage : public SchemaMessage<ShortIdAssignMessage> {
    public:
     uint8_t shortId;
 
-    std::vector<uint8_t> serialize() const override;
-    bool deserialize(const std::vector<uint8_t>& data) override;
+    using Schema = MessageSchema<Field<&ShortIdAssignMessage::shortId>>;
+
     uint8_t getMessageId() const override {
         return static_cast<uint8_t>(Master2SlaveMessageId::SHORT_ID_ASSIGN_MSG);
     }
@@ -70,6 +143,45 @@ class ShortIdAssignMessage : public Message {
     }
 };
 
+// 分片重传请求：主机对从机最近一次发送的导通数据中丢失的分片做选择性重传
+// cycle 为该组分片帧头中的周期号（见 FRAME_CYCLE_MASK），从机只接受针对当前保留的那一组分片的请求
+class FragmentNackMessage : public SchemaMessage<FragmentNackMessage> {
+   public:
+    // 位图可表示的最大分片数，与分片重组表的上限一致
+    static constexpr uint8_t MAX_FRAGMENTS = 32;
+
+    uint8_t cycle;              // 分片帧头中的周期号
+    uint8_t fragmentCount;      // 主机看到的该周期分片总数
+    uint32_t missingBitmap;     // 丢失分片位图，bit i 对应分片序号 i
+
+    using Schema = MessageSchema<Field<&FragmentNackMessage::cycle>,
+                                 Field<&FragmentNackMessage::fragmentCount>,
+                                 Field<&FragmentNackMessage::missingBitmap>>;
+
+    uint8_t getMessageId() const override {
+        return static_cast<uint8_t>(Master2SlaveMessageId::FRAGMENT_NACK_MSG);
+    }
+    const char* getMessageTypeName() const override {
+        return "Fragment NACK";
+    }
+};
+
+// 稳定时间标定请求：从机在未采集时按当前线束标定驱动引脚到采样之间的等待时间
+// 标定期间从机驱动采集引脚且阻塞约1秒，主机应在没有从机采集、线束已连接时发送
+class SettleCalibrateMessage : public SchemaMessage<SettleCalibrateMessage> {
+   public:
+    uint8_t reserve;
+
+    using Schema = MessageSchema<Field<&SettleCalibrateMessage::reserve>>;
+
+    uint8_t getMessageId() const override {
+        return static_cast<uint8_t>(Master2SlaveMessageId::SETTLE_CALIBRATE_MSG);
+    }
+    const char* getMessageTypeName() const override {
+        return "Settle Calibrate";
+    }
+};
+
 
 }    // namespace Master2Slave
 }    // namespace WhtsProtocol
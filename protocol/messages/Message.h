@@ -2,6 +2,7 @@
 #define WHTS_PROTOCOL_MESSAGE_H
 
 #include <cstdint>
+#include <cstring>
 #include <vector>
 #include <string>
 
@@ -16,17 +17,25 @@ class Message {
     virtual uint8_t getMessageId() const = 0;
     virtual const char* getMessageTypeName() const = 0;
 
-  protected:
-    // 获取可复用的 vector，用于序列化以减少内存碎片
-    // 注意：此方法不是线程安全的，适用于单线程环境
-    static std::vector<uint8_t>& getReusableVector() {
-        static std::vector<uint8_t> reusableVector;
-        reusableVector.clear();
-        // 只在第一次或容量不足时才重新分配
-        if (reusableVector.capacity() < 256) {
-            reusableVector.reserve(256); // 预分配常用大小，减少重新分配
-        }
-        return reusableVector;
+    // 序列化后的字节数，用于在调用方缓冲区中预留空间
+    // 默认实现通过serialize()计算，大数据量的消息应重写以避免额外拷贝
+    virtual size_t getSerializedSize() const { return serialize().size(); }
+
+    // 直接序列化到调用方提供的缓冲区（零拷贝打包路径）
+    // 成功返回true并通过length返回写入字节数，缓冲区不足时返回false
+    virtual bool serializeTo(uint8_t *buffer, size_t capacity,
+                             size_t &length) const {
+        const auto data = serialize();
+        if (data.size() > capacity) return false;
+        if (!data.empty()) std::memcpy(buffer, data.data(), data.size());
+        length = data.size();
+        return true;
+    }
+
+    // 直接从调用方缓冲区反序列化（解析路径不再复制载荷）
+    // 默认实现复制到vector后调用deserialize()
+    virtual bool deserializeFrom(const uint8_t *data, size_t length) {
+        return deserialize(std::vector<uint8_t>(data, data + length));
     }
 };
 
@@ -0,0 +1,291 @@
+#ifndef WHTS_PROTOCOL_MESSAGE_SCHEMA_H
+#define WHTS_PROTOCOL_MESSAGE_SCHEMA_H
+
+#include "Message.h"
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <vector>
+
+namespace WhtsProtocol {
+
+// 编译期消息描述
+// 每个消息只声明一次字段顺序和类型，编码/解码/线上长度都由字段描述符生成：
+//   using Schema = MessageSchema<Field<&Msg::a>, Field<&Msg::b>>;
+// 所有整数字段按小端序、sizeof(T)字节编码
+
+namespace SchemaDetail {
+
+template <typename T> struct MemberTraits;
+
+template <typename C, typename V> struct MemberTraits<V C::*> {
+    using ClassType = C;
+    using ValueType = V;
+};
+
+template <typename T> inline void writeLE(uint8_t *out, T value) {
+    for (size_t i = 0; i < sizeof(T); ++i) {
+        out[i] = static_cast<uint8_t>(static_cast<uint64_t>(value) >> (8 * i));
+    }
+}
+
+template <typename T> inline T readLE(const uint8_t *in) {
+    uint64_t value = 0;
+    for (size_t i = 0; i < sizeof(T); ++i) {
+        value |= static_cast<uint64_t>(in[i]) << (8 * i);
+    }
+    return static_cast<T>(value);
+}
+
+} // namespace SchemaDetail
+
+// 固定长度整数字段
+template <auto Member> struct Field {
+    using ClassType = typename SchemaDetail::MemberTraits<decltype(Member)>::ClassType;
+    using ValueType = typename SchemaDetail::MemberTraits<decltype(Member)>::ValueType;
+    static_assert(std::is_integral<ValueType>::value,
+                  "Field only supports integer members");
+
+    static constexpr size_t FIXED_SIZE = sizeof(ValueType);
+
+    static size_t size(const ClassType &) { return FIXED_SIZE; }
+
+    static size_t encode(const ClassType &obj, uint8_t *out) {
+        SchemaDetail::writeLE(out, obj.*Member);
+        return FIXED_SIZE;
+    }
+
+    static bool decode(ClassType &obj, const uint8_t *in, size_t remaining,
+                       size_t &consumed) {
+        if (remaining < FIXED_SIZE) return false;
+        obj.*Member = SchemaDetail::readLE<ValueType>(in);
+        consumed = FIXED_SIZE;
+        return true;
+    }
+
+    static void clear(ClassType &obj) { obj.*Member = ValueType(); }
+};
+
+// 可选的尾部字段组（必须是最后一个字段），用于兼容旧版较短的消息格式
+// PresentMember为true时编码组内字段；解码时没有剩余数据则组内字段清零、PresentMember为false，
+// 剩余数据不足整组时解码失败
+template <auto PresentMember, typename... Fields> struct OptionalFields {
+    using ClassType = typename SchemaDetail::MemberTraits<decltype(PresentMember)>::ClassType;
+    static constexpr size_t FIXED_SIZE = 0;
+    static constexpr size_t GROUP_SIZE = (Fields::FIXED_SIZE + ... + 0);
+    static_assert(((Fields::FIXED_SIZE > 0) && ...),
+                  "Optional group only supports fixed size fields");
+
+    static size_t size(const ClassType &obj) {
+        return (obj.*PresentMember) ? GROUP_SIZE : 0;
+    }
+
+    static size_t encode(const ClassType &obj, uint8_t *out) {
+        if (!(obj.*PresentMember)) return 0;
+        ((out += Fields::encode(obj, out)), ...);
+        return GROUP_SIZE;
+    }
+
+    static bool decode(ClassType &obj, const uint8_t *in, size_t remaining,
+                       size_t &consumed) {
+        consumed = 0;
+        obj.*PresentMember = remaining > 0;
+        if (remaining == 0) {
+            (Fields::clear(obj), ...);
+            return true;
+        }
+        if (remaining < GROUP_SIZE) return false;
+        size_t fieldConsumed = 0;
+        ((Fields::decode(obj, in, Fields::FIXED_SIZE, fieldConsumed),
+          in += Fields::FIXED_SIZE),
+         ...);
+        consumed = GROUP_SIZE;
+        return true;
+    }
+};
+
+// 结构体数组字段，元素个数由剩余长度推算（必须是最后一个字段）
+// 剩余长度不足一个元素的尾部数据被忽略
+template <auto Member, typename ElementSchema> struct RepeatedField {
+    using ClassType = typename SchemaDetail::MemberTraits<decltype(Member)>::ClassType;
+    static constexpr size_t FIXED_SIZE = 0;
+    static constexpr size_t ELEMENT_SIZE = ElementSchema::FIXED_SIZE;
+    static_assert(ELEMENT_SIZE > 0, "Repeated element must have fixed size");
+
+    static size_t size(const ClassType &obj) {
+        return (obj.*Member).size() * ELEMENT_SIZE;
+    }
+
+    static size_t encode(const ClassType &obj, uint8_t *out) {
+        for (const auto &element : obj.*Member) {
+            ElementSchema::encodeFixed(element, out);
+            out += ELEMENT_SIZE;
+        }
+        return size(obj);
+    }
+
+    static bool decode(ClassType &obj, const uint8_t *in, size_t remaining,
+                       size_t &consumed) {
+        auto &elements = obj.*Member;
+        // resize复用已有容量，重复解析时不再逐个push_back
+        elements.resize(remaining / ELEMENT_SIZE);
+        for (auto &element : elements) {
+            ElementSchema::decodeFixed(element, in);
+            in += ELEMENT_SIZE;
+        }
+        consumed = elements.size() * ELEMENT_SIZE;
+        return true;
+    }
+};
+
+// 结构体数组字段，元素个数由之前解码的计数字段给出，数据不足时解码失败
+template <auto CountMember, auto Member, typename ElementSchema>
+struct CountedField {
+    using ClassType = typename SchemaDetail::MemberTraits<decltype(Member)>::ClassType;
+    static constexpr size_t FIXED_SIZE = 0;
+    static constexpr size_t ELEMENT_SIZE = ElementSchema::FIXED_SIZE;
+    static_assert(ELEMENT_SIZE > 0, "Counted element must have fixed size");
+
+    static size_t size(const ClassType &obj) {
+        return (obj.*Member).size() * ELEMENT_SIZE;
+    }
+
+    static size_t encode(const ClassType &obj, uint8_t *out) {
+        return RepeatedField<Member, ElementSchema>::encode(obj, out);
+    }
+
+    static bool decode(ClassType &obj, const uint8_t *in, size_t remaining,
+                       size_t &consumed) {
+        size_t count = obj.*CountMember;
+        if (count * ELEMENT_SIZE > remaining) return false;
+        auto &elements = obj.*Member;
+        elements.resize(count);
+        for (auto &element : elements) {
+            ElementSchema::decodeFixed(element, in);
+            in += ELEMENT_SIZE;
+        }
+        consumed = count * ELEMENT_SIZE;
+        return true;
+    }
+};
+
+// 原始字节字段，占用剩余全部数据（必须是最后一个字段）
+template <auto Member> struct BytesField {
+    using ClassType = typename SchemaDetail::MemberTraits<decltype(Member)>::ClassType;
+    static constexpr size_t FIXED_SIZE = 0;
+
+    static size_t size(const ClassType &obj) { return (obj.*Member).size(); }
+
+    static size_t encode(const ClassType &obj, uint8_t *out) {
+        const auto &bytes = obj.*Member;
+        if (!bytes.empty()) std::memcpy(out, bytes.data(), bytes.size());
+        return bytes.size();
+    }
+
+    static bool decode(ClassType &obj, const uint8_t *in, size_t remaining,
+                       size_t &consumed) {
+        (obj.*Member).assign(in, in + remaining);
+        consumed = remaining;
+        return true;
+    }
+};
+
+// 字段列表，按声明顺序编码
+template <typename... Fields> struct MessageSchema {
+    // 固定部分的线上长度（编译期常量），也是解码所需的最小长度
+    static constexpr size_t FIXED_SIZE = (Fields::FIXED_SIZE + ... + 0);
+
+    template <typename C> static size_t size(const C &obj) {
+        return (Fields::size(obj) + ... + 0);
+    }
+
+    template <typename C>
+    static bool encode(const C &obj, uint8_t *buffer, size_t capacity,
+                       size_t &length) {
+        size_t required = size(obj);
+        if (required > capacity) return false;
+        uint8_t *out = buffer;
+        ((out += Fields::encode(obj, out)), ...);
+        length = required;
+        return true;
+    }
+
+    template <typename C>
+    static bool decode(C &obj, const uint8_t *data, size_t length) {
+        if (length < FIXED_SIZE) return false;
+        size_t offset = 0;
+        return (decodeNext<Fields>(obj, data, length, offset) && ...);
+    }
+
+    // 仅由固定长度字段组成的结构体（数组元素）直接编解码，不做长度检查
+    template <typename C> static void encodeFixed(const C &obj, uint8_t *out) {
+        ((out += Fields::encode(obj, out)), ...);
+    }
+
+    template <typename C> static void decodeFixed(C &obj, const uint8_t *in) {
+        size_t consumed = 0;
+        ((Fields::decode(obj, in, Fields::FIXED_SIZE, consumed),
+          in += Fields::FIXED_SIZE),
+         ...);
+    }
+
+  private:
+    template <typename F, typename C>
+    static bool decodeNext(C &obj, const uint8_t *data, size_t length,
+                           size_t &offset) {
+        size_t consumed = 0;
+        if (!F::decode(obj, data + offset, length - offset, consumed)) {
+            return false;
+        }
+        offset += consumed;
+        return true;
+    }
+};
+
+// 由Schema生成序列化/反序列化的消息基类
+// Derived需要声明 using Schema = MessageSchema<...>;
+// 已知具体类型时直接调用encodeInto/decodeFrom/encodedSize，不经过虚函数，
+// 字段编解码可在调用处内联；Message接口的虚函数只用于类型擦除后的路径（发送队列等）
+template <typename Derived> class SchemaMessage : public Message {
+  public:
+    bool encodeInto(uint8_t *buffer, size_t capacity, size_t &length) const {
+        return Derived::Schema::encode(self(), buffer, capacity, length);
+    }
+
+    bool decodeFrom(const uint8_t *data, size_t length) {
+        return Derived::Schema::decode(self(), data, length);
+    }
+
+    size_t encodedSize() const { return Derived::Schema::size(self()); }
+
+    std::vector<uint8_t> serialize() const final {
+        std::vector<uint8_t> result(encodedSize());
+        size_t length = 0;
+        encodeInto(result.data(), result.size(), length);
+        return result;
+    }
+
+    bool deserialize(const std::vector<uint8_t> &data) final {
+        return decodeFrom(data.data(), data.size());
+    }
+
+    bool deserializeFrom(const uint8_t *data, size_t length) final {
+        return decodeFrom(data, length);
+    }
+
+    size_t getSerializedSize() const final { return encodedSize(); }
+
+    bool serializeTo(uint8_t *buffer, size_t capacity,
+                     size_t &length) const final {
+        return encodeInto(buffer, capacity, length);
+    }
+
+  private:
+    const Derived &self() const { return static_cast<const Derived &>(*this); }
+    Derived &self() { return static_cast<Derived &>(*this); }
+};
+
+} // namespace WhtsProtocol
+
+#endif // WHTS_PROTOCOL_MESSAGE_SCHEMA_H
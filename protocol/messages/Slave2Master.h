@@ -2,7 +2,7 @@
 #define WHTS_PROTOCOL_SLAVE2MASTER_H
 
 #include "../Common.h"
-#include "Message.h"
+#include "MessageSchema.h"
 
 namespace WhtsProtocol {
 namespace Slave2Master {
@@ -11,53 +11,61 @@ namespace Slave2Master {
 
 
 
-class RstResponseMessage : public Message {
+class RstResponseMessage : public SchemaMessage<RstResponseMessage> {
    public:
     uint8_t status;         // 0：复位成功，1：复位异常
 
-    std::vector<uint8_t> serialize() const override;
-    bool deserialize(const std::vector<uint8_t>& data) override;
+    using Schema = MessageSchema<Field<&RstResponseMessage::status>>;
+
     uint8_t getMessageId() const override {
         return static_cast<uint8_t>(Slave2MasterMessageId::RST_RSP_MSG);
     }
     const char* getMessageTypeName() const override { return "Reset Response"; }
 };
 
-class PingRspMessage : public Message {
+// 四时间戳Ping响应（见 Master2Slave::PingReqMessage），主机收到时记录T4即可计算往返时延和时间偏差
+class PingRspMessage : public SchemaMessage<PingRspMessage> {
    public:
     uint16_t sequenceNumber;
-    uint32_t timestamp;
+    uint32_t timestamp;          // T3：从机发送时间（从机时钟，us），写入发送缓冲区时填写
+    uint32_t originTimestamp;    // T1：请求中的主机发送时间
+    uint32_t receiveTimestamp;   // T2：从机接收时间（从机时钟，us）
+    bool extended = true;        // 是否携带T1/T2（不在线上编码），旧版请求按6字节旧格式响应
+
+    using Schema =
+        MessageSchema<Field<&PingRspMessage::sequenceNumber>, Field<&PingRspMessage::timestamp>,
+                      OptionalFields<&PingRspMessage::extended, Field<&PingRspMessage::originTimestamp>,
+                                     Field<&PingRspMessage::receiveTimestamp>>>;
 
-    std::vector<uint8_t> serialize() const override;
-    bool deserialize(const std::vector<uint8_t>& data) override;
     uint8_t getMessageId() const override {
         return static_cast<uint8_t>(Slave2MasterMessageId::PING_RSP_MSG);
     }
     const char* getMessageTypeName() const override { return "Ping Response"; }
 };
 
-class JoinRequestMessage : public Message {
+class JoinRequestMessage : public SchemaMessage<JoinRequestMessage> {
    public:
     uint32_t deviceId;
     uint8_t versionMajor;
     uint8_t versionMinor;
     uint16_t versionPatch;
 
-    std::vector<uint8_t> serialize() const override;
-    bool deserialize(const std::vector<uint8_t>& data) override;
+    using Schema = MessageSchema<Field<&JoinRequestMessage::deviceId>, Field<&JoinRequestMessage::versionMajor>,
+                                 Field<&JoinRequestMessage::versionMinor>, Field<&JoinRequestMessage::versionPatch>>;
+
     uint8_t getMessageId() const override {
         return static_cast<uint8_t>(Slave2MasterMessageId::JOIN_REQUEST_MSG);
     }
     const char* getMessageTypeName() const override { return "JoinRequest"; }
 };
 
-class ShortIdConfirmMessage : public Message {
+class ShortIdConfirmMessage : public SchemaMessage<ShortIdConfirmMessage> {
    public:
     uint8_t status;
     uint8_t shortId;
 
-    std::vector<uint8_t> serialize() const override;
-    bool deserialize(const std::vector<uint8_t>& data) override;
+    using Schema = MessageSchema<Field<&ShortIdConfirmMessage::status>, Field<&ShortIdConfirmMessage::shortId>>;
+
     uint8_t getMessageId() const override {
         return static_cast<uint8_t>(
             Slave2MasterMessageId::SHORT_ID_CONFIRM_MSG);
@@ -67,30 +75,93 @@ class ShortIdConfirmMessage : public Message {
     }
 };
 
-class HeartbeatMessage : public Message {
+class HeartbeatMessage : public SchemaMessage<HeartbeatMessage> {
    public:
     uint8_t batteryLevel;  // 电池电量百分比 (0-100%)
 
-    std::vector<uint8_t> serialize() const override;
-    bool deserialize(const std::vector<uint8_t>& data) override;
+    using Schema = MessageSchema<Field<&HeartbeatMessage::batteryLevel>>;
+
     uint8_t getMessageId() const override {
         return static_cast<uint8_t>(Slave2MasterMessageId::HEARTBEAT_MSG);
     }
     const char* getMessageTypeName() const override { return "Heartbeat"; }
 };
 
-class ConductionDataMessage : public Message {
+class ConductionDataMessage : public SchemaMessage<ConductionDataMessage> {
    public:
     std::vector<uint8_t> conductionData;  // 导通数据，长度从包长度推算
 
-    std::vector<uint8_t> serialize() const override;
-    bool deserialize(const std::vector<uint8_t>& data) override;
+    using Schema = MessageSchema<BytesField<&ConductionDataMessage::conductionData>>;
+
     uint8_t getMessageId() const override {
         return static_cast<uint8_t>(Slave2MasterMessageId::COND_DATA_MSG);
     }
     const char* getMessageTypeName() const override { return "Conduction Data"; }
 };
 
+// 编码后的导通数据（见 ConductionCodec），编码方式由 encoding 标志给出
+// 带 XOR_PREVIOUS 标志时以序号为 sequence - 1 的周期数据为参考，主机缺少参考周期时无法解码，
+// 从机定期发送不带异或的数据作为新的参考
+class EncodedConductionDataMessage : public SchemaMessage<EncodedConductionDataMessage> {
+   public:
+    uint8_t encoding;             // ConductionCodec 编码标志
+    uint8_t sequence;             // 周期序号
+    uint16_t rawLength;           // 原始按位打包数据长度
+    std::vector<uint8_t> data;    // 编码后的数据
+
+    using Schema = MessageSchema<Field<&EncodedConductionDataMessage::encoding>,
+                                 Field<&EncodedConductionDataMessage::sequence>,
+                                 Field<&EncodedConductionDataMessage::rawLength>,
+                                 BytesField<&EncodedConductionDataMessage::data>>;
+
+    uint8_t getMessageId() const override {
+        return static_cast<uint8_t>(Slave2MasterMessageId::COND_DATA_ENC_MSG);
+    }
+    const char* getMessageTypeName() const override { return "Encoded Conduction Data"; }
+};
+
+// 导通数据校验分片（见 FragmentParity），与数据分片使用相同的 slaveId + DeviceStatus 前缀
+// 数据块长度即 parity 的长度，数据块个数由 dataLength 推算
+class ConductionParityMessage : public SchemaMessage<ConductionParityMessage> {
+   public:
+    uint8_t parityIndex;          // 校验组序号
+    uint8_t parityCount;          // 校验组数（数据块 i 属于第 i % parityCount 组）
+    uint16_t dataLength;          // 导通数据总长度
+    std::vector<uint8_t> parity;  // 该组数据块的XOR
+
+    using Schema = MessageSchema<Field<&ConductionParityMessage::parityIndex>,
+                                 Field<&ConductionParityMessage::parityCount>,
+                                 Field<&ConductionParityMessage::dataLength>,
+                                 BytesField<&ConductionParityMessage::parity>>;
+
+    uint8_t getMessageId() const override {
+        return static_cast<uint8_t>(Slave2MasterMessageId::COND_PARITY_MSG);
+    }
+    const char* getMessageTypeName() const override { return "Conduction Parity"; }
+};
+
+// 从机按实测链路耗时得到的分片计划（见 LinkPlanner），计划变化时上报
+// 主机可按 slotPayload 估算发完一个周期的导通数据所需的激活时隙数
+class LinkPlanMessage : public SchemaMessage<LinkPlanMessage> {
+   public:
+    uint16_t frameSize;      // 分片帧长（MTU）
+    uint8_t framesPerSlot;   // 每个激活时隙的分片数
+    uint16_t slotPayload;    // 每个激活时隙的导通数据字节数
+    uint16_t perFrameUs;     // 实测每帧固定开销（us）
+    uint16_t perByteNs;      // 实测每字节开销（ns）
+
+    using Schema = MessageSchema<Field<&LinkPlanMessage::frameSize>,
+                                 Field<&LinkPlanMessage::framesPerSlot>,
+                                 Field<&LinkPlanMessage::slotPayload>,
+                                 Field<&LinkPlanMessage::perFrameUs>,
+                                 Field<&LinkPlanMessage::perByteNs>>;
+
+    uint8_t getMessageId() const override {
+        return static_cast<uint8_t>(Slave2MasterMessageId::LINK_PLAN_MSG);
+    }
+    const char* getMessageTypeName() const override { return "Link Plan"; }
+};
+
 
 }    // namespace Slave2Master
 }    // namespace WhtsProtocol
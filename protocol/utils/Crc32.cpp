@@ -0,0 +1,67 @@
+#include "Crc32.h"
+
+namespace WhtsProtocol {
+
+namespace {
+
+constexpr uint32_t CRC32_POLYNOMIAL = 0xEDB88320;
+
+struct Crc32Tables {
+    uint32_t table[4][256];
+};
+
+// 编译期生成slice-by-4查找表，存放在只读区
+constexpr Crc32Tables makeCrc32Tables() {
+    Crc32Tables tables{};
+    for (uint32_t i = 0; i < 256; ++i) {
+        uint32_t crc = i;
+        for (int bit = 0; bit < 8; ++bit) {
+            crc = (crc & 1) ? (crc >> 1) ^ CRC32_POLYNOMIAL : crc >> 1;
+        }
+        tables.table[0][i] = crc;
+    }
+    for (uint32_t i = 0; i < 256; ++i) {
+        for (int slice = 1; slice < 4; ++slice) {
+            uint32_t previous = tables.table[slice - 1][i];
+            tables.table[slice][i] =
+                (previous >> 8) ^ tables.table[0][previous & 0xFF];
+        }
+    }
+    return tables;
+}
+
+constexpr Crc32Tables CRC32_TABLES = makeCrc32Tables();
+
+} // namespace
+
+uint32_t Crc32::update(uint32_t crc, const uint8_t *data, size_t length) {
+    const auto &t = CRC32_TABLES.table;
+
+    while (length >= 4) {
+        // 按小端序组合，与字节顺序处理等价，不依赖地址对齐
+        crc ^= static_cast<uint32_t>(data[0]) |
+               (static_cast<uint32_t>(data[1]) << 8) |
+               (static_cast<uint32_t>(data[2]) << 16) |
+               (static_cast<uint32_t>(data[3]) << 24);
+        crc = t[3][crc & 0xFF] ^ t[2][(crc >> 8) & 0xFF] ^
+              t[1][(crc >> 16) & 0xFF] ^ t[0][crc >> 24];
+        data += 4;
+        length -= 4;
+    }
+
+    while (length--) {
+        crc = t[0][(crc ^ *data++) & 0xFF] ^ (crc >> 8);
+    }
+    return crc;
+}
+
+uint32_t Crc32::computeBytewise(const uint8_t *data, size_t length) {
+    const auto &t = CRC32_TABLES.table;
+    uint32_t crc = INITIAL;
+    while (length--) {
+        crc = t[0][(crc ^ *data++) & 0xFF] ^ (crc >> 8);
+    }
+    return finalize(crc);
+}
+
+} // namespace WhtsProtocol
@@ -0,0 +1,29 @@
+#ifndef WHTS_PROTOCOL_CRC32_H
+#define WHTS_PROTOCOL_CRC32_H
+
+#include <cstddef>
+#include <cstdint>
+
+namespace WhtsProtocol {
+
+// CRC-32 (IEEE 802.3, 反射多项式0xEDB88320) 计算工具类
+class Crc32 {
+  public:
+    static constexpr uint32_t INITIAL = 0xFFFFFFFF;
+
+    // slice-by-4查表计算，每次处理4字节
+    static uint32_t compute(const uint8_t *data, size_t length) {
+        return finalize(update(INITIAL, data, length));
+    }
+
+    // 增量计算：从INITIAL开始按顺序对各段数据调用update，最后finalize得到CRC
+    static uint32_t update(uint32_t crc, const uint8_t *data, size_t length);
+    static uint32_t finalize(uint32_t crc) { return ~crc; }
+
+    // 逐字节查表计算，结果与compute相同，用于校验和对比
+    static uint32_t computeBytewise(const uint8_t *data, size_t length);
+};
+
+} // namespace WhtsProtocol
+
+#endif // WHTS_PROTOCOL_CRC32_H
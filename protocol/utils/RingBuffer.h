@@ -0,0 +1,110 @@
+#ifndef WHTS_PROTOCOL_RING_BUFFER_H
+#define WHTS_PROTOCOL_RING_BUFFER_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+namespace WhtsProtocol {
+
+// 固定容量的字节环形缓冲区，用于接收路径
+// 数据在缓冲区内回绕存储，消费数据只移动读指针，不做memmove
+// 注意：此类不是线程安全的，由调用方保证单任务访问
+template <size_t Capacity> class ByteRingBuffer {
+    static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0,
+                  "Capacity must be a power of two");
+
+  public:
+    static constexpr size_t NPOS = SIZE_MAX;
+
+    ByteRingBuffer() : head_(0), size_(0) {}
+
+    size_t size() const { return size_; }
+    size_t freeSpace() const { return Capacity - size_; }
+    bool empty() const { return size_ == 0; }
+    static constexpr size_t capacity() { return Capacity; }
+
+    void clear() {
+        head_ = 0;
+        size_ = 0;
+    }
+
+    // 写入数据，返回实际写入的字节数（受剩余空间限制）
+    size_t push(const uint8_t *data, size_t length) {
+        length = std::min(length, freeSpace());
+        size_t tail = (head_ + size_) & MASK;
+        size_t firstPart = std::min(length, Capacity - tail);
+        std::memcpy(buffer_ + tail, data, firstPart);
+        std::memcpy(buffer_, data + firstPart, length - firstPart);
+        size_ += length;
+        return length;
+    }
+
+    // 读取相对读指针offset处的字节（调用方保证offset < size()）
+    uint8_t peek(size_t offset) const { return buffer_[(head_ + offset) & MASK]; }
+
+    // 读取相对读指针offset处的小端序uint16
+    uint16_t peekUint16LE(size_t offset) const {
+        return peek(offset) | (peek(offset + 1) << 8);
+    }
+
+    // 从offset处拷贝length字节到dest，处理回绕
+    void copyOut(size_t offset, uint8_t *dest, size_t length) const {
+        size_t start = (head_ + offset) & MASK;
+        size_t firstPart = std::min(length, Capacity - start);
+        std::memcpy(dest, buffer_ + start, firstPart);
+        std::memcpy(dest + firstPart, buffer_, length - firstPart);
+    }
+
+    // 丢弃读指针处的length字节
+    void consume(size_t length) {
+        length = std::min(length, size_);
+        head_ = (head_ + length) & MASK;
+        size_ -= length;
+        if (size_ == 0) {
+            head_ = 0; // 缓冲区为空时复位，让后续数据尽量连续存放
+        }
+    }
+
+    // 从offset开始查找两字节序列first+second，返回其偏移，未找到返回NPOS
+    // 在每个连续段内用memchr定位first候选，再检查下一字节（可跨越回绕边界）
+    size_t find(uint8_t first, uint8_t second, size_t offset) const {
+        while (offset + 1 < size_) {
+            size_t start = (head_ + offset) & MASK;
+            // 候选位置必须留出第二个字节，且不超过当前连续段
+            size_t span = std::min(size_ - 1 - offset, Capacity - start);
+            const void *hit = std::memchr(buffer_ + start, first, span);
+            if (hit == nullptr) {
+                offset += span;
+                continue;
+            }
+            size_t pos =
+                offset + (static_cast<const uint8_t *>(hit) - (buffer_ + start));
+            // 连续出现first时逐字节推进，避免每个字节调用一次memchr
+            while (true) {
+                uint8_t next = peek(pos + 1);
+                if (next == second) {
+                    return pos;
+                }
+                if (next != first || pos + 2 >= size_) {
+                    break;
+                }
+                ++pos;
+            }
+            offset = pos + 1;
+        }
+        return NPOS;
+    }
+
+  private:
+    static constexpr size_t MASK = Capacity - 1;
+
+    uint8_t buffer_[Capacity];
+    size_t head_; // 读指针
+    size_t size_; // 已存储字节数
+};
+
+} // namespace WhtsProtocol
+
+#endif // WHTS_PROTOCOL_RING_BUFFER_H
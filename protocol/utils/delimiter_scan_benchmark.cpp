@@ -0,0 +1,148 @@
+/**
+ * @file delimiter_scan_benchmark.cpp
+ * @brief 接收缓冲区帧分隔符查找的吞吐量评估
+ *
+ * 对比 ByteRingBuffer::find（memchr定位候选）与原来逐字节peek的查找，
+ * 输入包括随机数据、不含0xAB的噪声，以及大量0xAB但后面不跟0xCD的对抗数据，
+ * 每种输入都在缓冲区回绕的情况下各测一次，并检查两种查找结果一致
+ *
+ * 主机编译运行：
+ *   g++ -std=c++17 -O2 -DDELIMITER_SCAN_BENCHMARK_MAIN \
+ *       delimiter_scan_benchmark.cpp -o delimiter_scan_benchmark
+ *   ./delimiter_scan_benchmark
+ */
+
+#ifdef DELIMITER_SCAN_BENCHMARK_MAIN
+
+#include "RingBuffer.h"
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+using namespace WhtsProtocol;
+
+namespace {
+
+constexpr size_t BUFFER_CAPACITY = 4096;
+constexpr uint8_t DELIMITER_1 = 0xAB;
+constexpr uint8_t DELIMITER_2 = 0xCD;
+
+using Buffer = ByteRingBuffer<BUFFER_CAPACITY>;
+
+// 原来的查找方式：逐字节peek比较
+size_t bytewiseFind(const Buffer &buffer, uint8_t first, uint8_t second,
+                    size_t offset) {
+    for (size_t i = offset; i + 1 < buffer.size(); ++i) {
+        if (buffer.peek(i) == first && buffer.peek(i + 1) == second) {
+            return i;
+        }
+    }
+    return Buffer::NPOS;
+}
+
+struct ScanInput {
+    const char *name;
+    std::vector<uint8_t> data;
+};
+
+std::vector<uint8_t> makeRandom(size_t length, std::mt19937 &rng) {
+    std::vector<uint8_t> data(length);
+    std::uniform_int_distribution<int> byte(0, 255);
+    for (auto &value : data) {
+        value = static_cast<uint8_t>(byte(rng));
+    }
+    // 去掉随机出现的完整分隔符，测量完整扫描一遍的耗时
+    for (size_t i = 0; i + 1 < data.size(); ++i) {
+        if (data[i] == DELIMITER_1 && data[i + 1] == DELIMITER_2) {
+            data[i + 1] = 0x00;
+        }
+    }
+    return data;
+}
+
+std::vector<uint8_t> makeNoDelimiter(size_t length, std::mt19937 &rng) {
+    std::vector<uint8_t> data = makeRandom(length, rng);
+    for (auto &value : data) {
+        if (value == DELIMITER_1) {
+            value = 0x00;
+        }
+    }
+    return data;
+}
+
+std::vector<uint8_t> makeAdversarial(size_t length, size_t runLength) {
+    // runLength个0xAB后跟一个非0xCD字节，反复出现
+    std::vector<uint8_t> data(length, DELIMITER_1);
+    for (size_t i = runLength; i < length; i += runLength + 1) {
+        data[i] = 0x55;
+    }
+    return data;
+}
+
+void fill(Buffer &buffer, const std::vector<uint8_t> &data, size_t wrapAt) {
+    // 先占用wrapAt字节再消费，使有效数据从缓冲区中间开始并在末尾回绕
+    static const std::vector<uint8_t> padding(BUFFER_CAPACITY, 0);
+    buffer.clear();
+    buffer.push(padding.data(), wrapAt);
+    size_t written = buffer.push(data.data(), data.size());
+    buffer.consume(wrapAt);
+    buffer.push(data.data() + written, data.size() - written);
+}
+
+template <typename Finder>
+double measure(const Buffer &buffer, Finder finder, size_t &result) {
+    constexpr int ITERATIONS = 20000;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < ITERATIONS; ++i) {
+        result = finder(buffer);
+        // 防止编译器把循环外提
+        asm volatile("" : : "r"(result) : "memory");
+    }
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    double seconds = std::chrono::duration<double>(elapsed).count();
+    return static_cast<double>(buffer.size()) * ITERATIONS / seconds / 1e6;
+}
+
+void runInput(const ScanInput &input, size_t wrapAt) {
+    static Buffer buffer;
+    fill(buffer, input.data, wrapAt);
+
+    size_t memchrPos = 0;
+    size_t bytewisePos = 0;
+    double memchrRate = measure(
+        buffer,
+        [](const Buffer &b) { return b.find(DELIMITER_1, DELIMITER_2, 0); },
+        memchrPos);
+    double bytewiseRate = measure(
+        buffer,
+        [](const Buffer &b) {
+            return bytewiseFind(b, DELIMITER_1, DELIMITER_2, 0);
+        },
+        bytewisePos);
+
+    std::printf("%-14s %-7s len=%5zu memchr=%8.1fMB/s bytewise=%8.1fMB/s "
+                "(%5.1fx) %s\n",
+                input.name, wrapAt ? "wrapped" : "linear", buffer.size(),
+                memchrRate, bytewiseRate, memchrRate / bytewiseRate,
+                memchrPos == bytewisePos ? "ok" : "MISMATCH");
+}
+
+} // namespace
+
+int main() {
+    constexpr size_t LENGTH = 3000;
+    std::mt19937 rng(12345);
+    const ScanInput inputs[] = {
+        {"random", makeRandom(LENGTH, rng)},
+        {"no-delimiter", makeNoDelimiter(LENGTH, rng)},
+        {"ab-run-16", makeAdversarial(LENGTH, 16)},
+        {"ab-run-all", makeAdversarial(LENGTH, LENGTH)},
+    };
+    for (const auto &input : inputs) {
+        runInput(input, 0);
+        runInput(input, BUFFER_CAPACITY - 1000);
+    }
+    return 0;
+}
+#endif // DELIMITER_SCAN_BENCHMARK_MAIN